@@ -230,6 +230,11 @@ Ai::~Ai() {
 
 void Ai::update() {
 	_PROFILE_FUNCTION();
+	// the bounded beingAttacked() check uses the unit index, so keep the known and visible enemy
+	// lists (used by blindAttack()) fresh on a slower schedule of their own
+	if (aiInterface->getTimer() % (enemyEvaluationInterval * WORLD_FPS / 1000) == 0) {
+		evaluateEnemies();
+	}
 	foreach (AiRules, it, aiRules) { // process ai rules
 		if ((aiInterface->getTimer() % ((*it)->getTestInterval() * WORLD_FPS / 1000)) == 0) {
 			if ((*it)->test()) {
@@ -326,6 +331,20 @@ const ResourceType *Ai::getNeededResource() {
 }
 
 bool Ai::beingAttacked(float radius, Vec2i &out_pos, Field &out_field) {
+	if (radius != numeric_limits<float>::infinity()) {
+		// bounded search, ask the unit index rather than evaluating every enemy unit
+		Vec2i basePos = aiInterface->getHomeLocation();
+		ConstUnitPtr enemy = aiInterface->findNearestEnemy(basePos, radius);
+		if (enemy) {
+			baseSeen = true;
+			out_pos = enemy->getCenteredPos();
+			out_field = enemy->getCurrField();
+			AI_LOG( MILITARY, 2, "Ai::beingAttacked: enemy found at pos " << out_pos );
+			return true;
+		}
+		AI_LOG( MILITARY, 2, "Ai::beingAttacked: no enemies found in range." );
+		return false;
+	}
 	evaluateEnemies();
 	if (m_closestEnemy) {
 		Vec2i basePos = aiInterface->getHomeLocation();
@@ -119,6 +119,7 @@ private:
 	static const int minConsumableResources= 20;
 	static const int maxExpansions= 2;
 	static const int villageRadius= 15;
+	static const int enemyEvaluationInterval= 10000; // ms, refresh of known & visible enemies
 
 public:
 	enum ResourceUsage{
@@ -141,6 +141,28 @@ void GlestAiInterface::findEnemies(ConstUnitVector &out_list, ConstUnitPtr &out_
 	}
 }
 
+/** Find the nearest visible enemy (excluding glestimals) within radius of pos, using the map's
+  * UnitIndex rather than walking every faction's units. @return the enemy, or NULL if none found */
+ConstUnitPtr GlestAiInterface::findNearestEnemy(const Vec2i &pos, float radius) {
+	UnitIndex::Results candidates;
+	world->getMap()->getUnitIndex().findEnemies(faction->getTeam(), pos, int(ceilf(radius)), candidates);
+
+	ConstUnitPtr closest = 0;
+	float closestDist = radius;
+	foreach_const (UnitIndex::Results, it, candidates) {
+		const Unit *enemy = it->unit;
+		if (enemy->getFaction() == world->getGlestimals() || !enemy->isAlive() || !faction->canSee(enemy)) {
+			continue;
+		}
+		float dist = pos.dist(enemy->getCenteredPos());
+		if (dist < closestDist) {
+			closest = enemy;
+			closestDist = dist;
+		}
+	}
+	return closest;
+}
+
 const StoredResource *GlestAiInterface::getResource(const ResourceType *rt){
 	return faction->getResource(rt);
 }
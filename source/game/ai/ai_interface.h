@@ -78,6 +78,7 @@ public:
 	const StoredResource *getResource(const ResourceType *rt);
 	const Unit *getMyUnit(int unitIndex);
 	void findEnemies(ConstUnitVector &out_list, ConstUnitPtr &out_closest);
+	ConstUnitPtr findNearestEnemy(const Vec2i &pos, float radius);
 	const FactionType *getMyFactionType();
 	Faction* getFaction() { return faction; }
 	Faction* getMyFaction() { return faction; }
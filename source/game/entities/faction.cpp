@@ -131,6 +131,7 @@ void Faction::init(const FactionType *factionType, ControlType control, string p
 
 	if (factionIndex != -1) { // !Glestimals
 		resources.resize(techTree->getResourceTypeCount());
+		m_consumableBalances.resize(techTree->getResourceTypeCount(), 0);
 		for (int i = 0; i < techTree->getResourceTypeCount(); ++i) {
 			const ResourceType *rt = techTree->getResourceType(i);
 			int resourceAmount= giveResources? factionType->getStartingResourceAmount(rt): 0;
@@ -246,6 +247,7 @@ void Faction::load(const XmlNode *node, World *world, const FactionType *ft, Con
 
 	n = node->getChild("resources");
 	resources.resize(n->getChildCount());
+	m_consumableBalances.resize(n->getChildCount(), 0);
 	for (int i = 0; i < n->getChildCount(); ++i) {
 		XmlNode *resourceNode = n->getChild("resource", i);
 		const ResourceType *rt = tt->getResourceType(resourceNode->getChildStringValue("type"));
@@ -259,6 +261,16 @@ void Faction::load(const XmlNode *node, World *world, const FactionType *ft, Con
 	for (int i = 0; i < n->getChildCount(); ++i) {
 		g_world.newUnit(n->getChild("unit", i), this, map, tt);
 	}
+	// loaded units are never 'born', rebuild the operative counts & consumable balances here
+	for (int i=0; i < factionType->getUnitTypeCount(); ++i) {
+		m_unitCountMap[factionType->getUnitType(i)] = 0;
+	}
+	foreach_const (Units, it, units) {
+		if ((*it)->isOperative()) {
+			++m_unitCountMap[(*it)->getType()];
+		}
+	}
+	recomputeConsumableBalances();
 	subfaction = node->getChildIntValue("subfaction"); // reset in case unit construction changed it
 	colourIndex = node->getChildIntValue("colourIndex");
 
@@ -324,6 +336,7 @@ void Faction::finishUpgrade(const UpgradeType *ut) {
 			m_storeModifiers[unitType][resType].m_multiplier += (mod.getMultiplier() - 1);
 		}
 	}
+	recomputeConsumableBalances();
 
 	// update store caps
 	reEvaluateStore();
@@ -791,18 +804,43 @@ void Faction::incResourceAmount(const ResourceType *rt, int amount) {
 	assert(false);
 }
 
-void Faction::setResourceBalance(const ResourceType *rt, int balance) {
+/** Copy the consumable resource balances to the stored resources, for display & the AI */
+void Faction::publishResourceBalances() {
 	if (!ScriptManager::getPlayerModifiers(m_id)->getConsumeEnabled()) {
 		return;
 	}
 	for (int i = 0; i < resources.size(); ++i) {
-		StoredResource *r = &resources[i];
-		if (r->getType() == rt) {
-			r->setBalance(balance);
-			return;
+		if (resources[i].getType()->getClass() == ResourceClass::CONSUMABLE) {
+			resources[i].setBalance(m_consumableBalances[i]);
+		}
+	}
+}
+
+/** Adjust the consumable balances for a change in the number of operative units of a type
+  * @param count the number of units of type ut activated (or deactivated if negative) */
+void Faction::updateConsumableBalances(const UnitType *ut, int count) {
+	for (int i = 0; i < ut->getCostCount(); ++i) {
+		ResourceAmount cost = ut->getCost(i, this);
+		if (cost.getType()->getClass() != ResourceClass::CONSUMABLE) {
+			continue;
+		}
+		for (int j = 0; j < resources.size(); ++j) {
+			if (resources[j].getType() == cost.getType()) {
+				m_consumableBalances[j] -= cost.getAmount() * count;
+				break;
+			}
+		}
+	}
+}
+
+/** Recompute the consumable balances from the operative unit counts, after cost modifiers change */
+void Faction::recomputeConsumableBalances() {
+	std::fill(m_consumableBalances.begin(), m_consumableBalances.end(), 0);
+	foreach (UnitTypeCountMap, it, m_unitCountMap) {
+		if (it->second) {
+			updateConsumableBalances(it->first, it->second);
 		}
 	}
-	assert(false);
 }
 
 void Faction::add(Unit *unit) {
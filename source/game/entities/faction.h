@@ -94,6 +94,7 @@ private:
 	UnitMap unitMap;
 	Products products;
 	UnitTypeCountMap  m_unitCountMap;  // count of each 'operative' UnitType in factionType.
+	vector<int>       m_consumableBalances; // balance of each consumable resource, by resource index
 
 	ControlType control;
 
@@ -219,13 +220,21 @@ public:
 	void add(Unit *unit);
 	void remove(Unit *unit);
 
-	void onUnitActivated(const UnitType *ut) { ++m_unitCountMap[ut]; }
+	void onUnitActivated(const UnitType *ut) {
+		++m_unitCountMap[ut];
+		updateConsumableBalances(ut, 1);
+	}
 	void onUnitMorphed(const UnitType *new_ut, const UnitType *old_ut) {
 		assert(m_unitCountMap[old_ut] > 0);
 		--m_unitCountMap[old_ut];
 		++m_unitCountMap[new_ut];
+		updateConsumableBalances(old_ut, -1);
+		updateConsumableBalances(new_ut, 1);
+	}
+	void onUnitDeActivated(const UnitType *ut) {
+		--m_unitCountMap[ut];
+		updateConsumableBalances(ut, -1);
 	}
-	void onUnitDeActivated(const UnitType *ut) { --m_unitCountMap[ut]; }
 
 	void addStore(const ResourceType *rt, int amount);
 	void addStore(const UnitType *unitType);
@@ -240,7 +249,7 @@ public:
 
 	// resources
 	void incResourceAmount(const ResourceType *rt, int amount);
-	void setResourceBalance(const ResourceType *rt, int balance);
+	void publishResourceBalances();
 	void capResource(const ResourceType *rt);
 
 	// Generated 'products' (non unit producibles)
@@ -249,6 +258,8 @@ public:
 private:
 	void limitResourcesToStore();
 	void resetResourceAmount(const ResourceType *rt);
+	void updateConsumableBalances(const UnitType *ut, int count);
+	void recomputeConsumableBalances();
 };
 
 }}//end namespace
@@ -113,13 +113,13 @@ void FireParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->texture = getNumTextures() > 1 ? random.randRange(0, getNumTextures() - 1) : 0;
 }
 
-void FireParticleSystem::updateParticle(Particle *p) {
-	p->lastPos = p->pos;
-	p->pos = p->pos+p->speed;
-	p->energy.current--;
-	p->colour.value += p->colour.step;
-	p->speed.x *= 1.001f; // wind
-	p->angle.value = fmodf(p->angle.value + p->angle.step, Math::twopi);
+void FireParticleSystem::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.move(n);
+	particles.age(n);
+	particles.stepColour(n);
+	particles.scaleSpeed(n, Vec3f(1.001f, 1.f, 1.f)); // wind
+	particles.stepAngle(n);
 }
 
 
@@ -173,13 +173,13 @@ void SmokeParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->texture = getNumTextures() > 1 ? random.randRange(0, getNumTextures() - 1) : 0;
 }
 
-void SmokeParticleSystem::updateParticle(Particle *p) {
-	p->lastPos = p->pos;
-	p->pos = p->pos + p->speed;
-	p->energy.current--;
-	p->colour.value += p->colour.step;
-	p->speed.x *= 1.01f; // wind
-	p->angle.value = fmodf(p->angle.value + p->angle.step, Math::twopi);
+void SmokeParticleSystem::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.move(n);
+	particles.age(n);
+	particles.stepColour(n);
+	particles.scaleSpeed(n, Vec3f(1.01f, 1.f, 1.f)); // wind
+	particles.stepAngle(n);
 }
 
 // ===========================================================================
@@ -368,12 +368,7 @@ void Projectile::initParticle(Particle *p, int particleIndex) {
 	p->speed = Vec3f(random.randRange(-0.1f, 0.1f), random.randRange(-0.1f, 0.1f), random.randRange(-0.1f, 0.1f)) * speed;
 	p->accel = Vec3f(0.0f, -gravity, 0.0f);
 
-	updateParticle(p);
-}
-
-void Projectile::updateParticle(Particle *p) {
-	float energyRatio = p->getEnergyRatio();//clamp(float(p->energy) / energy, 0.f, 1.f);
-
+	// advance the new particle one step, as updateParticles() would
 	p->lastPos += p->speed;
 	p->pos += p->speed;
 	p->speed += p->accel;
@@ -386,6 +381,19 @@ void Projectile::updateParticle(Particle *p) {
 	p->energy.current--;
 }
 
+void Projectile::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.moveTrail(n);
+	particles.accelerate(n);
+	particles.stepColour(n);
+	particles.stepColour2(n);
+	particles.stepSize(n);
+	if (hasAngularVelocity()) {
+		particles.stepAngle(n);
+	}
+	particles.age(n);
+}
+
 void Projectile::setPath(Vec3f startPos, Vec3f endPos, int frames) {
 	// compute axis
 	zVector = endPos - startPos;
@@ -481,17 +489,15 @@ void Splash::initParticle(Particle *p, int particleIndex) {
 	p->texture = getNumTextures() > 1 ? random.randRange(0, getNumTextures() - 1) : 0;
 }
 
-void Splash::updateParticle(Particle *p) {
-	float energyRatio = p->getEnergyRatio();//clamp(static_cast<float>(p->energy) / energy, 0.f, 1.f);
-
-	p->lastPos = p->pos;
-	p->pos = p->pos + p->speed;
-	p->speed = p->speed + p->accel;
-	p->energy.current--;
-	p->colour.value += p->colour.step;
-	p->size.value += p->size.step;
+void Splash::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.move(n);
+	particles.accelerate(n);
+	particles.age(n);
+	particles.stepColour(n);
+	particles.stepSize(n);
 	if (hasAngularVelocity()) {
-		p->angle.value = fmodf(p->angle.value + p->angle.step, Math::twopi);
+		particles.stepAngle(n);
 	}
 }
 
@@ -616,10 +622,6 @@ void UnitParticleSystem::initParticle(Particle *p, int particleIndex) {
 }
 
 void UnitParticleSystem::update() {
-	if (fixed) {
-		fixedAddition = Vec3f(pos.x - oldPos.x, pos.y - oldPos.y, pos.z - oldPos.z);
-		oldPos = pos;
-	}
 	ParticleSystem::update();
 	checkVisibilty(ParticleUse::UNIT);
 	
@@ -631,23 +633,23 @@ void UnitParticleSystem::update() {
 	}
 }
 
-void UnitParticleSystem::updateParticle(Particle *p) {
-	float energyRatio = p->getEnergyRatio();// clamp(float(p->energy) / maxParticleEnergy, 0.f, 1.f);
-
-	p->lastPos += p->speed;
-	p->pos += p->speed;
+void UnitParticleSystem::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.moveTrail(n);
 	if (fixed) {
-		p->lastPos += fixedAddition;
-		p->pos += fixedAddition;
+		// follow the emitter, pos is not changed while systems are being stepped
+		fixedAddition = Vec3f(pos.x - oldPos.x, pos.y - oldPos.y, pos.z - oldPos.z);
+		oldPos = pos;
+		particles.translate(n, fixedAddition);
 	}
-	p->speed += p->accel;
-	p->colour.value += p->colour.step;
-	p->colour2.value += p->colour2.step;
-	p->size.value += p->size.step;
+	particles.accelerate(n);
+	particles.stepColour(n);
+	particles.stepColour2(n);
+	particles.stepSize(n);
 	if (hasAngularVelocity()) {
-		p->angle.value = fmodf(p->angle.value + p->angle.step, Math::twopi);
+		particles.stepAngle(n);
 	}
-	--p->energy.current;
+	particles.age(n);
 }
 
 // ================= SET PARAMS ====================
@@ -67,7 +67,7 @@ public:
 
 	virtual bool isFinished() const override {
 		if (state == sFade) {
-			return !particles || !aliveParticleCount;
+			return !particles.getCapacity() || !aliveParticleCount;
 		}
 		return false;
 	}
@@ -86,7 +86,7 @@ public:
 	//virtual
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles() override;
 };
 
 class SmokeParticleSystem : public GameParticleSystem {
@@ -96,7 +96,7 @@ public:
 	//virtual
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles() override;
 };
 
 // ===========================================================================
@@ -214,7 +214,7 @@ public:
 
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles() override;
 
 	void setTrajectory(TrajectoryType trajectory)			{this->trajectory= trajectory;}
 	void setTrajectorySpeed(float trajectorySpeed)			{this->trajectorySpeed= trajectorySpeed;}
@@ -249,7 +249,7 @@ public:
 
 	virtual void update() override;
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles() override;
 
 	void setEmissionRateFade(float emissionRateFade)	{this->emissionRateFade = emissionRateFade;}
 	void setVerticalSpreadA(float verticalSpreadA)		{this->verticalSpreadA = verticalSpreadA;}
@@ -290,7 +290,7 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex) override;
-	virtual void updateParticle(Particle *p) override;
+	virtual void updateParticles() override;
 	virtual void update() override;
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr) override;
 
@@ -970,6 +970,7 @@ Command *Unit::popCommand() {
 	g_world.deleteCommand(commands.front());
 	commands.erase(commands.begin());
 	clearPath();
+	g_routePlanner.abandonRequest(this);
 
 	Command *command = commands.empty() ? NULL : commands.front();
 
@@ -1316,6 +1317,11 @@ TravelState Unit::travel(const Vec2i &pos, const MoveSkillType *moveSkill) {
 			}
 			return TravelState::BLOCKED;
 
+		case TravelState::PENDING:
+			// waiting on the route planner, path (if any) is still good
+			setCurrSkill(SkillClass::STOP);
+			return TravelState::PENDING;
+
 		case TravelState::IMPOSSIBLE:
 			setCurrSkill(SkillClass::STOP);
 			cancelCurrCommand(); // from AttackCommandType, is this right, maybe dependant flag?? - hailstone 21Dec2010
@@ -2163,8 +2169,11 @@ void Unit::recalculateStats() {
 		hp = getMaxHp();
 	}
 
-	if (oldSight != getSight() && type->getDetectorType()) {
-		g_cartographer.detectorSightModified(this, oldSight);
+	if (oldSight != getSight()) {
+		g_cartographer.updateUnitVisibility(this);
+		if (type->getDetectorType()) {
+			g_cartographer.detectorSightModified(this, oldSight);
+		}
 	}
 	
 	// If this guy is dead, make sure they stay dead
@@ -2409,6 +2418,8 @@ bool Unit::transform(const TransformCommandType *tct, const UnitType *ut, Vec2i
 		commands.clear();
 		giveCommand(g_world.newCommand(type->getFirstCtOfClass(CmdClass::BUILD_SELF), CmdFlags()));
 		setCurrSkill(SkillClass::BUILD_SELF);
+		// not operative until built, born() will activate it again
+		faction->onUnitDeActivated(type);
 		return true;
 	}
 	return false;
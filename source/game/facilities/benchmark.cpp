@@ -0,0 +1,73 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "benchmark.h"
+
+#include "world.h"
+#include "debug_stats.h"
+#include "checksum.h"
+#include "platform_util.h"
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Main {
+
+using namespace Shared::Util;
+using namespace Shared::Debug;
+using namespace Glest::Debug;
+using Glest::Sim::World;
+
+// =====================================================
+//	class Benchmark
+// =====================================================
+
+Benchmark::Benchmark(int frameLimit)
+		: m_frameLimit(frameLimit)
+		, m_startFrame(0) {
+}
+
+void Benchmark::start() {
+	m_startFrame = g_world.getFrameCount();
+	m_chrono.start();
+}
+
+bool Benchmark::isDone() const {
+	return g_world.getFrameCount() - m_startFrame >= m_frameLimit;
+}
+
+void Benchmark::report(ostream &stream) {
+	m_chrono.stop();
+	int frames = g_world.getFrameCount() - m_startFrame;
+	int64 millis = m_chrono.getMillis();
+	float seconds = millis / 1000.f;
+
+	stream << "Benchmark: " << frames << " world frames in " << formatTime(millis) << endl
+		<< "   World frames per sec: " << (millis ? frames / seconds : 0.f) << endl;
+
+	stream << "Time in sections (total, per frame):\n";
+	foreach_enum (TimerSection, s) {
+		int64 sectionMillis = g_debugStats->getTotalMillis(s);
+		if (sectionMillis) {
+			stream << "   " << formatEnumName(TimerSectionNames[s]) << " : " << formatTime(sectionMillis)
+				<< ", " << (frames ? float(sectionMillis) / frames : 0.f) << " ms" << endl;
+		}
+	}
+
+	stream << "Peak memory: " << (getPeakMemoryUsage() / (1024 * 1024)) << " MB" << endl;
+
+	Checksum checksum;
+	g_world.doChecksum(checksum);
+	stream << "World checksum: " << intToHex(checksum.getSum()) << endl;
+}
+
+}}
@@ -0,0 +1,55 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_BENCHMARK_H_
+#define _GLEST_GAME_BENCHMARK_H_
+
+#include <ostream>
+
+#include "timer.h"
+
+namespace Glest { namespace Main {
+
+using std::ostream;
+using Shared::Platform::Chrono;
+using Shared::Platform::int64;
+
+// =====================================================
+//	class Benchmark
+// =====================================================
+/** Drives a '-test benchmark' run. Program runs the world as fast as it can, without rendering,
+  * sound or frame pacing, until isDone(), then calls report(). AI seeds and random factions are
+  * fixed, so runs of the same build on the same settings should produce the same checksum.
+  * A window and GL context are still required (see Program::benchmarkLoop()). */
+class Benchmark {
+public:
+	/** seed used for the AI and for 'Random' factions */
+	static const int seed = 1;
+
+private:
+	int m_frameLimit;	/**< world frames to run */
+	int m_startFrame;	/**< world frame count when started */
+	Chrono m_chrono;
+
+public:
+	Benchmark(int frameLimit);
+
+	/** call once the game is loaded, starts timing */
+	void start();
+	/** @return true once frameLimit world frames have been processed since start() */
+	bool isDone() const;
+	/** stop timing and write frame rate, timer sections, peak memory and world checksum */
+	void report(ostream &stream);
+};
+
+}}
+
+#endif
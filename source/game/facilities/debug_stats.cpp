@@ -14,6 +14,10 @@
 #include "game_camera.h"
 #include "game.h"
 #include "cluster_map.h"
+#include "route_planner.h"
+#include "client_interface.h"
+#include "auto_saver.h"
+#include "interpolation.h"
 #include "properties.h"
 #include "util.h"
 
@@ -21,6 +25,8 @@ namespace Glest { namespace Debug {
 
 using Graphics::Renderer;
 using Gui::GameCamera;
+using Gui::AutoSaver;
+using Net::ClientInterface;
 using namespace Shared::Util;
 using namespace Shared::Debug;
 
@@ -157,7 +163,14 @@ void DebugStats::report(ostream &stream) {
 		stream << "\nRender Stats:\n"
 			<< "   Frames Per Sec: " << m_lastRenderFps << endl
 			<< "   Triangle count: " << renderer.getTriangleCount() << endl
-			<< "   Vertex count: " << renderer.getPointCount() << endl;
+			<< "   Vertex count: " << renderer.getPointCount() << endl
+			<< "   Interpolation cache hits: " << InterpolationData::getCacheHits()
+			<< ", misses: " << InterpolationData::getCacheMisses()
+			<< " (" << InterpolationData::getCacheBytes() / 1024 << " KB)" << endl
+			<< "   Texture & model memory (global/menu/game): "
+			<< renderer.getMemoryUsage(ResourceScope::GLOBAL) / 1024 << " / "
+			<< renderer.getMemoryUsage(ResourceScope::MENU) / 1024 << " / "
+			<< renderer.getMemoryUsage(ResourceScope::GAME) / 1024 << " KB" << endl;
 	}
 	if (m_debugSections[DebugSection::CAMERA]) {
 		const GameCamera &gameCamera = *g_gameState.getGameCamera();
@@ -175,6 +188,12 @@ void DebugStats::report(ostream &stream) {
 			<< "   Frames per Sec: " << m_lastWorldFps << endl
 			<< "   Total frame count: " << g_world.getFrameCount() << endl
 			<< "   Time of day: " << g_world.getTimeFlow()->describeTime() << endl;
+		if (ClientInterface *client = g_simInterface.asClientInterface()) {
+			stream << "   Keyframes: " << client->getNetworkStatus().getDescription() << endl;
+		}
+		if (AutoSaver *autoSaver = g_gameState.getAutoSaver()) {
+			stream << "   Autosave: " << autoSaver->getDescription() << endl;
+		}
 	}
 	if (m_debugSections[DebugSection::PERFORMANCE]) {
 		stream << "\nPerformance stats:\n"
@@ -194,7 +213,10 @@ void DebugStats::report(ostream &stream) {
 	if (m_debugSections[DebugSection::CLUSTER_MAP]) {
 		stream << "ClusterMap size (Field::LAND):\n"
 			<< "   Nodes = " << Search::Transition::NumTransitions(Field::LAND) << endl
-			<< "   Edges = " << Search::Edge::NumEdges(Field::LAND) << endl;
+			<< "   Edges = " << Search::Edge::NumEdges(Field::LAND) << endl
+			<< "   Cached routes = " << g_routePlanner.getWaypointCache().getSize()
+			<< " (hits: " << g_routePlanner.getWaypointCache().getHits()
+			<< ", misses: " << g_routePlanner.getWaypointCache().getMisses() << ")" << endl;
 	}
 	if (m_debugSections[DebugSection::PARTICLE_USE]) {
 		stream << "Particle usage counts:\n";
@@ -202,6 +224,15 @@ void DebugStats::report(ostream &stream) {
 			stream << "   " << ParticleUseNames[use] << " : " << ParticleSystem::getParticleUse(use) << endl;
 		}
 	}
+	if (m_debugSections[DebugSection::PATH_REQUESTS]) {
+		const Search::PathRequestQueue &queue = g_routePlanner.getRequestQueue();
+		stream << "Path requests:\n"
+			<< "   Queue depth = " << queue.getQueueDepth() << endl
+			<< "   Serviced from queue (last sec) = " << queue.getServicedCount() << endl
+			<< "   Avg latency (frames) = " << queue.getAvgLatency() << endl
+			<< "   Max latency (frames) = " << queue.getMaxLatency() << endl
+			<< "   Nodes expanded (last frame) = " << g_routePlanner.getNodesExpandedLastFrame() << endl;
+	}
 }
 
 void DebugStats::doPerformanceReport() {
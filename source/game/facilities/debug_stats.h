@@ -58,7 +58,8 @@ STRINGY_ENUM( DebugSection,
 	WORLD,
 	RESOURCES,
 	CLUSTER_MAP,
-	PARTICLE_USE
+	PARTICLE_USE,
+	PATH_REQUESTS
 )
 
 class DebugStats {
@@ -110,6 +111,8 @@ public:
 	}
 	void tick(int renderFps, int worldFps);
 
+	int64 getTotalMillis(TimerSection section) const { return m_totalTimers[section].getMillis(); }
+
 	bool isEnabled(DebugSection section) const { return m_debugSections[section]; }
 	bool isEnabled(TimerSection section) const { return m_reportSections[section]; }
 	bool isEnabled(TimerReportFlag flag) const { return m_reportFlags[flag]; }
@@ -123,6 +126,9 @@ public:
 
 extern DebugStats *g_debugStats; // hokey pokey
 
+/** 'PATHFINDER_TOTAL' => 'Pathfinder total' */
+string formatEnumName(const string &enumName);
+
 struct StackTimer {
 	TimerSection m_section;
 	StackTimer(TimerSection section) : m_section(section) {
@@ -38,31 +38,80 @@ namespace Glest { namespace Util {
 //  class LogFile
 // =====================================================
 
-LogFile::LogFile(const string &fileName, const string &type, TimeStampType timeType)
+LogFile::LogFile(const string &fileName, const string &type, TimeStampType timeType, bool async)
 		: m_fileName(fileName)
 		, m_fileOps(0)
-		, m_timeStampType(timeType) {
+		, m_timeStampType(timeType)
+		, m_startTime(Chrono::getCurMillis())
+		, m_ring(0)
+		, m_written(0)
+		, m_dropped(0) {
 	m_fileOps = g_fileFactory.getFileOps();
 	m_fileOps->openWrite(m_fileName.c_str());
 	string header = "Glest Advanced Engine: " + type + " log file. "
 		+ Logger::fileTimestamp() + "\n\n";
 	m_fileOps->write(header.c_str(), sizeof(char), header.size());
+	if (async) {
+		m_ring = new LogRing(ringSlots);
+	}
 }
 
 LogFile::~LogFile() {
+	if (m_ring) {
+		flush();
+		if (m_dropped) {
+			string summary = intToStr(int(m_written)) + " messages written, "
+				+ intToStr(int(m_dropped)) + " dropped" + newLine;
+			m_fileOps->write(summary.c_str(), sizeof(char), summary.size());
+		}
+		delete m_ring;
+	}
 	delete m_fileOps;
 }
 
-void LogFile::add(const string &str){
+/** append a message, with its time stamp, as a line of the file */
+void LogFile::format(const string &str, int64 time, string &out) const {
 	if (m_timeStampType == TimeStampType::SECONDS) {
-		string myTime = intToStr(int(clock() / 1000)) + ": ";
-		m_fileOps->write(myTime.c_str(), sizeof(char), myTime.size());
+		out += intToStr(int((time - m_startTime) / 1000));
+		out += ": ";
 	} else if (m_timeStampType == TimeStampType::MILLIS) {
-		string myTime = intToStr(int(clock())) + ": ";
-		m_fileOps->write(myTime.c_str(), sizeof(char), myTime.size());
+		out += intToStr(int(time - m_startTime));
+		out += ": ";
+	}
+	out += str;
+	out += newLine;
+}
+
+void LogFile::add(const string &str){
+	if (m_ring) {
+		m_ring->push(str.data(), str.size(), Chrono::getCurMillis());
+		return;
+	}
+	m_batch.clear();
+	format(str, Chrono::getCurMillis(), m_batch);
+	m_fileOps->write(m_batch.data(), sizeof(char), m_batch.size());
+}
+
+int LogFile::flush() {
+	assert(m_ring);
+	m_batch.clear();
+	int count = 0;
+	int64 time;
+	while (m_ring->pop(m_message, time)) {
+		format(m_message, time, m_batch);
+		++count;
+	}
+	int dropped = m_ring->takeDropped();
+	if (dropped) {
+		m_batch += "[" + intToStr(dropped) + " messages dropped, the log writer fell behind]";
+		m_batch += newLine;
+		m_dropped += dropped;
 	}
-	m_fileOps->write(str.c_str(), sizeof(char), str.size());
-	m_fileOps->write(newLine.c_str(), sizeof(char), newLine.size());
+	if (!m_batch.empty()) {
+		m_fileOps->write(m_batch.data(), sizeof(char), m_batch.size());
+	}
+	m_written += count;
+	return count;
 }
 
 void LogFile::logXmlError(const string &path, const char *error) {
@@ -247,7 +296,7 @@ void ProgramLog::renderLoadingScreen() {
 // =====================================================
 
 AiLogFile::AiLogFile()
-		: LogFile("glestadv-ai.log", "AI", TimeStampType::NONE) {
+		: LogFile("glestadv-ai.log", "AI", TimeStampType::NONE, true) {
 	for (int i=0; i < GameConstants::maxPlayers; ++i) {
 		m_flags[i].m_level = g_config.getAiLogLevel();
 		m_flags[i].m_enabled = g_config.getAiLoggingEnabled();
@@ -276,7 +325,7 @@ void AiLogFile::add(int f, AiComponent c, int level, const string &msg) {
 // =====================================================
 
 WorldLogFile::WorldLogFile()
-		: LogFile("glestadv-world.log", "World", TimeStampType::MILLIS) {
+		: LogFile("glestadv-world.log", "World", TimeStampType::MILLIS, true) {
 	for (int i=0; i < GameConstants::maxPlayers; ++i) {
 		m_factionFlags[i] = true;
 	}
@@ -287,6 +336,27 @@ WorldLogFile::WorldLogFile()
 	m_commandFlags[CmdClass::HARVEST] = 2;
 }
 
+// =====================================================
+//	class LogWriter
+// =====================================================
+
+void LogWriter::execute() {
+	while (!m_quit) {
+		int written = 0;
+		foreach (vector<LogFile*>, it, m_logs) {
+			written += (*it)->flush();
+		}
+		if (!written) {
+			Shared::Platform::sleep(flushInterval);
+		}
+	}
+}
+
+void LogWriter::stop() {
+	m_quit = true;
+	join();
+}
+
 // =====================================================
 //	class Logger
 // =====================================================
@@ -299,22 +369,31 @@ Logger::Logger()
 		, m_aiLog(0)
 		, m_networkLog(0)
 		, m_widgetLog(0)
-		, m_worldLog(0) {
+		, m_worldLog(0)
+		, m_writer(0) {
 	
-	// always enabled
+	// always enabled, program and error logs are written immediately, the rest are debug spam
+	// from the game loop and written in the background
 	m_programLog = new ProgramLog();
 	m_errorLog = new LogFile("glestadv-error.log", "Error", TimeStampType::NONE);
 	m_aiLog  = new AiLogFile();
-	m_networkLog  = new LogFile("glestadv-network.log", "Network", TimeStampType::MILLIS);
+	m_networkLog  = new LogFile("glestadv-network.log", "Network", TimeStampType::MILLIS, true);
+
+	m_writer = new LogWriter();
+	m_writer->addLog(m_aiLog);
+	m_writer->addLog(m_networkLog);
 
 	// enabled by preprocessor symbol
 #	if LOG_WIDGET_EVENTS
-		m_widgetLog  = new LogFile("glestadv-widget.log", "Widget", TimeStampType::MILLIS);
+		m_widgetLog  = new LogFile("glestadv-widget.log", "Widget", TimeStampType::MILLIS, true);
+		m_writer->addLog(m_widgetLog);
 #	endif
 
 #	if LOG_WORLD_EVENTS
 		m_worldLog  = new WorldLogFile();
+		m_writer->addLog(m_worldLog);
 #	endif
+	m_writer->start();
 }
 
 Logger::~Logger() {
@@ -326,7 +405,9 @@ Logger::~Logger() {
 	foreach_const (vector<string>, it, errors) {
 		m_errorLog->add(*it);
 	}
-	// close everything
+	// close everything, the asynchronous logs write what's left as they close
+	m_writer->stop();
+	delete m_writer;
 	delete m_programLog;
 	delete m_errorLog;
 	delete m_aiLog;
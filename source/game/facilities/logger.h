@@ -15,16 +15,20 @@
 
 #include <string>
 #include <deque>
+#include <vector>
 #include <time.h>
 #include <iomanip>
 #include <sstream>
 
 #include "FSFactory.hpp"
 #include "timer.h"
+#include "thread.h"
+#include "log_ring.h"
 #include "texture.h"
 #include "prototypes_enums.h"
 
 using std::deque;
+using std::vector;
 using std::string;
 using std::stringstream;
 
@@ -59,6 +63,8 @@ using Graphics::GraphicProgressBar;
 namespace Util {
 
 using namespace Shared::PhysFS;
+using Shared::Util::LogRing;
+using Shared::Platform::Thread;
 
 WRAPPED_ENUM( TimeStampType,
 	NONE,
@@ -71,19 +77,38 @@ WRAPPED_ENUM( TimeStampType,
 //
 /// Interface to a single log file
 // =====================================================
-
+/** A log file, written as messages are added or, if asynchronous, by the LogWriter thread.
+  * Asynchronous logs copy each message into a LogRing, which never blocks, messages are
+  * dropped (and the number dropped written in their place) if the writer falls behind. */
 class LogFile { // log file wrapper
 protected:
 	string         m_fileName;
 	FileOps       *m_fileOps;
 	TimeStampType  m_timeStampType;
+	int64          m_startTime;	/**< millis, time stamps are relative to it */
+	LogRing       *m_ring;		/**< buffered messages, if asynchronous */
+
+	// writer only
+	string         m_message;
+	string         m_batch;
+	int64          m_written, m_dropped;
+
+	void format(const string &str, int64 time, string &out) const;
 
 public:
-	LogFile(const string &filename, const string &type, TimeStampType timeType);
+	static const int ringSlots = 4096;	/**< of LogRing::slotSize bytes */
+
+	LogFile(const string &filename, const string &type, TimeStampType timeType, bool async = false);
 	virtual ~LogFile();
 
+	bool isAsync() const	{return m_ring != 0;}
+
 	virtual void add(const string &str);
 
+	/** write out the buffered messages, in one write, called by the LogWriter (or when it's gone)
+	  * @return number of messages written */
+	int flush();
+
 	///@todo class ErrorLogFile
 	void logXmlError(const string &path, const char *error);
 	void logMediaError(const string &xmlPath, const string &mediaPath, const char *error);
@@ -126,6 +151,7 @@ public:
 	void setSubtitle(const string &v)	{subtitle = v;}
 	void setLoading(bool v);
 	void setProgressBar(bool v)			{m_progressBar = v; m_progress = 0;}
+	int getProgress() const				{return m_progress;}
 
 	void useLoadingScreenDefaults();
 	bool setupLoadingScreen(const string &xmlpath);
@@ -231,6 +257,30 @@ public:
 	}
 };
 
+// =====================================================
+// class LogWriter
+//
+/// Background thread writing the asynchronous log files
+// =====================================================
+
+class LogWriter : public Thread {
+private:
+	vector<LogFile*> m_logs;
+	volatile bool m_quit;
+
+public:
+	static const int flushInterval = 20; /**< millis to sleep when there was nothing to write */
+
+	LogWriter() : m_quit(false) {}
+
+	/** add a log to write, before start() */
+	void addLog(LogFile *log)	{m_logs.push_back(log);}
+
+	virtual void execute() override;
+	/** finish, the logs are flushed once more after the thread ends */
+	void stop();
+};
+
 // =====================================================
 // class Logger
 //
@@ -247,6 +297,8 @@ private:
 	LogFile       *m_widgetLog;   // Pre-processor controlled
 	WorldLogFile  *m_worldLog;    // Pre-processor controlled
 
+	LogWriter     *m_writer;      // writes the ai, network, widget and world logs
+
 private:
 	Logger();
 	~Logger();
@@ -77,6 +77,7 @@ namespace Glest {
 		typedef int UnitId;
 		class CycleInfo;
 		class SimulationInterface;
+		class ReplayInterface;
 		class GameSettings;
 		class ParticleDamager;
 		class Cell;
@@ -0,0 +1,137 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "auto_saver.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "game.h"
+#include "logger.h"
+#include "timer.h"
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Gui {
+
+using std::runtime_error;
+using Shared::Platform::Chrono;
+using Shared::Util::intToStr;
+
+// =====================================================
+//	class AutoSaver
+// =====================================================
+
+AutoSaver::AutoSaver(int interval, int rotation, bool xml, bool compress)
+		: m_interval(interval)
+		, m_rotation(rotation)
+		, m_nextSlot(0)
+		, m_xml(xml)
+		, m_compress(compress)
+		, m_snapshot(0)
+		, m_quit(false)
+		, m_saveCount(0)
+		, m_skipCount(0)
+		, m_lastPause(0)
+		, m_maxPause(0)
+		, m_lastWrite(0) {
+	start();
+}
+
+AutoSaver::~AutoSaver() {
+	{
+		MutexLock lock(m_mutex);
+		m_quit = true;
+	}
+	m_signal.signal();
+	join();
+	delete m_snapshot;
+	if (m_saveCount || m_skipCount) {
+		g_logger.logProgramEvent("Autosave: " + getDescription());
+	}
+}
+
+bool AutoSaver::isDue(int frameCount) {
+	if (frameCount % m_interval != 0) {
+		return false;
+	}
+	MutexLock lock(m_mutex);
+	if (m_snapshot) {
+		++m_skipCount;
+		return false;
+	}
+	return true;
+}
+
+void AutoSaver::save(XmlNode *snapshot, int64 pause) {
+	{
+		MutexLock lock(m_mutex);
+		assert(!m_snapshot);
+		m_snapshot = snapshot;
+		m_path = "savegames/autosave_" + intToStr(m_nextSlot + 1) + ".sav";
+		m_lastPause = pause;
+		if (pause > m_maxPause) {
+			m_maxPause = pause;
+		}
+	}
+	m_nextSlot = (m_nextSlot + 1) % m_rotation;
+	m_signal.signal();
+}
+
+string AutoSaver::getDescription() {
+	MutexLock lock(m_mutex);
+	std::stringstream ss;
+	ss << m_saveCount << " saves, pause " << m_lastPause << " ms (max " << m_maxPause
+		<< "), write " << m_lastWrite << " ms";
+	if (m_skipCount) {
+		ss << ", " << m_skipCount << " skipped";
+	}
+	if (!m_lastError.empty()) {
+		ss << ", error: " << m_lastError;
+	}
+	return ss.str();
+}
+
+void AutoSaver::execute() {
+	while (true) {
+		m_signal.wait();
+		XmlNode *snapshot;
+		string path;
+		{
+			MutexLock lock(m_mutex);
+			if (m_quit) {
+				return;
+			}
+			snapshot = m_snapshot;
+			path = m_path;
+		}
+		Chrono chrono;
+		chrono.start();
+		string error;
+		try {
+			GameState::writeSavedGame(path, snapshot, m_xml, m_compress);
+		} catch (runtime_error &e) {
+			error = e.what();
+		}
+		chrono.stop();
+
+		MutexLock lock(m_mutex);
+		delete m_snapshot;
+		m_snapshot = 0;
+		m_lastWrite = chrono.getMillis();
+		m_lastError = error;
+		++m_saveCount;
+	}
+}
+
+}}
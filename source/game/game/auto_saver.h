@@ -0,0 +1,77 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_AUTOSAVER_H_
+#define _GLEST_GAME_AUTOSAVER_H_
+
+#include <string>
+
+#include "thread.h"
+#include "xml_parser.h"
+
+namespace Glest { namespace Gui {
+
+using std::string;
+using Shared::Platform::Thread;
+using Shared::Platform::Mutex;
+using Shared::Platform::MutexLock;
+using Shared::Platform::Semaphore;
+using Shared::Platform::int64;
+using Shared::Xml::XmlNode;
+
+// =====================================================
+//	class AutoSaver
+// =====================================================
+/** Writes autosaves on a background thread. At a world frame boundary GameState builds the saved
+  * game tree, which is a copy of the state the world can carry on changing, and hands it over.
+  * Encoding, compressing and writing the file then happen while the game runs. Saves rotate
+  * through rotation files, savegames/autosave_1.sav and on. */
+class AutoSaver : public Thread {
+private:
+	int m_interval;		/**< world frames between saves */
+	int m_rotation;		/**< number of autosave files */
+	int m_nextSlot;
+	bool m_xml;
+	bool m_compress;
+
+	Mutex m_mutex;		/**< guards the below */
+	Semaphore m_signal;	/**< signalled when a snapshot is handed over, and to quit */
+	XmlNode *m_snapshot;	/**< being written, or waiting to be, else null */
+	string m_path;
+	bool m_quit;
+
+	int m_saveCount;
+	int m_skipCount;	/**< saves due while the last was still being written */
+	int64 m_lastPause;	/**< millis the game was paused building the snapshot */
+	int64 m_maxPause;
+	int64 m_lastWrite;	/**< millis to encode and write the last save */
+	string m_lastError;
+
+public:
+	/** @param interval world frames between saves @param xml, compress the saved game format */
+	AutoSaver(int interval, int rotation, bool xml, bool compress);
+	/** waits for a save in progress, and logs the save times */
+	~AutoSaver();
+
+	/** @return true if a save should be made this frame, counts it as skipped if one is being
+	  * written still */
+	bool isDue(int frameCount);
+	/** write a snapshot, which the AutoSaver then owns @param pause millis taken to build it */
+	void save(XmlNode *snapshot, int64 pause);
+
+	string getDescription();
+
+	virtual void execute();
+};
+
+}}
+
+#endif
@@ -33,6 +33,7 @@
 #include "resource_bar.h"
 #include "mouse_cursor.h"
 #include "options.h"
+#include "auto_saver.h"
 
 #if _GAE_DEBUG_EDITION_
 #	include "debug_renderer.h"
@@ -95,7 +96,8 @@ GameState::GameState(Program &program)
 		, m_debugPanel(0)
 		, lastMousePos(0)
 		, weatherParticleSystem(0)
-		, m_options(0) {
+		, m_options(0)
+		, m_autoSaver(0) {
 	assert(!singleton);
 	singleton = this;
 	simInterface->constructGameWorld(this);
@@ -104,6 +106,7 @@ GameState::GameState(Program &program)
 GameState::~GameState() {
 	g_logger.getProgramLog().setState(g_lang.get("Deleting"));
 	g_logger.logProgramEvent("~GameState", !program.isTerminating());
+	delete m_autoSaver;
 
 	g_renderer.endGame();
 	weatherParticleSystem = 0;
@@ -273,6 +276,11 @@ void GameState::init() {
 	program.setFade(1.f);
 	m_debugStats.init();
 	Debug::g_debugStats = &m_debugStats;
+
+	if (g_config.getGsAutoSaveInterval() && g_world.getThisFaction()) {
+		m_autoSaver = new AutoSaver(g_config.getGsAutoSaveInterval() * WORLD_FPS,
+			g_config.getGsAutoSaveRotation(), g_config.getGsSaveXml(), g_config.getGsSaveCompressed());
+	}
 }
 
 // ==================== update ====================
@@ -310,6 +318,9 @@ void GameState::update() {
 		// update simulation
 		if (simInterface->updateWorld()) {
 			++worldFps;
+			if (m_autoSaver && m_autoSaver->isDue(g_world.getFrameCount())) {
+				autoSave();
+			}
 
 			// Particle systems
 			if (weatherParticleSystem) {
@@ -995,12 +1006,38 @@ void GameState::showWinMessageBox() {
 }
 
 void GameState::saveGame(string name) const {
-	XmlNode root("saved-game");
-	root.addAttribute("version", GameConstants::saveGameVersion);
-	gui.save(root.addChild("gui"));
-	g_simInterface.getGameSettings().save(root.addChild("settings"));
-	simInterface->getWorld()->save(root.addChild("world"));
-	XmlIo::getInstance().save("savegames/" + name + ".sav", &root);
+	auto_ptr<XmlNode> root(buildSavedGame());
+	writeSavedGame("savegames/" + name + ".sav", root.get(), g_config.getGsSaveXml(),
+		g_config.getGsSaveCompressed());
+}
+
+XmlNode* GameState::buildSavedGame() const {
+	XmlNode *root = new XmlNode("saved-game");
+	root->addAttribute("version", GameConstants::saveGameVersion);
+	// for the load game menu, which only reads the settings section of binary saves
+	root->addAttribute("frameCount", simInterface->getWorld()->getFrameCount());
+	gui.save(root->addChild("gui"));
+	g_simInterface.getGameSettings().save(root->addChild("settings"));
+	simInterface->getWorld()->save(root->addChild("world"));
+	return root;
+}
+
+void GameState::writeSavedGame(const string &path, const XmlNode *root, bool xml, bool compress) {
+	if (xml) {
+		XmlIo::getInstance().save(path, root);
+	} else {
+		XmlIo::getInstance().saveBinary(path, root, compress);
+	}
+}
+
+/** Called at a world frame boundary. Only building the tree pauses the game, the tree is a copy
+  * of the state so the AutoSaver can write it while the world carries on. */
+void GameState::autoSave() {
+	Chrono chrono;
+	chrono.start();
+	XmlNode *snapshot = buildSavedGame();
+	chrono.stop();
+	m_autoSaver->save(snapshot, chrono.getMillis());
 }
 
 // =====================================================
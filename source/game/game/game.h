@@ -46,6 +46,7 @@ using namespace Debug;
 using Widgets::MessageDialog;
 
 class OptionsFrame;
+class AutoSaver;
 
 struct ScriptMessage {
 	string header;
@@ -98,6 +99,7 @@ protected:
 	DebugPanel*     m_debugPanel;
 	GameMenu*       m_gameMenu;
 	OptionsFrame*   m_options;
+	AutoSaver*		m_autoSaver;	/**< null if autosave is off */
 
 	Vec2i lastMousePos;
 
@@ -109,6 +111,9 @@ public:
 	virtual ~GameState();
 	static GameState *getInstance()				{return singleton;}
 
+	/** write a saved game tree, as XML or binary @throws runtime_error */
+	static void writeSavedGame(const string &path, const XmlNode *root, bool xml, bool compress);
+
 	//get
 	const GameSettings &getGameSettings();
 	const Keymap &getKeymap() const			{return keymap;}
@@ -119,6 +124,7 @@ public:
 	const UserInterface *getGui() const		{return &gui;}
 	UserInterface *getGui()					{return &gui;}
 	DebugStats* getDebugStats()             {return &m_debugStats;}
+	AutoSaver* getAutoSaver()				{return m_autoSaver;}
 	Vec2i getMousePos() const				{return Vec2i(mouseX, mouseY);}
 	
 	// ProgramState implementation
@@ -190,6 +196,9 @@ protected:
 	
 	//char getStringFromFile(ifstream *fileStream, string *str);
 	void saveGame(string name) const;
+	/** @return the saved game tree for the current state, which the caller owns */
+	XmlNode* buildSavedGame() const;
+	void autoSave();
 	void onSaveSelected(Widget*);
 
 	void displayError(std::exception &e);
@@ -63,6 +63,36 @@ GameSettings::GameSettings(const XmlNode *node) {
 	}
 }
 
+GameSettings::GameSettings(BinaryReader &reader) {
+	clear();
+	description = reader.readString();
+	mapPath = reader.readString();
+	tilesetPath = reader.readString();
+	techPath = reader.readString();
+	scenarioPath = reader.readString();
+	thisFactionIndex = reader.readSigned();
+	factionCount = reader.readUnsigned();
+	if (factionCount > GameConstants::maxPlayers) {
+		throw runtime_error("Bad faction count in game settings");
+	}
+	fogOfWar = reader.readBool();
+	shroudOfDarkness = reader.readBool();
+	randomStartLocs = reader.readBool();
+	defaultUnits = reader.readBool();
+	defaultResources = reader.readBool();
+	defaultVictoryConditions = reader.readBool();
+
+	for (int i = 0; i < factionCount; ++i) {
+		factionTypeNames[i] = reader.readString();
+		playerNames[i] = reader.readString();
+		factionControls[i] = enum_cast<ControlType>(reader.readUnsigned());
+		teams[i] = reader.readSigned();
+		startLocationIndex[i] = reader.readSigned();
+		colourIndices[i] = reader.readSigned();
+		resourceMultipliers[i] = reader.readFloat();
+	}
+}
+
 bool GameSettings::hasNetworkSlots() const {
 	for (int i=0; i < GameConstants::maxPlayers; ++i) {
 		if (factionControls[i] == ControlType::NETWORK) {
@@ -177,8 +207,34 @@ void GameSettings::save(XmlNode *node) const {
 	}
 }
 
-void GameSettings::randomiseFactions(const vector<string> &possibleFactions) {
-	Random random(Chrono::getCurMillis());
+void GameSettings::save(BinaryWriter &writer) const {
+	writer.writeString(description);
+	writer.writeString(mapPath);
+	writer.writeString(tilesetPath);
+	writer.writeString(techPath);
+	writer.writeString(scenarioPath);
+	writer.writeSigned(thisFactionIndex);
+	writer.writeUnsigned(factionCount);
+	writer.writeBool(fogOfWar);
+	writer.writeBool(shroudOfDarkness);
+	writer.writeBool(randomStartLocs);
+	writer.writeBool(defaultUnits);
+	writer.writeBool(defaultResources);
+	writer.writeBool(defaultVictoryConditions);
+
+	for (int i = 0; i < factionCount; ++i) {
+		writer.writeString(factionTypeNames[i]);
+		writer.writeString(playerNames[i]);
+		writer.writeUnsigned(factionControls[i]);
+		writer.writeSigned(teams[i]);
+		writer.writeSigned(startLocationIndex[i]);
+		writer.writeSigned(colourIndices[i]);
+		writer.writeFloat(resourceMultipliers[i]);
+	}
+}
+
+void GameSettings::randomiseFactions(const vector<string> &possibleFactions, int seed) {
+	Random random(seed == -1 ? int(Chrono::getCurMillis()) : seed);
 	for (int i = 0; i < getFactionCount(); ++i) {
 		if (getFactionTypeName(i) == "Random") {
 			int ndx = random.randRange(0, possibleFactions.size() - 1);
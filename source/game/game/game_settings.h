@@ -15,9 +15,12 @@
 #include <string>
 #include "game_constants.h"
 #include "xml_parser.h"
+#include "binary_stream.h"
 
 using std::string;
 using Shared::Xml::XmlNode;
+using Shared::Util::BinaryWriter;
+using Shared::Util::BinaryReader;
 
 namespace Glest { namespace Sim {
 using namespace GameConstants;
@@ -58,6 +61,8 @@ private:
 public:
 	GameSettings() { clear(); }
 	GameSettings(const XmlNode *node);
+	/** @throws runtime_error if the data is short */
+	GameSettings(BinaryReader &reader);
 
 	void setPreviewSettings();
 	void clear();
@@ -116,9 +121,11 @@ public:
 	void setRandomStartLocs(bool v)					{randomStartLocs = v;}
 
 	//misc
-	void randomiseFactions(const vector<string> &possibleFactions);
+	/** replace 'Random' factions @param seed random seed, -1 to seed from the clock */
+	void randomiseFactions(const vector<string> &possibleFactions, int seed = -1);
 	void randomizeLocs(int maxPlayers);
 	void save(XmlNode *node) const;
+	void save(BinaryWriter &writer) const;
 };
 
 }}//end namespace
@@ -52,7 +52,12 @@ Config::Config(const char* fileName) {
 	displayWindowed = p->getBool("DisplayWindowed", false);
 	gsAutoRepairEnabled = p->getBool("GsAutoRepairEnabled", true);
 	gsAutoReturnEnabled = p->getBool("GsAutoReturnEnabled", false);
+	gsAutoSaveInterval = p->getInt("GsAutoSaveInterval", 300, 0, 3600);
+	gsAutoSaveRotation = p->getInt("GsAutoSaveRotation", 3, 1, 10);
 	gsDayTime = p->getFloat("GsDayTime", 1000.f);
+	gsRecordReplays = p->getBool("GsRecordReplays", true);
+	gsSaveCompressed = p->getBool("GsSaveCompressed", true);
+	gsSaveXml = p->getBool("GsSaveXml", false);
 	gsWorldUpdateFps = p->getInt("GsWorldUpdateFps", 40);
 	miscCatchExceptions = p->getBool("MiscCatchExceptions", true);
 	miscDebugKeys = p->getBool("MiscDebugKeys", false);
@@ -61,6 +66,7 @@ Config::Config(const char* fileName) {
 	netAnnouceOnLAN = p->getBool("NetAnnouceOnLAN", true);
 	netAnnouncePort = p->getInt("NetAnnouncePort", 4950, 1024, 65535);
 	netConsistencyChecks = p->getBool("NetConsistencyChecks", false);
+	netKeyframeBuffer = p->getInt("NetKeyframeBuffer", 2, 1, 8);
 	netPlayerName = p->getString("NetPlayerName", "Player");
 	netServerIp = p->getString("NetServerIp", "192.168.1.1");
 	netServerPort = p->getInt("NetServerPort", 61357, 1024, 65535);
@@ -88,6 +94,7 @@ Config::Config(const char* fileName) {
 	renderShadowFrameSkip = p->getInt("RenderShadowFrameSkip", 2);
 	renderShadowTextureSize = p->getInt("RenderShadowTextureSize", 512);
 	renderShadows = p->getString("RenderShadows", "Projected");
+	renderShareTexturesByContent = p->getBool("RenderShareTexturesByContent", false);
 	renderTerrainRenderer = p->getInt("RenderTerrainRenderer", 2, 1, 2);
 	renderTestingShaders = p->getBool("RenderTestingShaders", false);
 	renderTextures3D = p->getBool("RenderTextures3D", true);
@@ -148,7 +155,12 @@ void Config::save(const char *path) {
 	p->setBool("DisplayWindowed", displayWindowed);
 	p->setBool("GsAutoRepairEnabled", gsAutoRepairEnabled);
 	p->setBool("GsAutoReturnEnabled", gsAutoReturnEnabled);
+	p->setInt("GsAutoSaveInterval", gsAutoSaveInterval);
+	p->setInt("GsAutoSaveRotation", gsAutoSaveRotation);
 	p->setFloat("GsDayTime", gsDayTime);
+	p->setBool("GsRecordReplays", gsRecordReplays);
+	p->setBool("GsSaveCompressed", gsSaveCompressed);
+	p->setBool("GsSaveXml", gsSaveXml);
 	p->setInt("GsWorldUpdateFps", gsWorldUpdateFps);
 	p->setBool("MiscCatchExceptions", miscCatchExceptions);
 	p->setBool("MiscDebugKeys", miscDebugKeys);
@@ -157,6 +169,7 @@ void Config::save(const char *path) {
 	p->setBool("NetAnnouceOnLAN", netAnnouceOnLAN);
 	p->setInt("NetAnnouncePort", netAnnouncePort);
 	p->setBool("NetConsistencyChecks", netConsistencyChecks);
+	p->setInt("NetKeyframeBuffer", netKeyframeBuffer);
 	p->setString("NetPlayerName", netPlayerName);
 	p->setString("NetServerIp", netServerIp);
 	p->setInt("NetServerPort", netServerPort);
@@ -184,6 +197,7 @@ void Config::save(const char *path) {
 	p->setInt("RenderShadowFrameSkip", renderShadowFrameSkip);
 	p->setInt("RenderShadowTextureSize", renderShadowTextureSize);
 	p->setString("RenderShadows", renderShadows);
+	p->setBool("RenderShareTexturesByContent", renderShareTexturesByContent);
 	p->setInt("RenderTerrainRenderer", renderTerrainRenderer);
 	p->setBool("RenderTestingShaders", renderTestingShaders);
 	p->setBool("RenderTextures3D", renderTextures3D);
@@ -47,7 +47,12 @@ private:
 	bool displayWindowed;
 	bool gsAutoRepairEnabled;
 	bool gsAutoReturnEnabled;
+	int gsAutoSaveInterval;
+	int gsAutoSaveRotation;
 	float gsDayTime;
+	bool gsRecordReplays;
+	bool gsSaveCompressed;
+	bool gsSaveXml;
 	int gsWorldUpdateFps;
 	bool miscCatchExceptions;
 	bool miscDebugKeys;
@@ -56,6 +61,7 @@ private:
 	bool netAnnouceOnLAN;
 	int netAnnouncePort;
 	bool netConsistencyChecks;
+	int netKeyframeBuffer;
 	string netPlayerName;
 	string netServerIp;
 	int netServerPort;
@@ -83,6 +89,7 @@ private:
 	int renderShadowFrameSkip;
 	int renderShadowTextureSize;
 	string renderShadows;
+	bool renderShareTexturesByContent;
 	int renderTerrainRenderer;
 	bool renderTestingShaders;
 	bool renderTextures3D;
@@ -151,7 +158,12 @@ public:
 	bool getDisplayWindowed() const				{return displayWindowed;}
 	bool getGsAutoRepairEnabled() const			{return gsAutoRepairEnabled;}
 	bool getGsAutoReturnEnabled() const			{return gsAutoReturnEnabled;}
+	int getGsAutoSaveInterval() const			{return gsAutoSaveInterval;}
+	int getGsAutoSaveRotation() const			{return gsAutoSaveRotation;}
 	float getGsDayTime() const					{return gsDayTime;}
+	bool getGsRecordReplays() const				{return gsRecordReplays;}
+	bool getGsSaveCompressed() const			{return gsSaveCompressed;}
+	bool getGsSaveXml() const					{return gsSaveXml;}
 	int getGsWorldUpdateFps() const				{return gsWorldUpdateFps;}
 	bool getMiscCatchExceptions() const			{return miscCatchExceptions;}
 	bool getMiscDebugKeys() const				{return miscDebugKeys;}
@@ -160,6 +172,7 @@ public:
 	bool getNetAnnouceOnLAN() const				{return netAnnouceOnLAN;}
 	int getNetAnnouncePort() const				{return netAnnouncePort;}
 	bool getNetConsistencyChecks() const		{return netConsistencyChecks;}
+	int getNetKeyframeBuffer() const			{return netKeyframeBuffer;}
 	string getNetPlayerName() const				{return netPlayerName;}
 	string getNetServerIp() const				{return netServerIp;}
 	int getNetServerPort() const				{return netServerPort;}
@@ -187,6 +200,7 @@ public:
 	int getRenderShadowFrameSkip() const		{return renderShadowFrameSkip;}
 	int getRenderShadowTextureSize() const		{return renderShadowTextureSize;}
 	string getRenderShadows() const				{return renderShadows;}
+	bool getRenderShareTexturesByContent() const{return renderShareTexturesByContent;}
 	int getRenderTerrainRenderer() const		{return renderTerrainRenderer;}
 	bool getRenderTestingShaders() const		{return renderTestingShaders;}
 	bool getRenderTextures3D() const			{return renderTextures3D;}
@@ -237,7 +251,12 @@ public:
 	void setDisplayWindowed(bool val)			{displayWindowed = val;}
 	void setGsAutoRepairEnabled(bool val)		{gsAutoRepairEnabled = val;}
 	void setGsAutoReturnEnabled(bool val)		{gsAutoReturnEnabled = val;}
+	void setGsAutoSaveInterval(int val)			{gsAutoSaveInterval = val;}
+	void setGsAutoSaveRotation(int val)			{gsAutoSaveRotation = val;}
 	void setGsDayTime(float val)				{gsDayTime = val;}
+	void setGsRecordReplays(bool val)			{gsRecordReplays = val;}
+	void setGsSaveCompressed(bool val)			{gsSaveCompressed = val;}
+	void setGsSaveXml(bool val)					{gsSaveXml = val;}
 	void setGsWorldUpdateFps(int val)			{gsWorldUpdateFps = val;}
 	void setMiscCatchExceptions(bool val)		{miscCatchExceptions = val;}
 	void setMiscDebugKeys(bool val)				{miscDebugKeys = val;}
@@ -246,6 +265,7 @@ public:
 	void setNetAnnouceOnLAN(bool val)			{netAnnouceOnLAN = val;}
 	void setNetAnnouncePort(int val)			{netAnnouncePort = val;}
 	void setNetConsistencyChecks(bool val)		{netConsistencyChecks = val;}
+	void setNetKeyframeBuffer(int val)			{netKeyframeBuffer = val;}
 	void setNetPlayerName(string val)			{netPlayerName = val;}
 	void setNetServerIp(string val)				{netServerIp = val;}
 	void setNetServerPort(int val)				{netServerPort = val;}
@@ -273,6 +293,7 @@ public:
 	void setRenderShadowFrameSkip(int val)		{renderShadowFrameSkip = val;}
 	void setRenderShadowTextureSize(int val)	{renderShadowTextureSize = val;}
 	void setRenderShadows(string val)			{renderShadows = val;}
+	void setRenderShareTexturesByContent(bool val){renderShareTexturesByContent = val;}
 	void setRenderTerrainRenderer(int val)		{renderTerrainRenderer = val;}
 	void setRenderTestingShaders(bool val)		{renderTestingShaders = val;}
 	void setRenderTextures3D(bool val)			{renderTextures3D = val;}
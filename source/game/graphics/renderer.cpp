@@ -30,6 +30,9 @@
 #include "debug_stats.h"
 #include "program.h"
 #include "util.h"
+#include "interpolation.h"
+#include "picker.h"
+#include "compressed_texture.h"
 #include "leak_dumper.h"
 
 #if _GAE_DEBUG_EDITION_
@@ -175,6 +178,8 @@ Renderer::Renderer()
 //	textRenderer= graphicsFactory->newTextRendererBM();
 	textRendererFT = graphicsFactory->newTextRendererFT();
 	particleRenderer= graphicsFactory->newParticleRenderer();
+	// the main thread helps out, so one less worker than processors
+	workerPool = new WorkerPool(getProcessorCount() - 1);
 
 	//resources
 	for(int i=0; i<ResourceScope::COUNT; ++i){
@@ -182,6 +187,7 @@ Renderer::Renderer()
 		textureManager[i]= graphicsFactory->newTextureManager();
 		modelManager[i]->setTextureManager(textureManager[i]);
 		particleManager[i]= graphicsFactory->newParticleManager();
+		particleManager[i]->setWorkerPool(workerPool);
 		fontManager[i]= graphicsFactory->newFontManager();
 	}
 	perspFov = config.getRenderFov();
@@ -218,6 +224,7 @@ Renderer::~Renderer(){
 		delete particleManager[i];
 		delete fontManager[i];
 	}
+	delete workerPool;
 }
 
 Renderer &Renderer::getInstance(){
@@ -417,6 +424,7 @@ void Renderer::initGame(GameState *game) {
 	ONE_TIME_TIMER(Renderer_Init_Game, cout);
 	this->game= game;
 	m_mainMenu = 0;
+	InterpolationData::resetCacheStats();
 
 	// check gl caps
 	checkGlOptionalCaps();
@@ -600,6 +608,18 @@ Model* Renderer::newModel(ResourceScope rs) {
 	return modelManager[rs]->newModel();
 }
 
+Model* Renderer::newModel(ResourceScope rs, const string &path) {
+	return modelManager[rs]->newModel(path);
+}
+
+Model* Renderer::getModel(ResourceScope rs, const string &path) {
+	return modelManager[rs]->getModel(path);
+}
+
+int64 Renderer::getMemoryUsage(ResourceScope rs) const {
+	return textureManager[rs]->getMemoryUsage() + modelManager[rs]->getMemoryUsage();
+}
+
 Texture2D* Renderer::getTexture2D(ResourceScope rs, const string &path) {
 	return textureManager[rs]->getTexture(path);
 }
@@ -608,6 +628,10 @@ Texture2D* Renderer::newTexture2D(ResourceScope rs) {
 	return textureManager[rs]->newTexture2D();
 }
 
+void Renderer::preloadTextures(ResourceScope rs, const vector<string> &paths, WorkerPool &pool) {
+	textureManager[rs]->preload(paths, pool);
+}
+
 Texture3D* Renderer::newTexture3D(ResourceScope rs) {
 	return textureManager[rs]->newTexture3D();
 }
@@ -1591,65 +1615,51 @@ struct PickHit {
 	}
 };
 
+/** Find the units (or failing that, a resource object) in the selection rectangle, closest first.
+  * Picking is done on the CPU against model bounds (see Picker), only units and objects in the
+  * visible cells (as found by the SceneCuller for rendering) are tested. */
 void Renderer::computeSelected(UnitVector &units, const MapObject *&obj, const Vec2i &posDown, const Vec2i &posUp){
 	SECTION_TIMER(RENDER_SELECT);
-	// declarations
-	GLuint selectBuffer[UserInterface::maxSelBuff];
 	const Metrics &metrics= Metrics::getInstance();
+	const GameCamera *gameCamera = game->getGameCamera();
 
-	// compute center and dimensions of selection rectangle
-	int x = (posDown.x + posUp.x) / 2;
-	int y = ((metrics.getScreenH() - posDown.y) + (metrics.getScreenH() - posUp.y)) / 2;
-	int w = abs(posDown.x - posUp.x);
-	int h = abs(posDown.y - posUp.y);
-	if (w < 1) w = 1;
-	if (h < 1) h = 1;
-
-	//setup matrices
-	glSelectBuffer(UserInterface::maxSelBuff, selectBuffer);
-	glMatrixMode(GL_PROJECTION);
-	glPushMatrix();
-	GLint view[]= {0, 0, metrics.getScreenW(), metrics.getScreenH()};
-	glRenderMode(GL_SELECT);
-	glLoadIdentity();
-	gluPickMatrix(x, y, w, h, view);
-	gluPerspective(perspFov, metrics.getAspectRatio(), perspNearPlane, perspFarPlane);
-	loadGameCameraMatrix();
-
-	glInitNames();
-
-	//render units and resources
-	renderUnitsForSelection();
-	renderObjectsForSelection();
+	Picker picker(gameCamera->getPos(), gameCamera->getHAng(), gameCamera->getVAng(), perspFov,
+		metrics.getAspectRatio(), perspNearPlane, perspFarPlane, metrics.getScreenW(), metrics.getScreenH());
+	picker.setRect(posDown, posUp);
 
-	//pop matrices
-	glMatrixMode(GL_PROJECTION);
-	glPopMatrix();
+	set<PickHit> unitHits, objectHits;
+	uint32 nearDist;
 
-	//g_gameState.resetRawPick();
-	//g_gameState.resetUnitPickHits();
+	// units, name1 is the faction index (or glestimals), name2 the unit id
+	for (int i=0; i < GameConstants::maxPlayers + 1; ++i) {
+		foreach_const (vector<const Unit*>, it, m_unitsToRender[i]) {
+			const Unit *unit = *it;
+			if (unit->isDead() || unit->isCarried()) {
+				continue;
+			}
+			const Model *model = unit->getCurrentModel();
+			if (picker.pick(unit->getCurrVectorFlat(), unit->getRotation(), model->getBoundsMin(),
+					model->getBoundsMax(), nearDist)) {
+				unitHits.insert(PickHit(nearDist, i, unit->getId()));
+			}
+		}
+	}
 
-	// process hits
-	int selCount = glRenderMode(GL_RENDER);
-	set<PickHit> unitHits, objectHits;
-	GLuint *ptr = selectBuffer;
-	for (int i = 0; i < selCount; ++i) {
-		INVARIANT(*ptr == 2, "something was rendered in selection mode without 2 names on the stack");
-		++ptr;
-		GLuint nearDist = *ptr++;
-		++ptr;
-		GLuint name1 = *ptr++;
-		GLuint name2 = *ptr++;
-
-		//string rawHit = intToStr(name1) + " : " + intToStr(name2);
-		//g_gameState.addRawPick(rawHit);
-
-		if (name1 < GameConstants::maxPlayers + 1) {
-			unitHits.insert(PickHit(nearDist, name1, name2));
-		} else {
-			objectHits.insert(PickHit(nearDist, name1, name2));
+	// resources, name1 is 0x101, name2 the object id
+	const Map *map = g_world.getMap();
+	int thisTeamIndex = g_world.getThisTeamIndex();
+	foreach_const (ConstMapObjVector, it, m_objectsToRender) {
+		const MapObject *mapObj = *it;
+		if (!mapObj->getResource() || !map->getTile(mapObj->getTilePos())->isExplored(thisTeamIndex)) {
+			continue;
+		}
+		const Model *model = mapObj->getModel();
+		if (picker.pick(mapObj->getPos(), mapObj->getRotation(), model->getBoundsMin(),
+				model->getBoundsMax(), nearDist)) {
+			objectHits.insert(PickHit(nearDist, 0x101, mapObj->getId()));
 		}
 	}
+
 	units.clear();
 	obj = 0;
 	if (unitHits.empty()) { // no units, check objects
@@ -1919,6 +1929,14 @@ void Renderer::loadConfig(){
 	for(int i=0; i<ResourceScope::COUNT; ++i){
 		textureManager[i]->setFilter(textureFilter);
 		textureManager[i]->setMaxAnisotropy(maxAnisotropy);
+		textureManager[i]->setShareByContent(config.getRenderShareTexturesByContent());
+	}
+	// compress mipmapped textures on the CPU once and cache them, rather than have the driver
+	// build mipmaps and compress at every load
+	if (config.getRenderCompressTextures() && isGlExtensionSupported("GL_EXT_texture_compression_s3tc")) {
+		CompressedTexture::setCacheDir("cache/");
+	} else {
+		CompressedTexture::setCacheDir("");
 	}
 }
 
@@ -2125,96 +2143,6 @@ void Renderer::renderObjectsForShadows() {
 	assertGl();
 }
 
-void Renderer::renderUnitsForSelection() {
-	const Unit *unit;
-	bool changeColor = false;
-	const World *world= &g_world;
-	const Faction *thisFaction = world->getThisFaction();
-	const Map *map = world->getMap();
-
-	assertGl();
-
-	glPushAttrib(GL_ENABLE_BIT | GL_TEXTURE_BIT);
-	glDisable(GL_LIGHTING);
-
-	glDisable(GL_TEXTURE_2D);
-
-	modelRenderer->begin(RenderMode::SELECTION, false, 0);
-
-	for (int i=0; i < GameConstants::maxPlayers + 1; ++i) {
-		if (m_unitsToRender[i].empty()) continue;
-
-		glPushName(i);
-		vector<const Unit *>::iterator it = m_unitsToRender[i].begin();
-		for ( ; it != m_unitsToRender[i].end(); ++it) {
-			unit = *it;
-			if (unit->isDead() || unit->isCarried()) {
-				continue;
-			}
-			glPushName(unit->getId());
-			glMatrixMode(GL_MODELVIEW);
-			glPushMatrix();
-			RUNTIME_CHECK(!unit->isCarried() && unit->getPos().x >= 0 && unit->getPos().y >= 0);
-
-			//translate
-			Vec3f currVec = unit->getCurrVectorFlat();
-			glTranslatef(currVec.x, currVec.y, currVec.z);
-
-			//rotate
-			glRotatef(unit->getRotation(), 0.f, 1.f, 0.f);
-
-			//render
-			const Model *model = unit->getCurrentModel();
-			model->updateInterpolationData(unit->getAnimProgress(), unit->isAlive());
-			modelRenderer->render(model);
-
-			glPopMatrix();
-			glPopName();
-		}
-		glPopName();
-	}
-	modelRenderer->end();
-	glPopAttrib();
-}
-
-void Renderer::renderObjectsForSelection() {
-	const World *world= &g_world;
-	const Map *map= world->getMap();
-
-	assertGl();
-
-	glPushAttrib(GL_ENABLE_BIT| GL_TEXTURE_BIT);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_TEXTURE_2D);
-
-	modelRenderer->begin(RenderMode::SELECTION, false, 0);
-
-	int thisTeamIndex = world->getThisTeamIndex();
-
-	foreach (ConstMapObjVector, it, m_objectsToRender) {
-		const MapObject *obj = *it;
-		Tile *tile = map->getTile(obj->getTilePos());
-		if (tile->isExplored(thisTeamIndex) && obj->getResource()) {
-			glPushName(0x101);	// resource
-			glPushName(obj->getId());	// obj id
-
-			Vec3f v = obj->getPos();
-			glMatrixMode(GL_MODELVIEW);
-			glPushMatrix();
-				glTranslatef(v.x, v.y, v.z);
-				glRotatef(obj->getRotation(), 0.f, 1.f, 0.f);
-				modelRenderer->render(obj->getModel());
-			glPopMatrix();
-
-			glPopName();
-			glPopName();
-		}
-	}
-	modelRenderer->end();
-	glPopAttrib();
-	assertGl();
-}
-
 // ==================== gl caps ====================
 
 void Renderer::checkGlCaps() {
@@ -2655,53 +2583,6 @@ void Renderer::renderProgressBar(int progress, int x, int y, int w, int h, const
 	textRendererFT->end();
 }
 
-void Renderer::renderTile(const Vec2i &pos){
-
-	const Map *map= g_world.getMap();
-	Vec2i scaledPos= pos * GameConstants::cellScale;
-
-	glMatrixMode(GL_MODELVIEW);
-	glPushMatrix();
-	glTranslatef(-0.5f, 0.f, -0.5f);
-
-	glInitNames();
-	for (int i=0; i < GameConstants::cellScale; ++i) {
-		for (int j=0; j < GameConstants::cellScale; ++j) {
-
-			Vec2i renderPos = scaledPos + Vec2i(i, j);
-
-			glPushName(renderPos.y);
-			glPushName(renderPos.x);
-
-			glDisable(GL_CULL_FACE);
-
-			glBegin(GL_TRIANGLE_STRIP);
-			glVertex3f(
-				float(renderPos.x),
-				map->getCell(renderPos.x, renderPos.y)->getHeight(),
-				float(renderPos.y));
-			glVertex3f(
-				float(renderPos.x),
-				map->getCell(renderPos.x, renderPos.y+1)->getHeight(),
-				float(renderPos.y+1));
-			glVertex3f(
-				float(renderPos.x+1),
-				map->getCell(renderPos.x+1, renderPos.y)->getHeight(),
-				float(renderPos.y));
-			glVertex3f(
-				float(renderPos.x+1),
-				map->getCell(renderPos.x+1, renderPos.y+1)->getHeight(),
-				float(renderPos.y+1));
-			glEnd();
-
-			glPopName();
-			glPopName();
-		}
-	}
-
-	glPopMatrix();
-}
-
 void Renderer::renderQuad(int x, int y, int w, int h, const Texture2D *texture){
 	glBindTexture(GL_TEXTURE_2D, static_cast<const Texture2DGl*>(texture)->getHandle());
 	glBegin(GL_TRIANGLE_STRIP);
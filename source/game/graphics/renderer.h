@@ -126,6 +126,9 @@ private:
 	FontManager *fontManager[ResourceScope::COUNT];
 	ParticleManager *particleManager[ResourceScope::COUNT];
 
+	// threads to step particle systems on
+	WorkerPool *workerPool;
+
 	// display list handles
 	GLuint list3d;
 	GLuint list2d;
@@ -204,12 +207,20 @@ public:
 
 	// engine interface
 	Model *newModel(ResourceScope rs);
+	/** create a model for a file, to be loaded by the caller, shared through getModel() */
+	Model *newModel(ResourceScope rs, const string &path);
+	/** @return the model created for a file, or NULL */
+	Model *getModel(ResourceScope rs, const string &path);
 	Texture2D *getTexture2D(ResourceScope rs, const string &path);
 	Texture2D *newTexture2D(ResourceScope rs);
+	void preloadTextures(ResourceScope rs, const vector<string> &paths, WorkerPool &pool);
 	Texture3D *newTexture3D(ResourceScope rs);
 
 	void deleteTexture2D(Texture2D *tex, ResourceScope rs);
 
+	/** @return estimated bytes of texture and vertex memory held for a scope */
+	int64 getMemoryUsage(ResourceScope rs) const;
+
 	//Font *newFont(ResourceScope rs);
 	Font *newFreeTypeFont(ResourceScope rs);
 	
@@ -299,14 +310,9 @@ private:
 	Vec4f computeWaterColor(float waterLevel, float cellHeight);
 	void checkExtension(const string &extension, const string &msg);
 
-	// selection or shadows render
+	// shadows render
 	void renderObjectsForShadows();
 	void renderUnitsForShadows();
-	void renderObjectsForSelection();
-	void renderUnitsForSelection();
-
-	//void renderObjectsFast(bool shadows = false);
-	//void renderUnitsFast(bool renderingShadows = false);
 
 	// gl requirements
 	void checkGlCaps();
@@ -321,7 +327,6 @@ private:
 	// private aux drawing
 	void renderSelectionCircle(Vec3f v, int size, float radius);
 	void renderArrow(const Vec3f &pos1, const Vec3f &pos2, const Vec3f &color, float width);
-	void renderTile(const Vec2i &pos);
 	void renderQuad(int x, int y, int w, int h, const Texture2D *texture);
 
 public:
@@ -13,6 +13,7 @@
 #include "lang.h"
 #include "config.h"
 #include "game.h"
+#include "profiler.h"
 
 namespace Glest { namespace Gui {
 
@@ -40,6 +41,9 @@ DebugOptions::DebugOptions(Container *parent, bool menu)
 	m_debugMode->Clicked.connect(this, &DebugOptions::onCheckChanged);
 	m_debugKeys = rightPnl->addCheckBox(g_lang.get("DebugKeys"), g_config.getMiscDebugKeys());
 	m_debugKeys->Clicked.connect(this, &DebugOptions::onCheckChanged);
+	m_profiler = rightPnl->addCheckBox(g_lang.get("Profiler"),
+		Shared::Util::Profile::isEnabled());
+	m_profiler->Clicked.connect(this, &DebugOptions::onCheckChanged);
 
 	rightPnl->addHeading(leftPnl, g_lang.get("DebugSections"));
 	foreach_enum (DebugSection, ds) {
@@ -80,6 +84,10 @@ void DebugOptions::onCheckChanged(Widget *widget) {
 		g_config.setMiscDebugKeys(!g_config.getMiscDebugKeys());
 		return;
 	}
+	if (cb == m_profiler) {
+		Shared::Util::Profile::setEnabled(cb->isChecked());
+		return;
+	}
 	foreach_enum (DebugSection, ds) {
 		if (m_debugSections[ds] == cb) {
 			m_stats->setEnabled(ds, cb->isChecked());
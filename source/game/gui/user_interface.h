@@ -90,7 +90,6 @@ class UserInterface : public sigslot::has_slots {
 public:
 	static const int cellWidthCount = Display::cellWidthCount;
 	static const int cellHeightCount = Display::cellHeightCount;
-	static const int maxSelBuff = 128 * 5;
 	static const int upgradeDisplayIndex = cellWidthCount * 2;
 	
 	static const int autoRepairPos = cellWidthCount * cellHeightCount - 6;
@@ -13,6 +13,7 @@
 #include "CmdArgs.h"
 
 #include <iostream>
+#include <cstdlib>
 
 #include "projectConfig.h"
 #include "util.h"
@@ -34,8 +35,11 @@ CmdArgs::CmdArgs(){
 	this->configDir = DEFAULT_CONFIG_DIR;
 	this->dataDir = DEFAULT_DATA_DIR;
 	test = false;
+	m_benchmarkFrames = 6000;
 	m_redirStreams = true; // ignored on Linux
 	m_lastGame = false;
+	m_watchReplay = false;
+	m_profile = false;
 }
 
 CmdArgs::~CmdArgs(){
@@ -72,6 +76,18 @@ bool CmdArgs::parse(int argc, char **argv){
 		} else if (arg == "-test" && (i+1) < argc) {
 			test = true;
 			testType = argv[++i];
+		} else if (arg == "-frames" && (i+1) < argc) {
+			m_benchmarkFrames = atoi(argv[++i]);
+			if (m_benchmarkFrames <= 0) {
+				cout << "Error: option -frames: expected a positive number of frames." << endl;
+				return true;
+			}
+		} else if (arg == "-replay" && (i+1) < argc) {
+			m_replay = argv[++i];
+		} else if (arg == "-watch") {
+			m_watchReplay = true;
+		} else if (arg == "-profile") {
+			m_profile = true;
 		} else if (arg == "-version") {
 			cout << "Glest Advanced Engine " << VERSION_STRING << endl;
 			return true;
@@ -83,7 +99,15 @@ bool CmdArgs::parse(int argc, char **argv){
 				<< "  -datadir path            set location of data\n"
 				<< "  -loadmap map tileset     load maps/map.gbm with tilesets/tileset for map preview\n"
 				<< "  -scenario category name  load immediately scenario/category/name\n"
-				<< "  -lastgame                immediately start a game with the last used game settings\n";
+				<< "  -lastgame                immediately start a game with the last used game settings\n"
+				<< "  -test benchmark          run the last used game settings with all CPU players, as fast\n"
+				<< "                           as possible, then report timings and a world checksum\n"
+				<< "  -frames n                number of world frames to run for -test benchmark (6000)\n"
+				<< "  -replay file             play a replay (e.g. replays/last_game.rpl) as fast as possible,\n"
+				<< "                           then report timings and whether the world diverged\n"
+				<< "  -watch                   with -replay, render the replay at normal speed\n"
+				<< "  -profile                 run the profiler from startup, writing profiler.log and\n"
+				<< "                           profiler.json (a chrome://tracing timeline) on exit\n";
 			return true;
 		}else if(arg=="-list-tilesets"){  //FIXME: only works with physfs
 				cout << "config: " << configDir << "\ndata: " << dataDir << endl;
@@ -42,6 +42,14 @@ private:
 	bool m_lastGame;
 	bool test;
 	string testType;
+	/// world frames to run for -test benchmark
+	int m_benchmarkFrames;
+	/// not empty if -replay, the replay file to play
+	string m_replay;
+	/// true if -watch, render the replay at normal speed
+	bool m_watchReplay;
+	/// true if -profile, record the profiler from startup
+	bool m_profile;
 
 	bool m_redirStreams; // redirect stdout and stderr
 
@@ -65,8 +73,12 @@ public:
 	string &getScenario()    { return scenario; }
 
 	bool isTest(const string &type) const { return (test && testType == type); }
+	int getBenchmarkFrames() const { return m_benchmarkFrames; }
 	bool redirStreams() const { return m_redirStreams; }
 	bool isLoadLastGame() const { return m_lastGame; }
+	const string &getReplay() const { return m_replay; }
+	bool isWatchReplay() const { return m_watchReplay; }
+	bool isProfile() const { return m_profile; }
 };
 
 }} //namespaces
@@ -28,9 +28,11 @@
 #include "CmdArgs.h"
 #include "core_data.h"
 #include "version.h"
+#include "xml_parser.h"
 
 using namespace Shared::Platform;
 using namespace Shared::Util;
+using Shared::Xml::XmlIo;
 
 namespace Glest { namespace Main {
 
@@ -122,6 +124,9 @@ int glestMain(int argc, char** argv) {
 		// quick exit
 		return 0;
 	}
+	if (args.isProfile()) {
+		Profile::setEnabled(true);
+	}
 
 	string configDir = args.getConfigDir();
 	string dataDir = args.getDataDir();
@@ -150,10 +155,13 @@ int glestMain(int argc, char** argv) {
 	mkdir(configDir + "/addons/", true);
 	mkdir(configDir + "/screens/", true);
 	mkdir(configDir + "/savegames/", true);
+	mkdir(configDir + "/cache/", true);
+	mkdir(configDir + "/replays/", true);
 
 	try {
 		g_fileFactory.initPhysFS(argv[0], configDir, dataDir);
 		g_fileFactory.usePhysFS = true;
+		XmlIo::setCacheDir("cache/");
 	} catch (runtime_error &e) {
 		exceptionMessage(e);
 		return 0;
@@ -31,6 +31,8 @@
 #include "network_interface.h"
 #include "test_pane.h"
 #include "texture_gl.h"
+#include "benchmark.h"
+#include "replay.h"
 #include "leak_dumper.h"
 
 #include "interpolation.h"
@@ -112,6 +114,8 @@ Program::Program(CmdArgs &args)
 		, guiUpdateTimer(GameConstants::guiUpdatesPerSec, maxTimes, 10)
 		, simulationInterface(0)
 		, m_programState(0)
+		, m_benchmark(0)
+		, m_replay(0)
 		, crashed(false)
 		, terminating(false)
 		, visible(true)
@@ -123,8 +127,9 @@ Program::Program(CmdArgs &args)
 		keymap.save("keymap.ini");
 	}
 
-	{	ONE_TIME_TIMER(Init_Sound, cout);
-		// sound
+	// sound, not wanted when benchmarking (the sound renderer ignores calls without a player)
+	if (!cmdArgs.isTest("benchmark")) {
+		ONE_TIME_TIMER(Init_Sound, cout);
 		g_soundRenderer.init(this);
 	}
 
@@ -156,6 +161,7 @@ Program::~Program() {
 	Renderer::getInstance().end();
 	delete m_programState;
 	delete simulationInterface;
+	delete m_benchmark;
 	singleton = 0;
 }
 
@@ -213,8 +219,9 @@ bool Program::init() {
 			return false;
 		}
 
-	// load last game settings
-	} else if (cmdArgs.isLoadLastGame()) {
+	// load last game settings, for benchmarking with CPU players only
+	} else if (cmdArgs.isLoadLastGame() || cmdArgs.isTest("benchmark")) {
+		bool benchmark = cmdArgs.isTest("benchmark");
 		try {
 			Shared::Xml::XmlTree doc("game-settings");
 			doc.load("last_gamesettings.gs");
@@ -228,7 +235,15 @@ bool Program::init() {
 			// randomise factions that need it
 			vector<string> factionNames;
 			findAll(gs.getTechPath() + "/factions/*.", factionNames);
-			gs.randomiseFactions(factionNames);
+			gs.randomiseFactions(factionNames, benchmark ? Benchmark::seed : -1);
+			if (benchmark) {
+				for (int i=0; i < gs.getFactionCount(); ++i) {
+					if (gs.getFactionControl(i) == ControlType::HUMAN) {
+						gs.setFactionControl(i, ControlType::CPU);
+					}
+				}
+				simulationInterface->setAiSeed(Benchmark::seed);
+			}
 		} catch (runtime_error &e) {
 			std::stringstream ss;
 			ss << "Error trying to load last game-settings\nException: " << e.what();
@@ -237,7 +252,31 @@ bool Program::init() {
 			return false;
 		}
 		setState(new GameState(*this));
-	
+		if (benchmark) {
+			m_benchmark = new Benchmark(cmdArgs.getBenchmarkFrames());
+			m_benchmark->start();
+		}
+
+	// play a replay back, headless and as fast as possible unless watching it
+	} else if (!cmdArgs.getReplay().empty()) {
+		ReplayInterface *replay;
+		try {
+			replay = new ReplayInterface(*this, cmdArgs.getReplay(), cmdArgs.isWatchReplay());
+		} catch (runtime_error &e) {
+			std::stringstream ss;
+			ss << "Error trying to load replay '" << cmdArgs.getReplay() << "'\nException: " << e.what();
+			cout << ss.str();
+			g_logger.logError(ss.str());
+			return false;
+		}
+		setSimInterface(replay);
+		m_replay = replay;
+		setState(new GameState(*this));
+		if (!cmdArgs.isWatchReplay()) {
+			m_benchmark = new Benchmark(replay->getEndFrame());
+			m_benchmark->start();
+		}
+
 	} else if (cmdArgs.isTest("gui")) {
 		setState(new TestPane(*this));
 
@@ -256,6 +295,9 @@ void Program::setFpsCounterVisible(bool v) {
 }
 
 void Program::loop() {
+	if (m_benchmark) {
+		benchmarkLoop();
+	}
 	size_t sleepTime;
 
 	while (handleEvent() && !terminating) {
@@ -331,6 +373,28 @@ void Program::loop() {
 	terminating = true;
 }
 
+/** Update the world as fast as possible, skipping rendering, widget updates and the gui timers.
+  * Sound is never initialised in benchmark mode. The window and GL context are still created,
+  * loading a game uploads textures and models and World calls into the renderer and user
+  * interface; making those optional is a separate job. Returns to the normal loop if the game
+  * state is left (i.e. on a crash). */
+void Program::benchmarkLoop() {
+	while (!terminating && m_programState->isGameState()) {
+		if (!handleEvent()) {
+			terminating = true;
+			return;
+		}
+		m_programState->update();
+		if (m_benchmark->isDone()) {
+			m_benchmark->report(cout);
+			if (m_replay) {
+				m_replay->report(cout);
+			}
+			exit();
+		}
+	}
+}
+
 void Program::eventResize(SizeState sizeState) {
 	switch (sizeState) {
 		case ssMinimized:
@@ -436,6 +500,7 @@ bool Program::keyPress(char c) {
 void Program::setSimInterface(SimulationInterface *si) {
 	delete simulationInterface;
 	simulationInterface = si;
+	m_replay = 0;
 }
 
 void Program::setState(ProgramState *programState) try {
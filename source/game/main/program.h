@@ -27,6 +27,7 @@ using namespace Shared::Platform;
 using namespace Glest::Graphics;
 using namespace Glest::Global;
 using Glest::Sim::SimulationInterface;
+using Glest::Sim::ReplayInterface;
 using Glest::Gui::Keymap;
 
 namespace Glest { namespace Main {
@@ -35,6 +36,7 @@ using namespace Widgets;
 
 class Program;
 class MainWindow;
+class Benchmark;
 
 // =====================================================
 // 	class ProgramState
@@ -120,6 +122,8 @@ private:
 	StaticText *m_fpsLabel;
 
 	ProgramState *m_programState;
+	Benchmark *m_benchmark;	/**< non-zero when running '-test benchmark' or '-replay' */
+	ReplayInterface *m_replay;	/**< the simulationInterface when playing a replay, else null */
 	bool crashed;
 	bool terminating;
 	bool visible;
@@ -170,6 +174,7 @@ public:
 	void setState(ProgramState *programState);
 	void crash(const exception *e);
 	void loop();
+	void benchmarkLoop();
 	void exit();
 	void setMaxUpdateBacklog(int maxBacklog)	{updateTimer.setMaxBacklog(maxBacklog);}
 	void resetTimers();
@@ -27,6 +27,7 @@
 #include "socket.h"
 #include "menu_state_root.h"
 #include "FSFactory.hpp"
+#include "map_file.h"
 
 #include "leak_dumper.h"
 
@@ -44,37 +45,22 @@ namespace Glest { namespace Menu {
 // =====================================================
 
 void MapInfo::load(string file) {
-	struct MapFileHeader {
-		int32 version;
-		int32 maxPlayers;
-		int32 width;
-		int32 height;
-		int32 altFactor;
-		int32 waterLevel;
-		int8 title[128];
-	};
-
 	Lang &lang = Lang::getInstance();
 
 	try {
-		FileOps *f = FSFactory::getInstance()->getFileOps();
-		string path;
-		if (fileExists(file + ".mgm")) {
-			path = file + ".mgm";
-		} else {
-			path = file + ".gbm";
+		string path = MapFile::findFile(file);
+		if (path.empty()) {
+			throw runtime_error("Map file not found");
 		}
-		f->openRead(path.c_str());
-
-		MapFileHeader header;
-		f->read(&header, sizeof(MapFileHeader), 1);
+		MapFile mapFile;
+		mapFile.loadHeader(path);
+		const MapFileHeader &header = mapFile.header;
 		size.x = header.width;
 		size.y = header.height;
 		players = header.maxPlayers;
 		desc = lang.get("MaxPlayers") + ": " + intToStr(players) + "\n";
 		desc += lang.get("Size") + ": " + intToStr(size.x) + " x " + intToStr(size.y);
-		delete f;
-	} catch (exception e) {
+	} catch (exception &e) {
 		throw runtime_error("Error loading map file: " + file + '\n' + e.what());
 	}
 }
@@ -53,7 +53,12 @@ void SavedGamePreviewLoader::loadPreview(string *fileName) {
 	XmlNode *root = NULL;
 
 	try {
-		root = XmlIo::getInstance().load(*fileName);
+		// only the settings are needed, skip decoding the world if the save is binary
+		if (XmlIo::isBinary(*fileName)) {
+			root = XmlIo::getInstance().loadBinary(*fileName, "settings");
+		} else {
+			root = XmlIo::getInstance().load(*fileName);
+		}
 	} catch (exception &e) {
 		err = "Can't open game " + *fileName + ": " + e.what();
 	}
@@ -306,7 +311,11 @@ void MenuStateLoadGame::initGameInfo() {
 		gs = new GameSettings(savedGame->getChild("settings"));
 
 		///@todo track time properly?
-		int elapsedSeconds = savedGame->getChild("world")->getChildIntValue("frameCount") / WORLD_FPS;
+		int frameCount = savedGame->getOptionalIntAttribute("frameCount", -1);
+		if (frameCount == -1) {
+			frameCount = savedGame->getChild("world")->getChildIntValue("frameCount");
+		}
+		int elapsedSeconds = frameCount / WORLD_FPS;
 		int elapsedMinutes = elapsedSeconds / 60;
 		int elapsedHours = elapsedMinutes / 60;
 		elapsedSeconds = elapsedSeconds % 60;
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "random.h"
 #include "auto_test.h"
+#include "map_file.h"
 
 #include "leak_dumper.h"
 #include "sim_interface.h"
@@ -345,6 +346,10 @@ bool MenuStateNewGame::getMapList() {
 	foreach (vector<string>, it, results) {
 		mapFiles.insert(*it);
 	}
+	findAll("maps/*.gbmz", results, true, false);
+	foreach (vector<string>, it, results) {
+		mapFiles.insert(*it);
+	}
 	results.clear();
 	if (mapFiles.empty()) {
 		return false;
@@ -705,7 +710,7 @@ bool MenuStateNewGame::loadGameSettings() {
 	string mapFile = basename(gs.getMapPath());
 	
 	string mapPath = gs.getMapPath();
-	if (!fileExists(mapPath + ".gbm") && !fileExists(mapPath + ".mgm")) {
+	if (MapFile::findFile(mapPath).empty()) {
 		mapFile = "maps/" + m_mapFiles[0];
 		gs.setMapPath(mapFile);
 
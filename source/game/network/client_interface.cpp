@@ -44,7 +44,11 @@ namespace Glest { namespace Net {
 // =====================================================
 
 ClientInterface::ClientInterface(Program &prog)
-		: NetworkInterface(prog) {
+		: NetworkInterface(prog)
+		, m_networkStatus(int64(GameConstants::networkFramePeriod) * 1000000 / WORLD_FPS,
+			g_config.getNetKeyframeBuffer(), maxKeyFrameBuffer)
+		, m_gameStarted(false)
+		, m_catchingUp(false) {
 	clientSocket = NULL;
 	launchGame = false;
 	introDone = false;
@@ -57,6 +61,9 @@ ClientInterface::~ClientInterface() {
 	}
 	delete clientSocket;
 	clientSocket = NULL;
+	foreach (deque<RawMessage>, it, m_keyFrames) {
+		delete [] it->data;
+	}
 }
 
 void ClientInterface::connect(const Ip &ip, int port) {
@@ -192,7 +199,7 @@ void ClientInterface::sendTextMessage(const string &text, int teamIndex) {
 }
 
 string ClientInterface::getStatus() const {
-	return g_lang.get("Server") + ": " + serverName;
+	return g_lang.get("Server") + ": " + serverName + ", " + m_networkStatus.getDescription();
 }
 
 void ClientInterface::waitForMessage(int timeout) {
@@ -230,10 +237,14 @@ void ClientInterface::quitGame(QuitSource source) {
 
 void ClientInterface::startGame() {
 	NETWORK_LOG( __FUNCTION__ );
+	m_gameStarted = true;
 	updateKeyframe(0);
 }
 
 void ClientInterface::update() {
+	if (m_gameStarted) {
+		processMessages();
+	}
 	// chat messages
 	while (hasChatMsg()) {
 		Console *c = g_userInterface.getDialogConsole();
@@ -255,22 +266,15 @@ void ClientInterface::update() {
 	}
 }
 
-void ClientInterface::updateKeyframe(int frameCount) {
-	// give all commands from last KeyFrame
-	for (size_t i=0; i < keyFrame.getCmdCount(); ++i) {
-		pendingCommands.push_back(*keyFrame.getCmd(i));
-	}
-	while (true) {
-		waitForMessage();
+/** Move received messages to the keyframe buffer, process text and quit messages
+  * @return false if the server quit */
+bool ClientInterface::processMessages() {
+	receiveMessages();
+	while (hasMessage()) {
 		RawMessage raw = getNextMessage();
 		if (raw.type == MessageType::KEY_FRAME) {
-			keyFrame = KeyFrame(raw);
-			NETWORK_LOG( __FUNCTION__ << " received keyframe " << (keyFrame.getFrameCount() / GameConstants::networkFramePeriod)
-				<< " @ frame " << frameCount );
-			if (keyFrame.getFrameCount() != frameCount + GameConstants::networkFramePeriod) {
-				throw GameSyncError("frame count mismatch. Probable garbled message or memory corruption");
-			}
-			return;
+			m_keyFrames.push_back(raw);
+			m_networkStatus.keyFrameArrived(MsgHeader::headerSize + raw.size);
 		} else if (raw.type == MessageType::TEXT) {
 			TextMessage textMsg(raw);
 			NETWORK_LOG( "Received text message from server. Size: " << raw.size << " from: "
@@ -279,12 +283,84 @@ void ClientInterface::updateKeyframe(int frameCount) {
 		} else if (raw.type == MessageType::QUIT) {
 			NETWORK_LOG( "Received quit message from server." );
 			QuitMessage quitMsg(raw);
+			m_gameStarted = false;
 			quitGame(QuitSource::SERVER);
-			return;
+			return false;
 		} else {
 			throw InvalidMessage(MessageType::KEY_FRAME, raw.type);
 		}
 	}
+	return true;
+}
+
+/** Wait until count keyframes are buffered @return false if the server quit */
+bool ClientInterface::waitForKeyFrames(int count) {
+	Chrono chrono;
+	chrono.start();
+	while (m_keyFrames.size() < size_t(count)) {
+		if (!processMessages()) {
+			return false;
+		}
+		if (m_keyFrames.size() >= size_t(count)) {
+			break;
+		}
+		if (chrono.getMillis() > messageWaitTimeout) {
+			throw TimeOut(NetSource::SERVER);
+		}
+		sleep(2);
+	}
+	return true;
+}
+
+void ClientInterface::updateKeyframe(int frameCount) {
+	// the last keyframe was sent when the server reached this frame, check the worlds agree
+	if (frameCount && keyFrame.getWorldHash() != m_worldHash) {
+		NETWORK_LOG( __FUNCTION__ << " world hash mismatch @ frame " << frameCount << ", server "
+			<< intToHex(int32(keyFrame.getWorldHash())) << ", client " << intToHex(int32(m_worldHash)) );
+		throw GameSyncError("World state differs from the server's at frame " + intToStr(frameCount));
+	}
+	// give all commands from last KeyFrame
+	for (size_t i=0; i < keyFrame.getCmdCount(); ++i) {
+		pendingCommands.push_back(*keyFrame.getCmd(i));
+		recordCommand(*keyFrame.getCmd(i));
+	}
+	if (!processMessages()) {
+		return;
+	}
+	// the server runs ahead, at the start fill the buffer to the target depth, and if it has run
+	// dry refill it to a depth that covers the jitter seen, then drop the update backlog. Lag
+	// beyond the target depth (once it decays) is caught up by running faster, see below
+	if (frameCount == 0) {
+		if (!waitForKeyFrames(m_networkStatus.getTargetDepth())) {
+			return;
+		}
+	} else if (m_keyFrames.empty()) {
+		m_networkStatus.stallBegin();
+		NETWORK_LOG( __FUNCTION__ << " keyframe buffer empty @ frame " << frameCount
+			<< ", refilling to " << m_networkStatus.getTargetDepth() );
+		if (!waitForKeyFrames(m_networkStatus.getTargetDepth())) {
+			return;
+		}
+		m_networkStatus.stallEnd();
+		program.resetTimers();
+		m_catchingUp = false;
+	}
+	RawMessage raw = m_keyFrames.front();
+	m_keyFrames.pop_front();
+	m_networkStatus.keyFrameUsed();
+	if (m_networkStatus.isBehind() != m_catchingUp) {
+		m_catchingUp = !m_catchingUp;
+		program.setUpdateFps(m_catchingUp ? WORLD_FPS * (100 + NetworkStatus::catchUpRate) / 100 : WORLD_FPS);
+		NETWORK_LOG( __FUNCTION__ << (m_catchingUp ? " catching up" : " caught up") << " @ frame "
+			<< frameCount << ", " << m_keyFrames.size() << " buffered, target "
+			<< m_networkStatus.getTargetDepth() );
+	}
+	keyFrame = KeyFrame(raw);
+	NETWORK_LOG( __FUNCTION__ << " using keyframe " << (keyFrame.getFrameCount() / GameConstants::networkFramePeriod)
+		<< " @ frame " << frameCount << ", " << m_keyFrames.size() << " buffered" );
+	if (keyFrame.getFrameCount() != frameCount + GameConstants::networkFramePeriod) {
+		throw GameSyncError("frame count mismatch. Probable garbled message or memory corruption");
+	}
 }
 
 void ClientInterface::updateSkillCycle(Unit *unit) {
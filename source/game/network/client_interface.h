@@ -13,16 +13,19 @@
 #define _GLEST_GAME_CLIENTINTERFACE_H_
 
 #include <vector>
+#include <deque>
 #include <fstream>
 
 #include "network_interface.h"
+#include "network_status.h"
 #include "game_settings.h"
 
 #include "socket.h"
 
 using Shared::Platform::Ip;
 using Shared::Platform::ClientSocket;
-using std::vector; //using std::deque;
+using std::vector;
+using std::deque;
 
 namespace Glest { namespace Net {
 
@@ -34,6 +37,7 @@ class ClientInterface: public NetworkInterface {
 private:
 	static const int messageWaitTimeout = 10000; // 10 seconds
 	static const int waitSleepTime = 5; // 5 milli-seconds
+	static const int maxKeyFrameBuffer = 8;
 
 	ClientSocket *clientSocket;
 	string serverName;
@@ -41,6 +45,13 @@ private:
 	bool launchGame;
 	int playerIndex;
 
+	/** keyframes received and not yet used, in order. Filled by update() once the game has
+	  * started, so jitter in their arrival is absorbed rather than stalling the simulation */
+	deque<RawMessage> m_keyFrames;
+	NetworkStatus m_networkStatus;
+	bool m_gameStarted;
+	bool m_catchingUp;	/**< running faster than the server to use up surplus keyframes */
+
 public:
 	ClientInterface(Program &prog);
 	virtual ~ClientInterface();
@@ -96,6 +107,7 @@ public:
 	bool getLaunchGame() const				{return launchGame;}
 	bool getIntroDone() const				{return introDone;}
 	int getPlayerIndex() const				{return playerIndex;}
+	const NetworkStatus& getNetworkStatus() const	{return m_networkStatus;}
 
 	void connect(const Ip &ip, int port);
 	void reset();
@@ -106,6 +118,8 @@ public:
 
 private:
 	void waitForMessage(int timeout = messageWaitTimeout);
+	bool processMessages();
+	bool waitForKeyFrames(int count);
 
 	void doIntroMessage();
 	void doLaunchMessage();
@@ -555,52 +555,40 @@ void QuitMessage::send(NetworkConnection* connection) const {
 //	class KeyFrame
 // =====================================================
 
-#pragma pack(push, 1)
-struct KeyFrameMsgHeader {
-	uint8	cmdCount;
-	IF_MAD_SYNC_CHECKS(
-		uint16	checksumCount;
-	)
-	uint16 moveUpdateCount;
-	uint16 projUpdateCount;
-	uint16 updateSize;
-	int32 frame;
-
-};
-#pragma pack(pop)
-
 KeyFrame::KeyFrame(RawMessage raw) {
 	reset();
-	uint8 *ptr = raw.data;
-	KeyFrameMsgHeader header;
-	memcpy(&header, ptr, sizeof(KeyFrameMsgHeader));
-	ptr += sizeof(KeyFrameMsgHeader);
-
-	frame = header.frame;
+	const uint8 *ptr = raw.data, *end = raw.data + raw.size;
+	uint32 frameCount, cmdCount, updateSize, checksumCount = 0;
+	bool ok = readVarint(ptr, end, frameCount) && readVarint(ptr, end, cmdCount)
+		&& readVarint(ptr, end, updateSize);
 	IF_MAD_SYNC_CHECKS(
-		checksumCount = header.checksumCount;
+		ok = ok && readVarint(ptr, end, checksumCount);
 	)
-	moveUpdateCount = header.moveUpdateCount;
-	projUpdateCount = header.projUpdateCount;
-	updateSize = header.updateSize;
-	cmdCount = header.cmdCount;
-
-	NETWORK_LOG( "KeyFrame message size: " << raw.size << ", Move updates: " << moveUpdateCount
-		<< ", Projectile updates: " << projUpdateCount << ", Commands: " << cmdCount );
+	if (!ok || size_t(end - ptr) != sizeof(uint64) + checksumCount * sizeof(int32) + updateSize
+			+ cmdCount * sizeof(NetworkCommand)) {
+		delete raw.data;
+		throw GarbledMessage(MessageType::KEY_FRAME, NetSource::SERVER);
+	}
+	frame = frameCount;
+	messageSize = raw.size;
+	memcpy(&worldHash, ptr, sizeof(uint64));
+	ptr += sizeof(uint64);
 
 	IF_MAD_SYNC_CHECKS(
 		if (checksumCount) {
-			memcpy(checksums, ptr, checksumCount * sizeof(int32));
+			checksums.resize(checksumCount);
+			memcpy(&checksums[0], ptr, checksumCount * sizeof(int32));
 			ptr += checksumCount * sizeof(int32);
 		}
 	)
-	if (updateSize) {
-		memcpy(updateBuffer, ptr, updateSize);
-		ptr += updateSize;
-	}
+	updates.read(ptr, updateSize);
+	ptr += updateSize;
 	if (cmdCount) {
-		memcpy(commands, ptr, cmdCount * sizeof(NetworkCommand));
+		commands.resize(cmdCount);
+		memcpy(&commands[0], ptr, cmdCount * sizeof(NetworkCommand));
 	}
+	NETWORK_LOG( "KeyFrame message size: " << raw.size << ", Update bytes: " << updateSize
+		<< ", Commands: " << cmdCount );
 	delete raw.data;
 }
 
@@ -610,62 +598,45 @@ bool KeyFrame::receive(NetworkConnection* connection) {
 }
 
 void KeyFrame::send(NetworkConnection* connection) const {
-	MsgHeader msgHeader;
-	KeyFrameMsgHeader header;
-	msgHeader.messageType = MessageType::KEY_FRAME;
-	header.frame = this->frame;
-	header.cmdCount = this->cmdCount;
-	IF_MAD_SYNC_CHECKS(
-		header.checksumCount = this->checksumCount;
-	)
-	header.moveUpdateCount = this->moveUpdateCount;
-	header.projUpdateCount = this->projUpdateCount;
-	header.updateSize = this->updateSize;
+	vector<uint8> updateData;
+	updates.write(updateData);
 
-	size_t commandsSize = header.cmdCount * sizeof(NetworkCommand);
-	//size_t headerSize = sizeof(KeyFrameMsgHeader);
-	msgHeader.messageSize = sizeof(KeyFrameMsgHeader) + updateSize + commandsSize;
+	vector<uint8> buf(sizeof(MsgHeader));
+	writeVarint(buf, frame);
+	writeVarint(buf, commands.size());
+	writeVarint(buf, updateData.size());
 	IF_MAD_SYNC_CHECKS(
-		msgHeader.messageSize += checksumCount * sizeof(int32);
+		writeVarint(buf, checksums.size());
 	)
-	size_t totalSize = msgHeader.messageSize + sizeof(MsgHeader);
-
-	NETWORK_LOG( "KeyFrame message size: " << msgHeader.messageSize << ", Move updates: " 
-		<< moveUpdateCount << ", Projectile updates: " << projUpdateCount
-		<< ", Commands: " << cmdCount );
-
-	uint8 *buf = new uint8[totalSize];
-	uint8 *ptr = buf;
-	memcpy(ptr, &msgHeader, sizeof(MsgHeader));
-	ptr += sizeof(MsgHeader);
-	memcpy(ptr, &header, sizeof(KeyFrameMsgHeader));
-	ptr += sizeof(KeyFrameMsgHeader);
+	const uint8 *hash = reinterpret_cast<const uint8*>(&worldHash);
+	buf.insert(buf.end(), hash, hash + sizeof(uint64));
 	IF_MAD_SYNC_CHECKS(
-		if (checksumCount) {
-			memcpy(ptr, checksums, checksumCount * sizeof(int32));
-			ptr += checksumCount * sizeof(int32);
+		if (!checksums.empty()) {
+			const uint8 *bytes = reinterpret_cast<const uint8*>(&checksums[0]);
+			buf.insert(buf.end(), bytes, bytes + checksums.size() * sizeof(int32));
 		}
 	)
-	if (updateSize) {
-		memcpy(ptr, updateBuffer, updateSize);
-		ptr += updateSize;
-	}
-	if (commandsSize) {
-		memcpy(ptr, commands, commandsSize);
+	buf.insert(buf.end(), updateData.begin(), updateData.end());
+	if (!commands.empty()) {
+		const uint8 *bytes = reinterpret_cast<const uint8*>(&commands[0]);
+		buf.insert(buf.end(), bytes, bytes + commands.size() * sizeof(NetworkCommand));
 	}
-	try {
-		Message::send(connection, buf, totalSize);
-	} catch (...) {
-		delete [] buf;
-		throw;
-	}
-	delete [] buf;
+	MsgHeader msgHeader;
+	msgHeader.messageType = MessageType::KEY_FRAME;
+	msgHeader.messageSize = buf.size() - sizeof(MsgHeader);
+	memcpy(&buf[0], &msgHeader, sizeof(MsgHeader));
+
+	NETWORK_LOG( "KeyFrame message size: " << msgHeader.messageSize << ", Updates: "
+		<< updates.getUpdateCount() << " in " << updateData.size() << " bytes, Commands: "
+		<< commands.size() );
+
+	Message::send(connection, &buf[0], buf.size());
 }
 
 #if MAD_SYNC_CHECKING
 
 int32 KeyFrame::getNextChecksum() {
-	if (checksumCounter >= checksumCount) {
+	if (checksumCounter >= checksums.size()) {
 		NETWORK_LOG( "Attempt to retrieve checksum #" << checksumCounter
 			<< ", Insufficient checksums in keyFrame. Sync Error."
 		);
@@ -675,69 +646,54 @@ int32 KeyFrame::getNextChecksum() {
 }
 
 void KeyFrame::addChecksum(int32 cs) {
-	if (checksumCount >= max_checksums) {
-		throw runtime_error("Error: insufficient room for checksums in keyframe, increase KeyFrame::max_checksums.");
-	}
-	checksums[checksumCount++] = cs;
+	checksums.push_back(cs);
 }
 
 #endif
 
 void KeyFrame::add(NetworkCommand &nc) {
-	assert(cmdCount < max_cmds);
-	memcpy(&commands[cmdCount++], &nc, sizeof(NetworkCommand));
+	commands.push_back(nc);
 }
 
 void KeyFrame::reset() {
+	worldHash = 0;
 	IF_MAD_SYNC_CHECKS(
-		checksumCounter = checksumCount = 0;
+		checksums.clear();
+		checksumCounter = 0;
 	)
-	projUpdateCount = moveUpdateCount = cmdCount = 0;
-	updateSize = 0;
-	writePtr = updateBuffer;
-	readPtr = updateBuffer;
+	updates.clear();
+	commands.clear();
+	messageSize = 0;
 }
 
 void KeyFrame::addUpdate(MoveSkillUpdate updt) {
-//	assert(writePtr < &updateBuffer[buffer_size - 2]);
-	memcpy(writePtr, &updt, sizeof(MoveSkillUpdate));
-	writePtr += sizeof(MoveSkillUpdate);
-	updateSize += sizeof(MoveSkillUpdate);
-	++moveUpdateCount;
+	updates.addMove(updt.offsetX, updt.offsetY, updt.end_offset);
 	NETWORK_LOG( __FUNCTION__ << "(MoveSkillUpdate updt): Pos Offset:" << updt.posOffset()
 		<< " Frame Offset: " << updt.end_offset );
 }
 
 void KeyFrame::addUpdate(ProjectileUpdate updt) {
-//	assert(writePtr < &updateBuffer[buffer_size - 1]);
-	memcpy(writePtr, &updt, sizeof(ProjectileUpdate));
-	writePtr += sizeof(ProjectileUpdate);
-	updateSize += sizeof(ProjectileUpdate);
-	++projUpdateCount;
+	updates.addProjectile(updt.end_offset);
 	NETWORK_LOG( __FUNCTION__ << "(ProjectileUpdate updt): Frame Offset: " << int(updt.end_offset) );
 }
 
 MoveSkillUpdate KeyFrame::getMoveUpdate() {
-	assert(readPtr < updateBuffer + updateSize - 1);
-	if (!moveUpdateCount) {
+	int x, y, endOffset;
+	if (!updates.getMove(x, y, endOffset)) {
 		throw GameSyncError("Insufficient move skill updates in keyframe");
 	}
-	MoveSkillUpdate res(readPtr);
-	readPtr += sizeof(MoveSkillUpdate);
-	--moveUpdateCount;
+	MoveSkillUpdate res(x, y, endOffset);
 	NETWORK_LOG( __FUNCTION__ << "(): Pos Offset:" << res.posOffset()
 		<< " Frame Offset: " << int(res.end_offset) );
 	return res;
 }
 
 ProjectileUpdate KeyFrame::getProjUpdate() {
-	assert(readPtr < updateBuffer + updateSize);
-	if (!projUpdateCount) {
+	int endOffset;
+	if (!updates.getProjectile(endOffset)) {
 		throw GameSyncError("Insufficient projectile updates in keyframe");
 	}
-	ProjectileUpdate res(readPtr);
-	readPtr += sizeof(ProjectileUpdate);
-	--projUpdateCount;
+	ProjectileUpdate res(endOffset);
 	NETWORK_LOG( __FUNCTION__ << "(): Frame Offset: " << int(res.end_offset) );
 	return res;
 }
@@ -15,6 +15,7 @@
 #include "socket.h"
 #include "game_constants.h"
 #include "network_types.h"
+#include "update_buffer.h"
 #include "checksum.h"
 
 #include <map>
@@ -329,30 +330,22 @@ public:
 // =====================================================
 //	class KeyFrame
 // =====================================================
+/** The commands and updates for a keyframe period. Sent as varints for the frame and counts,
+  * the world hash, the checksums, the packed updates (see UpdateBuffer) and the commands. Buffers
+  * grow as needed, there is no limit on the updates or commands a keyframe can carry. */
 class KeyFrame : public Message {
 private:
-	static const int buffer_size = 1024 * 4;
-	static const int max_cmds = 512;
-	static const int max_checksums = 2048;
-	typedef uint8* byte_ptr;
-
 	int32	frame;
+	uint64	worldHash;	/**< the server's SimulationInterface::getWorldHash() at frame */
 
 	IF_MAD_SYNC_CHECKS(
-		int32	checksums[max_checksums];
-		int32	checksumCount;
-		uint32	checksumCounter;
+		vector<int32> checksums;
+		size_t	checksumCounter;
 	)
 
-	uint8	 updateBuffer[buffer_size];
-	size_t	 updateSize;
-	uint32	 projUpdateCount;
-	uint32	 moveUpdateCount;
-	byte_ptr writePtr;
-	byte_ptr readPtr;
-
-	NetworkCommand commands[max_cmds];
-	size_t cmdCount;
+	UpdateBuffer updates;
+	vector<NetworkCommand> commands;
+	size_t	messageSize;	/**< size received, 0 if built locally */
 
 public:
 	KeyFrame()		{ reset(); }
@@ -363,9 +356,12 @@ public:
 
 	void setFrameCount(int fc) { frame = fc; }
 	int getFrameCount() const { return frame; }
+	void setWorldHash(uint64 hash) { worldHash = hash; }
+	uint64 getWorldHash() const { return worldHash; }
 
-	const size_t& getCmdCount() const	{ return cmdCount; }
+	size_t getCmdCount() const	{ return commands.size(); }
 	const NetworkCommand* getCmd(size_t ndx) const { return &commands[ndx]; }
+	size_t getMessageSize() const	{ return messageSize; }
 
 	IF_MAD_SYNC_CHECKS(
 		int32 getNextChecksum();
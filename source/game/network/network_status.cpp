@@ -12,62 +12,93 @@
 #include "pch.h"
 #include "network_status.h"
 #include <sstream>
-#include "math_util.h"
+#include <algorithm>
+#include <cassert>
+#include "util.h"
 
 #include "leak_dumper.h"
 
 namespace Glest { namespace Net {
 
-#if 0 // Not currently in use
+using std::stringstream;
+using Shared::Util::clamp;
 
 // =====================================================
 //	class NetworkStatus
 // =====================================================
 
-void NetworkStatus::pong(int64 departureTime, int64 remoteTime, int64 arrivalTime) {
-	latency = (arrivalTime - departureTime);
-	pingTimes.push_back(latency);
-	while(pingTimes.size() > pingHistorySize) {
-		pingTimes.pop_front();
+NetworkStatus::NetworkStatus(int64 period, int minDepth, int maxDepth)
+		: m_period(period)
+		, m_minDepth(minDepth)
+		, m_maxDepth(maxDepth)
+		, m_targetDepth(minDepth)
+		, m_depth(0)
+		, m_lastArrival(-1)
+		, m_jitter(0)
+		, m_stallStart(-1)
+		, m_lastStall(0)
+		, m_lastTargetChange(-1)
+		, m_totalStall(0)
+		, m_stallCount(0)
+		, m_keyFrameCount(0)
+		, m_lastSize(0)
+		, m_totalSize(0) {
+	assert(period > 0 && minDepth > 0 && maxDepth >= minDepth);
+}
+
+int NetworkStatus::getNeededDepth() const {
+	int64 cover = m_jitter * jitterCover;
+	int depth = 1 + int((cover + m_period - 1) / m_period);
+	return clamp(depth, m_minDepth, m_maxDepth);
+}
+
+void NetworkStatus::keyFrameArrived(int size, int64 time) {
+	if (m_lastArrival != -1) {
+		int64 deviation = time - m_lastArrival - m_period;
+		if (deviation < 0) {
+			deviation = -deviation;
+		}
+		m_jitter += (deviation - m_jitter) / 16;
 	}
-	int64 totalPingTime = 0;
-	for(deque<int64>::const_iterator i = pingTimes.begin(); i != pingTimes.end(); ++i) {
-		totalPingTime += *i;
+	if (m_lastTargetChange == -1) {
+		m_lastTargetChange = time;
+	} else if (m_stallStart == -1 && time - m_lastTargetChange >= decayTime) {
+		// a long spell without stalls, the link may have settled so try a shallower buffer
+		if (m_targetDepth > getNeededDepth()) {
+			--m_targetDepth;
+		}
+		m_lastTargetChange = time;
 	}
-	avgLatency = totalPingTime / pingTimes.size();
-	//timeDiffs.push_back(remoteTime - departureTime - latency / 2);
-	updateStatusStr();
+	m_lastArrival = time;
+	++m_depth;
+	++m_keyFrameCount;
+	m_lastSize = size;
+	m_totalSize += size;
 }
 
-static inline void prettyBytes(stringstream &str, float bytes) {
-	if(bytes < 1024.f) {
-		str << (size_t)roundf(bytes);
-	} else {
-		str << roundf(bytes / 100.f) / 10.f << "k";
-	}
+void NetworkStatus::stallBegin(int64 time) {
+	assert(m_stallStart == -1);
+	m_stallStart = time;
+	m_targetDepth = std::max(getNeededDepth(), std::min(m_targetDepth + 1, m_maxDepth));
 }
 
-void NetworkStatus::updateStatusStr() {
-	stringstream str;
-	str << (latency / 1000) << " (" << (avgLatency / 1000) << ") Tx/Rx ";
-	prettyBytes(str, txBytesPerSecond);
-	str << "/";
-	prettyBytes(str, rxBytesPerSecond);
-	statusStr = str.str();
+void NetworkStatus::stallEnd(int64 time) {
+	assert(m_stallStart != -1);
+	m_lastStall = time - m_stallStart;
+	m_totalStall += m_lastStall;
+	++m_stallCount;
+	m_stallStart = -1;
+	m_lastTargetChange = time;
 }
 
-void NetworkStatus::update() {
-	int64 curTime = Chrono::getCurMicros();
-	if(curTime >= lastUpdate + updateInterval) {
-		lastUpdate = curTime;
-		ping();
-		dataSent.clean();
-		dataRecieved.clean();
-		txBytesPerSecond = dataSent.getBytesPerSecond();
-		rxBytesPerSecond = dataRecieved.getBytesPerSecond();
-		updateStatusStr();
-	}
+string NetworkStatus::getDescription() const {
+	stringstream str;
+	str << m_depth << "/" << m_targetDepth << " keyframes buffered, jitter " << (m_jitter / 1000)
+		<< "ms, " << m_stallCount << " stalls (last " << (m_lastStall / 1000) << "ms, total "
+		<< (m_totalStall / 1000) << "ms), " << m_lastSize << " bytes a keyframe (average "
+		<< getAverageSize() << ")";
+	return str.str();
 }
-#endif
+
 
 }}//end namespace
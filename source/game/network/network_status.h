@@ -13,9 +13,6 @@
 #ifndef _GLEST_GAME_NETWORKSTATUS_H_
 #define _GLEST_GAME_NETWORKSTATUS_H_
 
-#include <string>
-#include <vector>
-#include <queue>
 #include <string>
 
 #include "timer.h"
@@ -23,96 +20,77 @@
 
 using Shared::Platform::Chrono;
 using Shared::Platform::int64;
+using std::string;
 
 namespace Glest { namespace Net {
 
-#if 0 // Not currently in use
+// =====================================================
+//	class NetworkStatus
+// =====================================================
+/** Keyframe arrival statistics for a network client, and the depth of keyframe buffer they call
+  * for. The server never waits for clients, so a client that keeps depth keyframes buffered runs
+  * that many keyframe periods behind it, and only stalls if a keyframe is later than that.
+  * Jitter is the deviation of keyframe arrival intervals from the keyframe period, smoothed as in
+  * RFC 3550. All times are in microseconds. The size of keyframes is also kept, to report the
+  * bandwidth they use. */
 class NetworkStatus {
 public:
-	class DataInfo {		
-		class Item {
-			int64 time;
-			size_t size;
-	
-		public:
-			Item(size_t size) : time(Chrono::getCurMicros()), size(size) {}
-			// allow default copy ctor
-			int64 getTime() const					{return time;}
-			size_t getSize() const					{return size;}
-			bool isOlderThan(int64 refTime) const	{return time < refTime;}
-		};
-		
-		int64 maxAge;
-		queue<Item> q;
-		int64 lastCleaned;
-		size_t size;
-
-	public:
-		DataInfo(int64 maxAge) : maxAge(maxAge), q(), lastCleaned(-1), size(0) {}
-		size_t getSize() const	{return size;}
-
-		void add(size_t size) {
-			q.push(Item(size));
-			this->size += size;
-		}
-
-		void clean() {
-			lastCleaned = Chrono::getCurMicros();
-			int64 refTime = lastCleaned - maxAge;
-			while(!q.empty() && q.front().isOlderThan(refTime)) {
-				size -= q.front().getSize();
-				q.pop();
-			}
-		}
-
-		float getBytesPerSecond() const {
-			int64 now = Chrono::getCurMicros();
-			int64 age = now - lastCleaned + maxAge;
-			return (float)size / (float)age * 1000000.f;
-		}
-	};
+	/** stall free time after which the target depth is lowered by one, toward the needed depth */
+	static const int64 decayTime = 30000000;
+	/** percentage faster than the server a client runs while it is behind (see isBehind()) */
+	static const int catchUpRate = 25;
 
 private:
-	DataInfo dataSent;
-	DataInfo dataRecieved;
-	float txBytesPerSecond;
-	float rxBytesPerSecond;
-	int64 updateInterval;
-	int64 lastUpdate;
-	int64 latency;
-	int64 avgLatency;
-	string statusStr;
-	deque<int64> pingTimes;
-	//deque<int64> timeDiffs;
-
-	static const int pingHistorySize = 10;
+	static const int jitterCover = 4;	/**< multiple of the smoothed jitter the buffer should cover */
+
+	int64 m_period;			/**< time between keyframes */
+	int m_minDepth;
+	int m_maxDepth;
+	int m_targetDepth;
+	int m_depth;			/**< keyframes currently buffered */
+	int64 m_lastArrival;
+	int64 m_jitter;
+	int64 m_stallStart;		/**< -1 when not stalled */
+	int64 m_lastStall;
+	int64 m_lastTargetChange;	/**< end of the last stall, or last decay of the target depth */
+	int64 m_totalStall;
+	int m_stallCount;
+	int m_keyFrameCount;
+	int m_lastSize;			/**< bytes in the last keyframe */
+	int64 m_totalSize;
 
 public:
-	NetworkStatus(int64 updateInterval = 1000000, int64 throughputHistory = 5000000) :
-			dataSent(throughputHistory),
-			dataRecieved(throughputHistory),
-			updateInterval(updateInterval),
-			lastUpdate(-1),
-			latency(-1) {
-	}
-
-	int64 getLastUpdate() const					{return lastUpdate;}
-	int64 getLatency() const					{return latency;}
-	int64 getAvgLatency() const					{return avgLatency;}
-	void addDataSent(size_t bytes)				{dataSent.add(bytes);}
-	void addDataRecieved(size_t bytes)			{dataRecieved.add(bytes);}
-	virtual string getStatus() const			{return statusStr;}
-	virtual bool isConnected() = 0;
-	virtual void update(); 
-
-protected:
-	virtual void ping() = 0;
-	void pong(int64 departureTime, int64 remoteTime, int64 arrivalTime = Chrono::getCurMicros());
-
-private:
-	void updateStatusStr();
+	NetworkStatus(int64 period, int minDepth, int maxDepth);
+
+	int getDepth() const				{return m_depth;}
+	int getTargetDepth() const			{return m_targetDepth;}
+	int64 getJitter() const				{return m_jitter;}
+	int64 getLastStall() const			{return m_lastStall;}
+	int64 getTotalStall() const			{return m_totalStall;}
+	int getStallCount() const			{return m_stallCount;}
+	int getLastSize() const				{return m_lastSize;}
+	int getAverageSize() const			{return m_keyFrameCount ? int(m_totalSize / m_keyFrameCount) : 0;}
+	bool isStalled() const				{return m_stallStart != -1;}
+	/** @return true if more keyframes are buffered than the target depth calls for, the client
+	  * is further behind the server than it needs to be and should run faster until it is not */
+	bool isBehind() const				{return m_depth > m_targetDepth;}
+	string getDescription() const;
+
+	/** the depth the measured jitter calls for, within the configured limits */
+	int getNeededDepth() const;
+
+	/** a keyframe has been received, if there has been no stall for decayTime the target depth is
+	  * lowered by one (but not below the needed depth) */
+	void keyFrameArrived(int size, int64 time = Chrono::getCurMicros());
+	void keyFrameUsed()					{--m_depth;}
+
+	/** the buffer ran dry and the simulation is waiting for it to refill, the target depth is
+	  * raised to what the jitter calls for, and at least by one as it wasn't enough */
+	void stallBegin(int64 time = Chrono::getCurMicros());
+	/** the buffer has refilled to the target depth */
+	void stallEnd(int64 time = Chrono::getCurMicros());
 };
-#endif
+
 }}//end namespace
 
 #endif
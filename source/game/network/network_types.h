@@ -244,7 +244,7 @@ WRAPPED_ENUM( NetworkCommandType,
 		int16	end_offset	: 12; // max 4095
 
 		MoveSkillUpdate(const Unit *unit);
-		MoveSkillUpdate(const uint8 *ptr) { *this = *((MoveSkillUpdate*)ptr); }
+		MoveSkillUpdate(int x, int y, int endOffset) : offsetX(x), offsetY(y), end_offset(endOffset) {}
 		Vec2i posOffset() const { return Vec2i(offsetX, offsetY); }
 	};
 #pragma pack(pop)
@@ -253,7 +253,7 @@ WRAPPED_ENUM( NetworkCommandType,
 	struct ProjectileUpdate {
 		uint8 end_offset	:  8;
 		ProjectileUpdate(const Unit *unit, Projectile *pps);
-		ProjectileUpdate(const uint8 *ptr) { *this = *((ProjectileUpdate*)ptr); }
+		ProjectileUpdate(int endOffset) : end_offset(endOffset) {}
 	}; // 2 bytes
 #pragma pack(pop)
 
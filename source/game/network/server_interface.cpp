@@ -328,9 +328,11 @@ void ServerInterface::updateKeyframe(int frameCount) {
 	while (!requestedCommands.empty()) {
 		keyFrame.add(requestedCommands.back());
 		pendingCommands.push_back(requestedCommands.back());
+		recordCommand(requestedCommands.back());
 		requestedCommands.pop_back();
 	}
 	keyFrame.setFrameCount(frameCount);
+	keyFrame.setWorldHash(m_worldHash);
 	broadcastMessage(&keyFrame);
 	
 	keyFrame.reset();
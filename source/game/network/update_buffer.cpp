@@ -0,0 +1,133 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "update_buffer.h"
+
+#include <cassert>
+
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Net {
+
+using Shared::Util::writeVarint;
+using Shared::Util::readVarint;
+using Shared::Util::zigzag;
+using Shared::Util::unzigzag;
+
+// =====================================================
+//	class UpdateBuffer
+// =====================================================
+
+void UpdateBuffer::clear() {
+	m_data.clear();
+	m_writeRun = Run();
+	m_lastEnd[MOVE] = m_lastEnd[PROJECTILE] = 0;
+	m_updateCount = 0;
+	m_readPos = 0;
+	m_readRun = Run();
+	m_readEnd[MOVE] = m_readEnd[PROJECTILE] = 0;
+}
+
+void UpdateBuffer::flushRun(vector<uint8> &out, const Run &run, const int *lastEnd) const {
+	writeVarint(out, uint32(run.count - 1) << 1 | run.kind);
+	uint32 delta = zigzag(run.end - lastEnd[run.kind]);
+	writeVarint(out, run.kind == MOVE ? delta * 9 + run.dir : delta);
+}
+
+void UpdateBuffer::add(int kind, int dir, int end) {
+	Run &run = m_writeRun;
+	if (run.kind == kind && run.dir == dir && run.end == end) {
+		++run.count;
+	} else {
+		if (run.kind != -1) {
+			flushRun(m_data, run, m_lastEnd);
+			m_lastEnd[run.kind] = run.end;
+		}
+		run.kind = kind;
+		run.count = 1;
+		run.dir = dir;
+		run.end = end;
+	}
+	++m_updateCount;
+}
+
+void UpdateBuffer::addMove(int offsetX, int offsetY, int endOffset) {
+	assert(offsetX >= -1 && offsetX <= 1 && offsetY >= -1 && offsetY <= 1);
+	add(MOVE, (offsetX + 1) * 3 + offsetY + 1, endOffset);
+}
+
+void UpdateBuffer::addProjectile(int endOffset) {
+	add(PROJECTILE, 0, endOffset);
+}
+
+void UpdateBuffer::write(vector<uint8> &out) const {
+	out.insert(out.end(), m_data.begin(), m_data.end());
+	if (m_writeRun.kind != -1) {
+		flushRun(out, m_writeRun, m_lastEnd);
+	}
+}
+
+void UpdateBuffer::read(const uint8 *data, size_t size) {
+	clear();
+	m_data.assign(data, data + size);
+}
+
+/** make sure the read run has an update of a kind left, reading the next run if it's used up */
+bool UpdateBuffer::nextRun(int kind) {
+	Run &run = m_readRun;
+	if (!run.count) {
+		if (m_readPos == m_data.size()) {
+			return false;
+		}
+		const uint8 *ptr = &m_data[m_readPos], *end = &m_data[0] + m_data.size();
+		uint32 header, record;
+		if (!readVarint(ptr, end, header) || !readVarint(ptr, end, record)) {
+			return false;
+		}
+		m_readPos = ptr - &m_data[0];
+		run.kind = header & 1;
+		run.count = (header >> 1) + 1;
+		if (run.kind == MOVE) {
+			run.dir = record % 9;
+			record /= 9;
+		}
+		run.end = m_readEnd[run.kind] + unzigzag(record);
+		m_readEnd[run.kind] = run.end;
+	}
+	if (run.kind != kind) {
+		return false;
+	}
+	--run.count;
+	return true;
+}
+
+bool UpdateBuffer::getMove(int &out_offsetX, int &out_offsetY, int &out_endOffset) {
+	if (!nextRun(MOVE)) {
+		return false;
+	}
+	out_offsetX = m_readRun.dir / 3 - 1;
+	out_offsetY = m_readRun.dir % 3 - 1;
+	out_endOffset = m_readRun.end;
+	return true;
+}
+
+bool UpdateBuffer::getProjectile(int &out_endOffset) {
+	if (!nextRun(PROJECTILE)) {
+		return false;
+	}
+	out_endOffset = m_readRun.end;
+	return true;
+}
+
+}}//end namespace
@@ -0,0 +1,83 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_UPDATEBUFFER_H_
+#define _GLEST_GAME_UPDATEBUFFER_H_
+
+#include <vector>
+
+#include "types.h"
+
+namespace Glest { namespace Net {
+
+using std::vector;
+using Shared::Platform::uint8;
+using Shared::Platform::uint32;
+
+// =====================================================
+//	class UpdateBuffer
+// =====================================================
+/** The move and projectile updates of a keyframe, in the order the server made them, packed.
+  *
+  * Consecutive identical updates are a run, each run is a varint header, (count - 1) << 1 | kind,
+  * and one record. A move record is a varint of the zigzagged difference of its end frame offset
+  * from the last move record's, times 9, plus the position offset as 0 to 8. A projectile record
+  * is a varint of the zigzagged difference from the last projectile record's end frame offset.
+  * Units on the same move skill moving the same way take a byte or two per run. */
+class UpdateBuffer {
+private:
+	enum Kind { MOVE, PROJECTILE };
+
+	struct Run {
+		int kind;	/**< a Kind, -1 for none */
+		int count;
+		int dir;	/**< move only, (x + 1) * 3 + y + 1 */
+		int end;
+		Run() : kind(-1), count(0), dir(0), end(0) {}
+	};
+
+	vector<uint8> m_data;	/**< complete runs */
+	Run m_writeRun;			/**< the run being added to, not yet in m_data */
+	int m_lastEnd[2];		/**< last end frame offset written, by kind */
+	int m_updateCount;
+
+	size_t m_readPos;
+	Run m_readRun;
+	int m_readEnd[2];
+
+	void flushRun(vector<uint8> &out, const Run &run, const int *lastEnd) const;
+	bool nextRun(int kind);
+	void add(int kind, int dir, int end);
+
+public:
+	UpdateBuffer() { clear(); }
+
+	void clear();
+
+	void addMove(int offsetX, int offsetY, int endOffset);
+	void addProjectile(int endOffset);
+
+	/** @return false if the next update isn't a move, or there are none */
+	bool getMove(int &out_offsetX, int &out_offsetY, int &out_endOffset);
+	/** @return false if the next update isn't a projectile, or there are none */
+	bool getProjectile(int &out_endOffset);
+
+	int getUpdateCount() const		{return m_updateCount;}
+
+	/** write the packed updates, including the current run */
+	void write(vector<uint8> &out) const;
+	/** set the packed updates to read from, written by write() */
+	void read(const uint8 *data, size_t size);
+};
+
+}}//end namespace
+
+#endif
@@ -0,0 +1,131 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "asset_loader.h"
+
+#include <cassert>
+
+#include "platform_util.h"
+#include "sound_file_loader.h"
+#include "renderer.h"
+#include "logger.h"
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace ProtoTypes {
+
+using Shared::Sound::SoundFileLoaderFactory;
+using Shared::Util::mediaErrorLog;
+using Shared::Util::MediaErrorLog;
+using Glest::Util::ProgramLog;
+using Graphics::Renderer;
+using Graphics::ResourceScope;
+
+// =====================================================
+//	class AssetLoader
+// =====================================================
+
+void AssetLoader::ModelTask::execute() {
+	model->read(path);
+}
+
+void AssetLoader::SoundTask::execute() {
+	try {
+		sound->load(path);
+	} catch (runtime_error &e) {
+		error = e.what();
+	}
+}
+
+AssetLoader::~AssetLoader() {
+	if (m_pool) {
+		// abandoned by an exception, let the tasks finish before they're deleted
+		m_pool->wait();
+		deleteValues(m_modelTasks.begin(), m_modelTasks.end());
+		deleteValues(m_soundTasks.begin(), m_soundTasks.end());
+		delete m_pool;
+	}
+}
+
+void AssetLoader::begin() {
+	assert(!m_pool);
+	// make sure the sound loader singleton is constructed on this thread
+	SoundFileLoaderFactory::getInstance();
+	m_pool = new WorkerPool(getProcessorCount() - 1);
+}
+
+bool AssetLoader::end() {
+	assert(m_pool);
+	ProgramLog &log = g_logger.getProgramLog();
+	g_logger.logProgramEvent("Loading models and sounds", true);
+	m_pool->wait();
+
+	bool loadOk = true;
+	foreach (SoundTasks, it, m_soundTasks) {
+		if (!(*it)->error.empty()) {
+			g_logger.logMediaError("", (*it)->path, (*it)->error.c_str());
+			loadOk = false;
+		}
+		log.unitLoaded();
+		delete *it;
+	}
+	m_soundTasks.clear();
+
+	vector<string> texturePaths;
+	foreach (ModelTasks, it, m_modelTasks) {
+		(*it)->model->getTexturePaths(texturePaths);
+	}
+	g_renderer.preloadTextures(ResourceScope::GAME, texturePaths, *m_pool);
+
+	int progress = log.getProgress();
+	foreach (ModelTasks, it, m_modelTasks) {
+		(*it)->model->upload((*it)->size, (*it)->height);
+		while (mediaErrorLog.hasError()) {
+			MediaErrorLog::ErrorRecord record = mediaErrorLog.popError();
+			g_logger.logMediaError("", record.path, record.msg.c_str());
+		}
+		log.unitLoaded();
+		if (log.getProgress() != progress) {
+			progress = log.getProgress();
+			log.renderLoadingScreen();
+		}
+		delete *it;
+	}
+	m_modelTasks.clear();
+
+	delete m_pool;
+	m_pool = 0;
+	return loadOk;
+}
+
+void AssetLoader::loadModel(Model *model, const string &path, int size, int height) {
+	if (!m_pool) {
+		model->load(path, size, height);
+		return;
+	}
+	m_modelTasks.push_back(new ModelTask(model, path, size, height));
+	m_pool->add(m_modelTasks.back());
+	g_logger.getProgramLog().addUnitCount(1);
+}
+
+void AssetLoader::loadSound(StaticSound *sound, const string &path) {
+	if (!m_pool) {
+		sound->load(path);
+		return;
+	}
+	m_soundTasks.push_back(new SoundTask(sound, path));
+	m_pool->add(m_soundTasks.back());
+	g_logger.getProgramLog().addUnitCount(1);
+}
+
+}}
@@ -0,0 +1,87 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_ASSETLOADER_H_
+#define _GLEST_GAME_ASSETLOADER_H_
+
+#include <string>
+#include <vector>
+
+#include "model.h"
+#include "sound.h"
+#include "worker_pool.h"
+
+namespace Glest { namespace ProtoTypes {
+
+using std::string;
+using std::vector;
+using Shared::Graphics::Model;
+using Shared::Sound::StaticSound;
+using Shared::Platform::Task;
+using Shared::Platform::WorkerPool;
+
+// =====================================================
+//	class AssetLoader
+// =====================================================
+/** Loads models and sounds for the prototypes. Between begin() and end() loads are queued and
+  * files are read and decoded on a worker pool while the types carry on loading, end() then
+  * loads the textures the models use on the pool and does the GL uploads on the main thread.
+  * Outside begin() and end() loads are done immediately. */
+class AssetLoader {
+private:
+	class ModelTask : public Task {
+	public:
+		Model *model;
+		string path;
+		int size, height;
+
+		ModelTask(Model *model, const string &path, int size, int height)
+			: model(model), path(path), size(size), height(height) {}
+		virtual void execute() override;
+	};
+
+	class SoundTask : public Task {
+	public:
+		StaticSound *sound;
+		string path;
+		string error;	/**< set if the sound could not be loaded */
+
+		SoundTask(StaticSound *sound, const string &path) : sound(sound), path(path) {}
+		virtual void execute() override;
+	};
+
+	typedef vector<ModelTask*> ModelTasks;
+	typedef vector<SoundTask*> SoundTasks;
+
+private:
+	WorkerPool *m_pool;		/**< non-null between begin() and end() */
+	ModelTasks m_modelTasks;
+	SoundTasks m_soundTasks;
+
+public:
+	AssetLoader() : m_pool(0) {}
+	~AssetLoader();
+
+	/** start queueing loads */
+	void begin();
+	/** complete all queued loads, on the main thread @return false if a sound could not be loaded,
+	  * the errors are logged. Models that can't be loaded are replaced by a box, as with load() */
+	bool end();
+
+	/** load a model, created by the renderer, substituting a box of the given size on error */
+	void loadModel(Model *model, const string &path, int size, int height);
+	/** load a sound, throws runtime_error on failure unless queued */
+	void loadSound(StaticSound *sound, const string &path);
+};
+
+}}
+
+#endif
@@ -75,11 +75,11 @@ void CloakType::load(const string &dir, const XmlNode *cloakNode, const TechTree
 		} else if (childNode->getName() == "cloak-sound") { // sounds
 			m_cloakSound = new StaticSound();
 			string path = dir + "/" + childNode->getRestrictedAttribute("path");
-			m_cloakSound->load(path);
+			g_world.getAssetLoader().loadSound(m_cloakSound, path);
 		} else if (childNode->getName() == "de-cloak-sound") {
 			m_deCloakSound = new StaticSound();
 			string path = dir + "/" + childNode->getRestrictedAttribute("path");
-			m_deCloakSound->load(path);
+			g_world.getAssetLoader().loadSound(m_deCloakSound, path);
 
 		} else if (childNode->getName() == "ally-shader") { // custom shaders
 			if (childNode->getBoolValue()) {
@@ -168,15 +168,15 @@ void DetectorType::load(const string &dir, const XmlNode *node, const TechTree *
 		} else if (childNode->getName() == "detect-sound") { // sounds
 			m_detectionMadeSound = new StaticSound();
 			string path = dir + "/" + childNode->getRestrictedAttribute("path");
-			m_detectionMadeSound->load(path);
+			g_world.getAssetLoader().loadSound(m_detectionMadeSound, path);
 		} else if (childNode->getName() == "activate-sound") {
 			m_detectionOnSound = new StaticSound();
 			string path = dir + "/" + childNode->getRestrictedAttribute("path");
-			m_detectionOnSound->load(path);
+			g_world.getAssetLoader().loadSound(m_detectionOnSound, path);
 		} else if (childNode->getName() == "deactivate-sound") {
 			m_detectionOffSound = new StaticSound();
 			string path = dir + "/" + childNode->getRestrictedAttribute("path");
-			m_detectionOffSound->load(path);
+			g_world.getAssetLoader().loadSound(m_detectionOffSound, path);
 		}
 	}
 	if (m_groups.empty()) {
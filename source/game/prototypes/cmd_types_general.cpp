@@ -541,7 +541,7 @@ bool ProduceCommandType::load(const XmlNode *n, const string &dir, const TechTre
 				const XmlNode *soundFileNode = finishSoundNode->getChild("sound-file", i);
 				string path = soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_finishedSounds[i] = sound;
 			}
 		}
@@ -698,7 +698,7 @@ bool GenerateCommandType::load(const XmlNode *n, const string &dir, const TechTr
 				const XmlNode *soundFileNode = finishSoundNode->getChild("sound-file", i);
 				string path = soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_finishedSounds[i] = sound;
 			}
 		}
@@ -835,7 +835,7 @@ bool UpgradeCommandType::load(const XmlNode *n, const string &dir, const TechTre
 				const XmlNode *soundFileNode = finishSoundNode->getChild("sound-file", i);
 				string path = soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_finishedSounds[i] = sound;
 			}
 		}
@@ -1037,7 +1037,7 @@ bool MorphCommandType::load(const XmlNode *n, const string &dir, const TechTree
 				const XmlNode *soundFileNode = finishSoundNode->getChild("sound-file", i);
 				string path = soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_finishedSounds[i] = sound;
 			}
 		}
@@ -1741,34 +1741,31 @@ bool CommandType::unitInRange(const Unit *unit, int range, Unit **rangedPtr,
 		needDistance = true;
 	} else {
 		Targets enemies;
-		Vec2i pos;
-		PosCircularIteratorOrdered pci(g_world.getMap()->getBounds(), effectivePos, 
-			g_world.getPosIteratorFactory().getInsideOutIterator(1, range + halfSize.intp()));
-
-		Map *map = g_world.getMap();
-		while (pci.getNext(pos, distance)) {
-			foreach_enum (Zone, z) { // all zones
-				if (!asts || asts->getZone(z)) { // looking for target in z?
-					// does cell contain a bad guy?
-					Unit *possibleEnemy = map->getCell(pos)->getUnit(z);
-					if (possibleEnemy && possibleEnemy->isAlive() && !unit->isAlly(possibleEnemy)) {
-						if (possibleEnemy->isCloaked()) {
-							int cloakGroup = possibleEnemy->getCloakGroup();
-							Vec2i tpos = Map::toTileCoords(possibleEnemy->getCenteredPos());
-							if (!g_cartographer.canDetect(unit->getTeam(), cloakGroup, tpos)) {
-								continue;
-							}
-						}
-						// If bad guy has an attack command we can short circut this loop now
-						if (possibleEnemy->getType()->hasCommandClass(CmdClass::ATTACK)) {
-							*rangedPtr = possibleEnemy;
-							goto unitOnRange_exitLoop;
-						}
-						// otherwise, we'll record it and figure out who to slap later.
-						enemies.record(possibleEnemy, distance);
-					}
+		UnitIndex::Results candidates; // sorted nearest first
+		g_map.getUnitIndex().findEnemies(unit->getTeam(), effectivePos, range + halfSize.intp(), candidates);
+
+		foreach (UnitIndex::Results, it, candidates) {
+			Unit *possibleEnemy = it->unit;
+			if (asts && !asts->getZone(possibleEnemy->getCurrZone())) { // looking for target in this zone?
+				continue;
+			}
+			if (!possibleEnemy->isAlive()) {
+				continue;
+			}
+			if (possibleEnemy->isCloaked()) {
+				int cloakGroup = possibleEnemy->getCloakGroup();
+				Vec2i tpos = Map::toTileCoords(possibleEnemy->getCenteredPos());
+				if (!g_cartographer.canDetect(unit->getTeam(), cloakGroup, tpos)) {
+					continue;
 				}
 			}
+			// If bad guy has an attack command we can short circut this loop now
+			if (possibleEnemy->getType()->hasCommandClass(CmdClass::ATTACK)) {
+				*rangedPtr = possibleEnemy;
+				goto unitOnRange_exitLoop;
+			}
+			// otherwise, we'll record it and figure out who to slap later.
+			enemies.record(possibleEnemy, it->dist);
 		}
 	
 		if (!enemies.size()) {
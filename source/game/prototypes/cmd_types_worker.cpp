@@ -330,6 +330,10 @@ void RepairCommandType::update(Unit *unit) const {
 				}
 				break;
 
+			case TravelState::PENDING:
+				unit->setCurrSkill(SkillClass::STOP);
+				break;
+
 			case TravelState::IMPOSSIBLE:
 				unit->setCurrSkill(SkillClass::STOP);
 				unit->finishCommand();
@@ -460,7 +464,7 @@ bool BuildCommandType::load(const XmlNode *n, const string &dir, const TechTree
 				const XmlNode *soundFileNode = startSoundNode->getChild("sound-file", i);
 				string path = soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_startSounds[i] = sound;
 			}
 		}
@@ -478,7 +482,7 @@ bool BuildCommandType::load(const XmlNode *n, const string &dir, const TechTree
 				const XmlNode *soundFileNode= builtSoundNode->getChild("sound-file", i);
 				string path= soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound= new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				m_builtSounds[i]= sound;
 			}
 		}
@@ -629,6 +633,10 @@ bool BuildCommandType::hasArrived(Unit *unit, const Command *command, const Unit
 			}
 			break;
 
+		case TravelState::PENDING:
+			unit->setCurrSkill(SkillClass::STOP);
+			break;
+
 		case TravelState::ARRIVED:
 			arrived = true;
 			break;
@@ -975,6 +983,7 @@ void HarvestCommandType::update(Unit *unit) const {
 					unit->face(unit->getNextPos());
 					return;
 				case TravelState::BLOCKED:
+				case TravelState::PENDING:
 					unit->setCurrSkill(SkillClass::STOP);
 					return;
 				case TravelState::IMPOSSIBLE:
@@ -55,7 +55,7 @@ void EarthquakeType::load(const XmlNode *n, const string &dir, const TechTree *t
 	if(soundFileNode) {
 		string path= soundFileNode->getAttribute("path")->getRestrictedValue();
 		sound= new StaticSound();
-		sound->load(dir + "/" + path);
+		g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 	} else {
 		sound = NULL;
 	}
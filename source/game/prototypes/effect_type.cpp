@@ -14,6 +14,7 @@
 #include "renderer.h"
 #include "tech_tree.h"
 #include "logger.h"
+#include "world.h"
 
 #include "leak_dumper.h"
 
@@ -216,7 +217,7 @@ bool EffectType::load(const XmlNode *en, const string &dir, const TechTree *tt,
 			loopSound = soundNode->getAttribute("loop")->getBoolValue();
 			string path = soundNode->getAttribute("path")->getRestrictedValue();
 			sound = new StaticSound();
-			sound->load(dir + "/" + path);
+			g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 		}
 	} catch (runtime_error e) {
 		g_logger.logXmlError(dir, e.what ());
@@ -119,7 +119,7 @@ bool FactionType::load(int ndx, const string &dir, const TechTree *techTree) {
 	string path = dir + "/" + m_name + ".xml";
 	XmlTree xmlTree;
 	try {
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 	} catch (runtime_error e) {
 		g_logger.logXmlError(path, "File missing or wrongly named.");
 		return false; // bail
@@ -316,7 +316,7 @@ bool FactionType::load(int ndx, const string &dir, const TechTree *techTree) {
 			for (int i=0; i < attackNoticeNode->getChildCount(); ++i) {
 				string path = attackNoticeNode->getChild("sound-file", i)->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound = new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				(*attackNotice)[i] = sound;
 			}
 			if (attackNotice->getSounds().size() == 0) {
@@ -338,7 +338,7 @@ bool FactionType::load(int ndx, const string &dir, const TechTree *techTree) {
 			for (int i = 0; i < enemyNoticeNode->getChildCount(); ++i) {
 				string path= enemyNoticeNode->getChild("sound-file", i)->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound= new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				(*enemyNotice)[i]= sound;
 			}
 			if (enemyNotice->getSounds().size() == 0) {
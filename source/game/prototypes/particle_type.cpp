@@ -97,12 +97,7 @@ void ParticleSystemType::load(const XmlNode *particleSystemNode, const string &d
 	const XmlNode *modelNode = particleSystemNode->getOptionalChild("model");
     if (modelNode && modelNode->getAttribute("value")->getBoolValue()) {
 		string path = modelNode->getAttribute("path")->getRestrictedValue();
-		model = renderer.newModel(ResourceScope::GAME);
-		try {
-			model->load(dir + "/" + path, 1, 1);
-		} catch (runtime_error &e) {
-			g_logger.logError(e.what());
-		}
+		model = g_world.getModelFactory().getModel(dir + "/" + path, 1, 1);
 	} else {
 		model = 0;
 	}
@@ -221,7 +216,7 @@ void ProjectileType::load(const string &dir, const string &path) {
 
 	try {
 		XmlTree xmlTree;
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 		const XmlNode *particleSystemNode = xmlTree.getRootNode();
 
 		ParticleSystemType::load(particleSystemNode, dir);
@@ -291,7 +286,7 @@ ParticleSystem *ProjectileType::create(bool vis) {
 void SplashType::load(const string &dir, const string &path) {
 	try {
 		XmlTree xmlTree;
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 		const XmlNode *particleSystemNode= xmlTree.getRootNode();
 
 		ParticleSystemType::load(particleSystemNode, dir);
@@ -394,7 +389,7 @@ void UnitParticleSystemType::load(const XmlNode *particleSystemNode, const strin
 void UnitParticleSystemType::load(const string &dir, const string &path) {
 	try {
 		XmlTree xmlTree;
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 		load(xmlTree.getRootNode(), dir);
 	} catch (const std::exception &e) {
 		throw runtime_error("Error loading ParticleSystem: "+ path + "\n" +e.what());
@@ -17,6 +17,7 @@
 #include "logger.h"
 #include "renderer.h"
 #include "xml_parser.h"
+#include "world.h"
 
 #include "leak_dumper.h"
 
@@ -44,7 +45,7 @@ bool ResourceType::load(const string &dir, int id) {
 	XmlTree xmlTree;
 	const XmlNode *resourceNode;
 	try { // tree
-		xmlTree.load(path); 
+		xmlTree.load(path, true); 
 		resourceNode = xmlTree.getRootNode();
 		if (!resourceNode) {
 			g_logger.logXmlError(path, "XML file appears to lack contents.");
@@ -78,8 +79,7 @@ bool ResourceType::load(const string &dir, int id) {
 			try { // model
 				const XmlNode *modelNode = typeNode->getChild("model");
 				string mPath = dir + "/" + modelNode->getAttribute("path")->getRestrictedValue();
-				model = renderer.newModel(ResourceScope::GAME);
-				model->load(mPath, GameConstants::cellScale, 2);
+				model = g_world.getModelFactory().getModel(mPath, GameConstants::cellScale, 2);
 			} catch (runtime_error e) {
 				g_logger.logXmlError(path, e.what());
 			}
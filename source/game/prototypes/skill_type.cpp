@@ -146,7 +146,7 @@ void SkillType::load(const XmlNode *sn, const string &dir, const TechTree *tt, c
 			const XmlNode *soundFileNode= soundNode->getChild("sound-file", i);
 			string path= soundFileNode->getAttribute("path")->getRestrictedValue();
 			StaticSound *sound= new StaticSound();
-			sound->load(dir + "/" + path);
+			g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 			sounds.add(sound);
 		}
 	}
@@ -211,7 +211,7 @@ void SkillType::load(const XmlNode *sn, const string &dir, const TechTree *tt, c
 				const XmlNode *soundFileNode= soundNode->getChild("sound-file", i);
 				string path= soundFileNode->getAttribute("path")->getRestrictedValue();
 				StaticSound *sound= new StaticSound();
-				sound->load(dir + "/" + path);
+				g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 				projSounds.add(sound);
 			}
 		}
@@ -680,22 +680,19 @@ void BuildSelfSkillType::load(const XmlNode *sn, const string &dir, const TechTr
 ModelFactory::ModelFactory(){}
 
 Model* ModelFactory::newInstance(const string &path, int size, int height) {
-	assert(models.find(path) == models.end());
-	Model *model = g_renderer.newModel(ResourceScope::GAME);
-	model->load(path, size, height);
+	Model *model = g_renderer.newModel(ResourceScope::GAME, path);
+	g_world.getAssetLoader().loadModel(model, path, size, height);
 	while (mediaErrorLog.hasError()) {
 		MediaErrorLog::ErrorRecord record = mediaErrorLog.popError();
 		g_logger.logMediaError("", record.path, record.msg.c_str());
 	}
-	models[path] = model;
 	return model;
 }
 
 Model* ModelFactory::getModel(const string &path, int size, int height) {
 	string cleanedPath = cleanPath(path);
-	ModelMap::iterator it = models.find(cleanedPath);
-	if (it != models.end()) {
-		return it->second;
+	if (Model *model = g_renderer.getModel(ResourceScope::GAME, cleanedPath)) {
+		return model;
 	}
 	return newInstance(cleanedPath, size, height);
 }
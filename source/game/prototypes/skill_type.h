@@ -526,18 +526,15 @@ public:
 // 	class ModelFactory
 // ===============================
 
+/** Gets the models for the prototypes, each file is loaded once and shared through the
+  * renderer's index of game models */
 class ModelFactory {
 private:
-	typedef map<string, Model*> ModelMap;
-
-private:
-	ModelMap models;
-	int idCounter;
-
 	Model* newInstance(const string &path, int size, int height);
 
 public:
 	ModelFactory();
+	/** get a model, substituting a box of the given size if it can't be loaded */
 	Model* getModel(const string &path, int size, int height);
 };
 
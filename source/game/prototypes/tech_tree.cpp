@@ -46,7 +46,7 @@ bool TechTree::preload(const string &dir, const set<string> &factionNames){
 	name = basename(dir);
 	try {
 		path = dir + "/" + name + ".xml";
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 	}
 	catch (runtime_error &e) {
 		g_logger.logXmlError ( path, "File missing or wrongly named." );
@@ -124,7 +124,7 @@ bool UnitType::load(const string &dir, const TechTree *techTree, const FactionTy
 	string path = dir + "/" + m_name + ".xml";
 
 	XmlTree xmlTree;
-	try { xmlTree.load(path); }
+	try { xmlTree.load(path, true); }
 	catch (runtime_error e) {
 		g_logger.logXmlError(path, e.what());
 		g_logger.logError("Fatal Error: could not load " + path);
@@ -335,7 +335,7 @@ bool UnitType::load(const string &dir, const TechTree *techTree, const FactionTy
 					const XmlNode *soundNode= selectionSoundNode->getChild("sound", i);
 					string path= soundNode->getAttribute("path")->getRestrictedValue();
 					StaticSound *sound= new StaticSound();
-					sound->load(dir + "/" + path);
+					g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 					selectionSounds[i]= sound;
 				}
 			}
@@ -351,7 +351,7 @@ bool UnitType::load(const string &dir, const TechTree *techTree, const FactionTy
 					const XmlNode *soundNode= commandSoundNode->getChild("sound", i);
 					string path= soundNode->getAttribute("path")->getRestrictedValue();
 					StaticSound *sound= new StaticSound();
-					sound->load(dir + "/" + path);
+					g_world.getAssetLoader().loadSound(sound, dir + "/" + path);
 					commandSounds[i]= sound;
 				}
 			}
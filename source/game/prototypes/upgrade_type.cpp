@@ -188,7 +188,7 @@ bool UpgradeType::load(const string &dir, const TechTree *techTree, const Factio
 	XmlTree xmlTree;
 	const XmlNode *upgradeNode;
 	try { 
-		xmlTree.load(path);
+		xmlTree.load(path, true);
 		upgradeNode= xmlTree.getRootNode();
 	}
 	catch (runtime_error e) { 
@@ -16,6 +16,7 @@
 #include "logger.h"
 #include "xml_parser.h"
 #include "util.h"
+#include "map_file.h"
 #include "game_util.h"
 #include "leak_dumper.h"
 #include "simulation_enums.h"
@@ -174,7 +175,7 @@ void Scenario::loadGameSettings(string scenario, string category, const Scenario
 	string scenarioPath = "gae/scenarios/" + category + "/" + scenario;
 	// map in scenario dir ?
 	string test = scenarioPath + "/" + scenarioInfo->mapName;
-	if (fileExists(test + ".gbm") || fileExists(test + ".mgm")) {
+	if (!MapFile::findFile(test).empty()) {
 		gs->setMapPath(test);
 	} else {
 		gs->setMapPath(string("maps/") + scenarioInfo->mapName);
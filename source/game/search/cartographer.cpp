@@ -502,61 +502,136 @@ void Cartographer::initTeamMaps() {
 	}
 }
 
-/** Custom Goal function for maintaining the exploration maps */
-class VisibilityMaintainerGoal {
-private:
-	float range;			/**< range of entity sight */
-	ExplorationMap *eMap;	/**< exploration map to adjust */
-	bool inc;				/**< true to increment, false to decrement */
-public:
-	/** Construct goal function object
-	  * @param range the range of visibility
-	  * @param eMap the ExplorationMap to adjust
-	  * @param inc true to apply visibility, false to remove
-	  */
-	VisibilityMaintainerGoal(float range, ExplorationMap *eMap, bool inc)
-		: range(range), eMap(eMap), inc(inc) {}
+/** the visibility of a tile for team when no unit can see it */
+bool Cartographer::defaultVisibility(const Tile *tile, int team) const {
+	return !world->getFogOfWar() && (!world->getShroudOfDarkness() || tile->isExplored(team));
+}
 
-	/** The goal function 
-	  * @param pos position to test
-	  * @param costSoFar the cost of the shortest path to pos
-	  * @return true when range is exceeded.
-	  */
-	bool operator()(const Vec2i &pos, const float costSoFar) const { 
-		if ( costSoFar > range ) {
-			return true;
-		}
-		if ( inc ) {
-			eMap->incVisCounter(pos);
-		} else {
-			eMap->decVisCounter(pos);
+/** Adjust the visibility counters (and tile visible flags) for an applied UnitVisibility, marking
+  * tiles explored if adding. The swept area matches that of the old World::exploreCells() */
+void Cartographer::applyVisibility(const UnitVisibility &vis, bool add) {
+	ExplorationMap *eMap = m_explorationMaps[vis.team];
+	const int surfSightRange = vis.sight / GameConstants::cellScale + 1;
+	const int sweepRange = surfSightRange + World::indirectSightRange + 1;
+	const bool shroud = world->getShroudOfDarkness();
+
+	for (int y = -sweepRange; y <= sweepRange; ++y) {
+		for (int x = -sweepRange; x <= sweepRange; ++x) {
+			Vec2i relPos(x, y);
+			Vec2i pos = vis.tilePos + relPos;
+			if (!cellMap->isInsideTile(pos)) {
+				continue;
+			}
+			float dist = relPos.length();
+			Tile *tile = cellMap->getTile(pos);
+			if (add && shroud && dist < sweepRange && !tile->isExplored(vis.team)) {
+				tile->setExplored(vis.team, true);
+				if (!world->getFogOfWar()) {
+					tile->setVisible(vis.team, true);
+				}
+			}
+			if (dist < surfSightRange) {
+				if (add) {
+					if (eMap->incVisCounter(pos) == 1) {
+						tile->setVisible(vis.team, true);
+					}
+				} else {
+					assert(eMap->getVisCounter(pos) > 0);
+					if (eMap->decVisCounter(pos) == 0) {
+						tile->setVisible(vis.team, defaultVisibility(tile, vis.team));
+					}
+				}
+			}
 		}
-		return false; 
 	}
-};
+	if (vis.team == world->getThisTeamIndex()) {
+		world->markFowDirty(vis.cellPos, vis.sight);
+	}
+}
 
-/** Maintains visibility on a per team basis. Adds or removes a unit's visibility
-  * to (or from) its team exploration map, using a Dijkstra search.
+/** Maintains visibility on a per team basis. Removes the visibility a unit has applied to its
+  * team's exploration map, decrementing the visibility counters it covered, then if add is true
+  * and the unit can see (operative and not in a transport) applies its current visibility,
+  * incrementing the counters within its sight. A tile is visible to a team while its counter is
+  * non-zero.
   * @param unit the unit to remove or add visibility for
-  * @param add true to add this units visibility to its team map, false to remove
+  * @param add true to (re)apply this unit's visibility to its team map, false to remove it
   */
 void Cartographer::maintainUnitVisibility(Unit *unit, bool add) {
-	
-	/* This might be too expensive using Dijkstra...
+	UnitVisibilityMap::iterator it = m_unitVisibility.find(unit->getId());
+	if (it != m_unitVisibility.end()) {
+		applyVisibility(it->second, false);
+		m_unitVisibility.erase(it);
+	}
+	if (!add || !unit->isOperative() || unit->isCarried()
+	|| m_explorationMaps.find(unit->getTeam()) == m_explorationMaps.end()) {
+		return;
+	}
+	UnitVisibility vis;
+	vis.cellPos = unit->getPos();
+	vis.tilePos = Map::toTileCoords(unit->getCenteredPos());
+	vis.sight = unit->getSight();
+	vis.team = unit->getTeam();
+	applyVisibility(vis, true);
+	m_unitVisibility[unit->getId()] = vis;
+}
 
-	// set up goal function
-	VisibilityMaintainerGoal goalFunc((float)unit->getSight(), m_explorationMaps[unit->getTeam()], add);
-	// set up search engine
-	GridNeighbours::setSearchSpace(SearchSpace::TILEMAP);
-	nmSearchEngine->setNodeLimit(-1);
-	nmSearchEngine->reset();
-	nmSearchEngine->setOpen(Map::toTileCoords(unit->getCenteredPos()), 0.f);
-	// zap
-	nmSearchEngine->aStar<VisibilityMaintainerGoal,DistanceCost,ZeroHeuristic>
-						 (goalFunc,DistanceCost(),ZeroHeuristic());
-	// reset search space
-	GridNeighbours::setSearchSpace(SearchSpace::CELLMAP);
-	*/
+void Cartographer::updateUnitVisibility(Unit *unit) {
+	UnitVisibilityMap::iterator it = m_unitVisibility.find(unit->getId());
+	bool canSee = unit->isOperative() && !unit->isCarried();
+	if (it == m_unitVisibility.end()) {
+		if (canSee) {
+			maintainUnitVisibility(unit, true);
+		}
+		return;
+	}
+	UnitVisibility &vis = it->second;
+	if (!canSee) {
+		maintainUnitVisibility(unit, false);
+	} else if (vis.sight != unit->getSight() || vis.tilePos != Map::toTileCoords(unit->getCenteredPos())) {
+		maintainUnitVisibility(unit, true);
+	} else if (vis.cellPos != unit->getPos()) {
+		// moved within its tile, only the minimap alpha needs redoing
+		if (vis.team == world->getThisTeamIndex()) {
+			world->markFowDirty(vis.cellPos, vis.sight);
+			world->markFowDirty(unit->getPos(), vis.sight);
+		}
+		vis.cellPos = unit->getPos();
+	}
+}
+
+void Cartographer::initVisibility() {
+	foreach (TeamExplorationMaps, it, m_explorationMaps) {
+		it->second->reset();
+	}
+	m_unitVisibility.clear();
+	for (int y = 0; y < cellMap->getTileH(); ++y) {
+		for (int x = 0; x < cellMap->getTileW(); ++x) {
+			Tile *tile = cellMap->getTile(x, y);
+			for (int team = 0; team < GameConstants::maxPlayers; ++team) {
+				tile->setVisible(team, defaultVisibility(tile, team));
+			}
+		}
+	}
+	for (int i = 0; i < world->getFactionCount(); ++i) {
+		Faction *f = world->getFaction(i);
+		for (int j = 0; j < f->getUnitCount(); ++j) {
+			maintainUnitVisibility(f->getUnit(j), true);
+		}
+	}
+}
+
+void Cartographer::restoreVisibility(int team, const Vec2i &tl, const Vec2i &br) {
+	TeamExplorationMaps::iterator it = m_explorationMaps.find(team);
+	if (it == m_explorationMaps.end()) {
+		return;
+	}
+	for (int y = std::max(tl.y, 0); y <= std::min(br.y, cellMap->getTileH() - 1); ++y) {
+		for (int x = std::max(tl.x, 0); x <= std::min(br.x, cellMap->getTileW() - 1); ++x) {
+			Tile *tile = cellMap->getTile(x, y);
+			tile->setVisible(team, it->second->getVisCounter(Vec2i(x, y)) > 0 || defaultVisibility(tile, team));
+		}
+	}
 }
 
 /** Custom Goal function for finding resources */
@@ -28,7 +28,8 @@ using std::make_pair;
 namespace Glest { namespace Search {
 
 /** A map containing a visility counter and explored flag for every map tile. 
-  * WIP, not in use, exploration state is currently maintained in the tile map */
+  * The visibility counters are maintained incrementally by the Cartographer, the Tile visible
+  * flags are kept in sync with them, explored state is still maintained in the tile map */
 class ExplorationMap {
 #	pragma pack(push, 2)
 		struct ExplorationState {	/**< The exploration state of one tile for one team */			
@@ -44,19 +45,30 @@ public:
 		memset(state, 0, sizeof(ExplorationState) * cellMap->getTileW() * cellMap->getTileH());
 	}
 	~ExplorationMap(){ delete[] state; }
-	/** @param pos cell coordinates @return number of units that can see this tile */
-	int  getVisCounter(const Vec2i &pos) const	{ return state[pos.y * cellMap->getTileH() + pos.x].visCounter; }
-	/** @param pos tile coordinates to increase visibilty on */
-	void incVisCounter(const Vec2i &pos) const	{ ++state[pos.y * cellMap->getTileH() + pos.x].visCounter;		}
-	/** @param pos tile coordinates to decrease visibilty on */
-	void decVisCounter(const Vec2i &pos) const	{ --state[pos.y * cellMap->getTileH() + pos.x].visCounter;		}
+	/** reset all counters and explored flags to zero */
+	void reset() { memset(state, 0, sizeof(ExplorationState) * cellMap->getTileW() * cellMap->getTileH()); }
+	/** @param pos tile coordinates @return number of units that can see this tile */
+	int  getVisCounter(const Vec2i &pos) const	{ return state[pos.y * cellMap->getTileW() + pos.x].visCounter; }
+	/** @param pos tile coordinates to increase visibilty on @return the new counter value */
+	int  incVisCounter(const Vec2i &pos) const	{ return ++state[pos.y * cellMap->getTileW() + pos.x].visCounter; }
+	/** @param pos tile coordinates to decrease visibilty on @return the new counter value */
+	int  decVisCounter(const Vec2i &pos) const	{ return --state[pos.y * cellMap->getTileW() + pos.x].visCounter; }
 	/** @param pos tile coordinates @return true if explored. */
-	bool isExplored(const Vec2i &pos)	 const	{ return state[pos.y * cellMap->getTileH() + pos.x].explored;	}
+	bool isExplored(const Vec2i &pos)	 const	{ return state[pos.y * cellMap->getTileW() + pos.x].explored;	}
 	/** @param pos coordinates of tile to set as explored */
-	void setExplored(const Vec2i &pos)	 const	{ state[pos.y * cellMap->getTileH() + pos.x].explored = 1;		}
+	void setExplored(const Vec2i &pos)	 const	{ state[pos.y * cellMap->getTileW() + pos.x].explored = 1;		}
 
 };
 
+/** The visibility a unit has applied to its team's ExplorationMap, recorded so it can be removed
+  * exactly, regardless of what has happened to the unit since. */
+struct UnitVisibility {
+	Vec2i cellPos;	/**< unit's position when applied (used for the minimap FoW alpha) */
+	Vec2i tilePos;	/**< tile the visibility is centred on */
+	int   sight;	/**< unit's sight range when applied */
+	int   team;		/**< unit's team */
+};
+
 
 struct ResourceMapKey {
 	const ResourceType *resourceType;
@@ -124,6 +136,7 @@ private:
 
 	typedef map<int, AnnotatedMap*>     TeamAnnotatedMaps;
 	typedef map<int, ExplorationMap*>   TeamExplorationMaps;
+	typedef map<int, UnitVisibility>    UnitVisibilityMap;  // applied visibility by unit id
 
 private:
 	// Map abstractions for A* and HAA* search
@@ -143,6 +156,7 @@ private:
 
 	// Exploration
 	TeamExplorationMaps  m_explorationMaps; /**< Exploration maps for each team */
+	UnitVisibilityMap    m_unitVisibility;  /**< Visibility currently applied by each unit */
 	TeamDetectorMaps     m_detectorMaps;    /**< Detector maps */
 
 	// A* stuff
@@ -187,6 +201,8 @@ private:
 	//void onUnitDied(Unit *unit);
 
 	void maintainUnitVisibility(Unit *unit, bool add);
+	void applyVisibility(const UnitVisibility &vis, bool add);
+	bool defaultVisibility(const Tile *tile, int team) const;
 
 	void saveResourceState(XmlNode *node);
 	void loadResourceState(XmlNode *node);
@@ -206,6 +222,13 @@ public:
 	void applyUnitVisibility(Unit *unit)	{ maintainUnitVisibility(unit, true); }
 	/** Removes a unit's visibility from its team's exploration map */
 	void removeUnitVisibility(Unit *unit)	{ maintainUnitVisibility(unit, false); }
+	/** Brings a unit's applied visibility up to date with its position, sight and state */
+	void updateUnitVisibility(Unit *unit);
+	/** Resets all visibility counters and applies the visibility of every unit, clobbering the tile
+	  * visible flags for all teams */
+	void initVisibility();
+	/** Re-syncs a team's tile visible flags with the visibility counters in a rectangle of tiles */
+	void restoreVisibility(int team, const Vec2i &tl, const Vec2i &br);
 
 	void initTeamMaps();
 
@@ -12,6 +12,7 @@
 #include "pch.h"
 
 #include <algorithm>
+#include <functional>
 
 #include "node_pool.h"
 #include "search_engine.h"
@@ -36,6 +37,8 @@ namespace Glest { namespace Search {
 
 int Edge::numEdges[Field::COUNT];
 int Transition::numTransitions[Field::COUNT];
+vector<int> Transition::freeIds;
+int Transition::nextId = 0;
 
 void Edge::zeroCounters() {
 	for (Field f(0); f < Field::COUNT; ++f) {
@@ -47,13 +50,32 @@ void Transition::zeroCounters() {
 	for (Field f(0); f < Field::COUNT; ++f) {
 		numTransitions[f] = 0;
 	}
+	freeIds.clear();
+	nextId = 0;
+}
+
+/** @return the lowest free id, so ids (and the order ties are broken in) are the same for all peers */
+int Transition::allocId() {
+	if (freeIds.empty()) {
+		return nextId++;
+	}
+	std::pop_heap(freeIds.begin(), freeIds.end(), std::greater<int>());
+	int id = freeIds.back();
+	freeIds.pop_back();
+	return id;
+}
+
+void Transition::freeId(int id) {
+	freeIds.push_back(id);
+	std::push_heap(freeIds.begin(), freeIds.end(), std::greater<int>());
 }
 
 ClusterMap::ClusterMap(AnnotatedMap *aMap, Cartographer *carto) 
-		: carto(carto), aMap(aMap), dirty(false) {
+		: carto(carto), aMap(aMap), dirty(false), version(0), dirtyCount(0) {
 	//_PROFILE_FUNCTION();
 	w = aMap->getWidth() / clusterSize;
 	h = aMap->getHeight() / clusterSize;
+	clusterStamps.resize(w * h, 0);
 	vertBorders = new ClusterBorder[(w-1)*h];
 	horizBorders = new ClusterBorder[w*(h-1)];
 
@@ -495,12 +517,15 @@ void ClusterMap::update() {
 	}
 	for (set<Vec2i>::iterator it = dirtyClusters.begin(); it != dirtyClusters.end(); ++it) {
 		evalCluster(*it);
+		// anything derived while the cluster was dirty is also stale
+		stampCluster(*it);
 	}
 	
 	dirtyClusters.clear();
 	dirtyNorthBorders.clear();
 	dirtyWestBorders.clear();
 	dirty = false;
+	++version;
 }
 
 
@@ -572,70 +597,14 @@ TransitionAStarNode* TransitionNodeStore::getNode() {
 	return &stock[nodeCount++];
 }
 
-void TransitionNodeStore::insertIntoOpen(TransitionAStarNode *node) {
-	if (openList.empty()) {
-		openList.push_front(node);
-		return;
-	}
-	list<TransitionAStarNode*>::iterator it = openList.begin();
-	while (it != openList.end() && (*it)->est() <= node->est()) {
-		++it;
-	}
-	openList.insert(it, node);
-}
-
-bool TransitionNodeStore::assertOpen() {
-	if (openList.size() < 2) {
-		return true;
-	}
-	set<const Transition*> seen;
-	list<TransitionAStarNode*>::iterator it1, it2 = openList.begin();
-	it1 = it2;
-	seen.insert((*it1)->pos);
-	for (++it2; it2 != openList.end(); ++it2) {
-		if (seen.find((*it2)->pos) != seen.end()) {
-			g_logger.logProgramEvent("open list has cycle... that's bad.");
-			cout << "open list has cycle... that's bad." << endl;
-			return false;
-		}
-		seen.insert((*it2)->pos);
-		if ((*it1)->est() > (*it2)->est() + 0.0001f) { // stupid inaccurate fp
-			g_logger.logProgramEvent("open list is not ordered correctly.");
-			cout << "Open list corrupt: it1.est() == " << (*it1)->est() 
-				<< " > it2.est() == " << (*it2)->est() << endl;
-			return false;
-		}
-	}
-	set<const Transition*>::iterator it = open.begin();
-	for ( ; it != open.end(); ++it) {
-		if (seen.find(*it) == seen.end()) {
-			g_logger.logProgramEvent("node marked open not on open list.");
-			cout << "node marked open not on open list." << endl;
-			return false;
-		}
-	}
-	it = seen.begin();
-	for ( ; it != seen.end(); ++it) {
-		if (open.find(*it) == open.end()) {
-			g_logger.logProgramEvent("node on open list not marked open.");
-			cout << "node on open list not marked open." << endl;
-			return false;
-		}
-	}
-	return true;
-}
-
 Transition* TransitionNodeStore::getBestSeen() {
 	assert(false); 
 	return NULL;
 }
 
 bool TransitionNodeStore::setOpen(const Transition* pos, const Transition* prev, float h, float d) {
-	assert(open.find(pos) == open.end());
-	assert(closed.find(pos) == closed.end());
-	
-	//REMOVE
-	//assert(assertOpen());
+	assert(!markerArray.isOpen(pos));
+	assert(!markerArray.isClosed(pos));
 	
 	TransitionAStarNode *node = getNode();
 	if (!node) return false;
@@ -643,44 +612,30 @@ bool TransitionNodeStore::setOpen(const Transition* pos, const Transition* prev,
 	node->prev = prev;
 	node->distToHere = d;
 	node->heuristic = h;
-	open.insert(pos);
-	insertIntoOpen(node);
-	listed[pos] = node;
-	
-	//REMOVE
-	//assert(assertOpen());
-
+	markerArray.setOpen(pos);
+	markerArray.set(pos, node);
+	openHeap.insert(node);
 	return true;
 }
 
 void TransitionNodeStore::updateOpen(const Transition* pos, const Transition* &prev, const float cost) {
-	assert(open.find(pos) != open.end());
-	assert(closed.find(prev) != closed.end());
-
-	//REMOVE
-	//assert(assertOpen());
+	assert(markerArray.isOpen(pos));
+	assert(markerArray.isClosed(prev));
 
-	TransitionAStarNode *prevNode = listed[prev];
-	TransitionAStarNode *posNode = listed[pos];
+	TransitionAStarNode *prevNode = markerArray.get(prev);
+	TransitionAStarNode *posNode = markerArray.get(pos);
 	if (prevNode->distToHere + cost < posNode->distToHere) {
-		openList.remove(posNode);
 		posNode->prev = prev;
 		posNode->distToHere = prevNode->distToHere + cost;
-		insertIntoOpen(posNode);
+		openHeap.promote(posNode);
 	}
-
-	//REMOVE
-	//assert(assertOpen());
 }
 
 const Transition* TransitionNodeStore::getBestCandidate() {
-	if (openList.empty()) return NULL;
-	TransitionAStarNode *node = openList.front();
-	const Transition *best = node->pos;
-	openList.pop_front();
-	open.erase(open.find(best));
-	closed.insert(best);
-	return best;
+	if (openHeap.empty()) return NULL;
+	TransitionAStarNode *node = openHeap.extract();
+	markerArray.setClosed(node->pos);
+	return node->pos;
 }
 
 }}
@@ -14,6 +14,7 @@
 
 #include <map>
 #include "game_constants.h"
+#include "heap.h"
 
 using std::set;
 using std::map;
@@ -21,6 +22,7 @@ using std::list;
 using std::numeric_limits;
 using Glest::Sim::Field;
 using Shared::Util::deleteValues;
+using Shared::Util::MinHeap;
 
 namespace Glest {
 	
@@ -63,28 +65,38 @@ public:
 };
 typedef list<Edge*> Edges;
 
-/**  */
+/** A transition (abstract graph node), each has a dense integer id, ids of deleted transitions
+  * are recycled, so ids will never exceed the peak number of transitions in existence */
 struct Transition {
 private:
 	static int numTransitions[Field::COUNT];
+	static vector<int> freeIds;	/**< min-heap of ids of deleted transitions */
+	static int nextId;
 	Field f;
 
+	static int allocId();
+	static void freeId(int id);
+
 public:
+	int id;
 	int clearance;
 	Vec2i nwPos;
 	bool vertical;
 	Edges edges;
 
 	Transition(Vec2i pos, int clear, bool vert, Field f) 
-			: f(f), clearance(clear), nwPos(pos), vertical(vert) {
+			: f(f), id(allocId()), clearance(clear), nwPos(pos), vertical(vert) {
 		++numTransitions[f];
 	}
 	~Transition() {
 		deleteValues(edges.begin(), edges.end());
 		--numTransitions[f];
+		freeId(id);
 	}
 
 	static int NumTransitions(Field f) { return numTransitions[f]; }
+	/** @return one more than the highest id currently allocated */
+	static int maxId() { return nextId; }
 	static void zeroCounters();
 };
 
@@ -187,6 +199,16 @@ private:
 	set<Vec2i> dirtyNorthBorders;
 	set<Vec2i> dirtyWestBorders;
 	bool dirty;
+	int version;	/**< incremented each time the map is updated */
+
+	int dirtyCount;				/**< incremented on every dirty event */
+	vector<int> clusterStamps;	/**< per cluster, dirtyCount when it was last made (or rebuilt) dirty */
+
+	void stampCluster(const Vec2i &cluster) {
+		if (cluster.x >= 0 && cluster.y >= 0 && cluster.x < w && cluster.y < h) {
+			clusterStamps[cluster.y * w + cluster.x] = ++dirtyCount;
+		}
+	}
 
 	int eClear[GameConstants::clusterSize];
 
@@ -231,11 +253,32 @@ public:
 	void getTransitions(const Vec2i &cluster, Field f, Transitions &t);
 
 	bool isDirty() const { return dirty; }
+	int getVersion() const { return version; }
 	void update();
 
-	void setClusterDirty(const Vec2i &cluster)		{ dirty = true; dirtyClusters.insert(cluster);		}
-	void setNorthBorderDirty(const Vec2i &cluster)	{ dirty = true; dirtyNorthBorders.insert(cluster);	}
-	void setWestBorderDirty(const Vec2i &cluster)	{ dirty = true; dirtyWestBorders.insert(cluster);	}
+	void setClusterDirty(const Vec2i &cluster) {
+		dirty = true;
+		dirtyClusters.insert(cluster);
+		stampCluster(cluster);
+	}
+	void setNorthBorderDirty(const Vec2i &cluster) {
+		dirty = true;
+		dirtyNorthBorders.insert(cluster);
+		stampCluster(cluster);
+		stampCluster(Vec2i(cluster.x, cluster.y - 1));
+	}
+	void setWestBorderDirty(const Vec2i &cluster) {
+		dirty = true;
+		dirtyWestBorders.insert(cluster);
+		stampCluster(cluster);
+		stampCluster(Vec2i(cluster.x - 1, cluster.y));
+	}
+
+	/** @return a counter that increases with every dirty event, anything derived from the cluster
+	  * map is still good for a cluster if the cluster's stamp is not greater than the count was */
+	int getDirtyCount() const { return dirtyCount; }
+	/** @return the dirty count at the last change to cluster, or to one of its borders */
+	int getClusterStamp(const Vec2i &cluster) const { return clusterStamps[cluster.y * w + cluster.x]; }
 
 	void assertValid();
 
@@ -270,6 +313,21 @@ struct TransitionAStarNode {
 	float est()	const	{		/**< estimate, costToHere + heuristic */
 		return distToHere + heuristic;	
 	}
+
+	int heap_ndx;
+	void setHeapIndex(int ndx) { heap_ndx = ndx;  }
+	int  getHeapIndex() const  { return heap_ndx; }
+
+	bool operator<(const TransitionAStarNode &that) const {
+		const float diff = est() - that.est();
+		if (diff < 0) return true;
+		else if (diff > 0) return false;
+		// tie, prefer closer to goal...
+		if (heuristic < that.heuristic) return true;
+		if (heuristic > that.heuristic) return false;
+		// still tied, use transition id (not address) so all network peers agree
+		return pos->id < that.pos->id;
+	}
 };
 
 // ========================================================
@@ -278,20 +336,44 @@ struct TransitionAStarNode {
 // NodeStorage template interface
 class TransitionNodeStore {
 private:
-	list<TransitionAStarNode*> openList;
-	set<const Transition*> open;
-	set<const Transition*> closed;
-	map<const Transition*, TransitionAStarNode*> listed;
+	// =====================================================
+	//  struct MarkerArray
+	// =====================================================
+	/** Marker & pointer array indexed by transition id, supporting two mark types, open and closed.
+	  * Marks are generation stamped, so nothing needs clearing between searches. */
+	struct MarkerArray {
+	private:
+		unsigned int counter;				/**< the counter		 */
+		vector<unsigned int> marker;		/**< the mark array	    */
+		vector<TransitionAStarNode*> pArray; /**< the pointer array */
+	public:
+		MarkerArray() : counter(0) {}
+		/** start a new search, ensuring the arrays can hold all transitions currently in existence */
+		void newSearch() {
+			counter += 2;
+			if (marker.size() < unsigned(Transition::maxId())) {
+				marker.resize(Transition::maxId(), 0);
+				pArray.resize(Transition::maxId(), 0);
+			}
+		}
+		void setOpen(const Transition *t)	{ marker[t->id] = counter;		}
+		void setClosed(const Transition *t)	{ marker[t->id] = counter + 1;	}
+		bool isOpen(const Transition *t)	{ return marker[t->id] == counter;		}
+		bool isClosed(const Transition *t)	{ return marker[t->id] == counter + 1;	}
+
+		void set(const Transition *t, TransitionAStarNode *ptr) { pArray[t->id] = ptr; }
+		TransitionAStarNode* get(const Transition *t)		{ return pArray[t->id]; }
+	};
 
 	int size, nodeCount;
 	TransitionAStarNode *stock;
+	MarkerArray markerArray;
+	MinHeap<TransitionAStarNode> openHeap;
 
 	TransitionAStarNode* getNode();
-	void insertIntoOpen(TransitionAStarNode *node);
-	bool assertOpen();
 
 public:
-	TransitionNodeStore(int size) : size(size), stock(NULL) {
+	TransitionNodeStore(int size) : size(size), stock(NULL), openHeap(size) {
 		stock = new TransitionAStarNode[size]; 
 		reset();
 	}
@@ -299,21 +381,21 @@ public:
 		delete [] stock; 
 	}
 
-	void reset() { nodeCount = 0; open.clear(); closed.clear(); openList.clear(); listed.clear(); }
+	void reset() { nodeCount = 0; openHeap.clear(); markerArray.newSearch(); }
 	void setMaxNodes(int limit) { }
 	
-	bool isOpen(const Transition* pos)		{ return open.find(pos) != open.end();		}
-	bool isClosed(const Transition* pos)	{ return closed.find(pos) != closed.end();	}
+	bool isOpen(const Transition* pos)		{ return markerArray.isOpen(pos);	}
+	bool isClosed(const Transition* pos)	{ return markerArray.isClosed(pos);	}
 
 	bool setOpen(const Transition* pos, const Transition* prev, float h, float d);
 	void updateOpen(const Transition* pos, const Transition* &prev, const float cost);
 	const Transition* getBestCandidate();
 	Transition* getBestSeen();
 
-	float getHeuristicAt(const Transition* &pos)		{ return listed[pos]->heuristic;	}
-	float getCostTo(const Transition* pos)				{ return listed[pos]->distToHere;	}
-	float getEstimateFor(const Transition* pos)			{ return listed[pos]->est();		}
-	const Transition* getBestTo(const Transition* pos)	{ return listed[pos]->prev;			}
+	float getHeuristicAt(const Transition* &pos)		{ return markerArray.get(pos)->heuristic;	}
+	float getCostTo(const Transition* pos)				{ return markerArray.get(pos)->distToHere;	}
+	float getEstimateFor(const Transition* pos)			{ return markerArray.get(pos)->est();		}
+	const Transition* getBestTo(const Transition* pos)	{ return markerArray.get(pos)->prev;		}
 };
 
 
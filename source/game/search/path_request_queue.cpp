@@ -0,0 +1,120 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+
+#include "path_request_queue.h"
+#include "game_constants.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Search {
+
+// =====================================================
+// 	class PathRequestQueue
+// =====================================================
+
+PathRequestQueue::PathRequestQueue() {
+	clear();
+}
+
+void PathRequestQueue::clear() {
+	m_requests.clear();
+	m_lookup.clear();
+	m_frame = 0;
+	m_servicedCount = m_latencySum = m_maxLatency = 0;
+	m_lastServiced = m_lastMaxLatency = 0;
+	m_lastAvgLatency = 0.f;
+}
+
+void PathRequestQueue::newFrame(int frame) {
+	m_frame = frame;
+
+	// drop requests from units no longer asking (dead, command changed, etc.)
+	Requests::iterator it = m_requests.begin();
+	while (it != m_requests.end()) {
+		if (frame - it->lastFrame > staleFrames) {
+			m_lookup.erase(it->unitId);
+			it = m_requests.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	if (frame % WORLD_FPS == 0) {
+		m_lastServiced = m_servicedCount;
+		m_lastMaxLatency = m_maxLatency;
+		m_lastAvgLatency = m_servicedCount ? float(m_latencySum) / m_servicedCount : 0.f;
+		m_servicedCount = m_latencySum = m_maxLatency = 0;
+	}
+}
+
+bool PathRequestQueue::admit(int unitId, int nodesUsed) {
+	RequestMap::iterator it = m_lookup.find(unitId);
+	if (it == m_lookup.end()) {
+		// new requests go straight through only if no one is waiting
+		if (m_requests.empty() && nodesUsed < frameNodeBudget) {
+			return true;
+		}
+		enqueue(unitId);
+		return false;
+	}
+	Request &req = *it->second;
+	req.lastFrame = m_frame;
+	if (nodesUsed >= frameNodeBudget) {
+		return false;
+	}
+	// the oldest requests may use the whole budget, younger ones only half, so a stream of
+	// new requests from units updated earlier in the frame can not starve an old one
+	if (req.queuedFrame == m_requests.front().queuedFrame) {
+		return true;
+	}
+	return nodesUsed < frameNodeBudget / 2;
+}
+
+void PathRequestQueue::defer(int unitId) {
+	RequestMap::iterator it = m_lookup.find(unitId);
+	if (it == m_lookup.end()) {
+		enqueue(unitId);
+	} else {
+		it->second->lastFrame = m_frame;
+	}
+}
+
+void PathRequestQueue::enqueue(int unitId) {
+	m_requests.push_back(Request(unitId, m_frame));
+	m_lookup[unitId] = --m_requests.end();
+}
+
+void PathRequestQueue::serviced(int unitId) {
+	RequestMap::iterator it = m_lookup.find(unitId);
+	if (it == m_lookup.end()) {
+		return;
+	}
+	int latency = m_frame - it->second->queuedFrame;
+	++m_servicedCount;
+	m_latencySum += latency;
+	if (latency > m_maxLatency) {
+		m_maxLatency = latency;
+	}
+	m_requests.erase(it->second);
+	m_lookup.erase(it);
+}
+
+void PathRequestQueue::remove(int unitId) {
+	RequestMap::iterator it = m_lookup.find(unitId);
+	if (it != m_lookup.end()) {
+		m_requests.erase(it->second);
+		m_lookup.erase(it);
+	}
+}
+
+}}
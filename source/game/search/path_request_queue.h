@@ -0,0 +1,95 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+//
+// File: path_request_queue.h
+//
+
+#ifndef _GLEST_GAME_PATHFINDER_PATH_REQUEST_QUEUE_H_
+#define _GLEST_GAME_PATHFINDER_PATH_REQUEST_QUEUE_H_
+
+#include <list>
+#include <map>
+
+namespace Glest { namespace Search {
+
+using std::list;
+using std::map;
+
+// =====================================================
+// 	class PathRequestQueue
+// =====================================================
+/** Rations new path searches to a per-frame budget of expanded nodes. Units that can not be
+  * serviced this frame are queued, and serviced oldest first on later frames. All decisions
+  * are based on frame numbers, unit ids and node counts, so are identical for all peers. */
+class PathRequestQueue {
+public:
+	/** node expansions allowed per world frame, across all searches */
+	static const int frameNodeBudget = 4096;
+	/** a queued unit that has not asked for its path in this many frames is dropped */
+	static const int staleFrames = 80;
+
+private:
+	struct Request {
+		int unitId;
+		int queuedFrame;	/**< frame request was first deferred */
+		int lastFrame;		/**< frame request was last made	   */
+
+		Request(int id, int frame) : unitId(id), queuedFrame(frame), lastFrame(frame) {}
+	};
+	typedef list<Request>					Requests;
+	typedef map<int, Requests::iterator>	RequestMap;
+
+	Requests	m_requests;	/**< pending requests, in the order they were deferred */
+	RequestMap	m_lookup;	/**< unit id to request						   */
+	int			m_frame;
+
+	// stats, accumulated over the current second and reported for the last complete one
+	int m_servicedCount, m_latencySum, m_maxLatency;
+	int m_lastServiced, m_lastMaxLatency;
+	float m_lastAvgLatency;
+
+	void enqueue(int unitId);
+
+public:
+	PathRequestQueue();
+
+	void clear();
+	void newFrame(int frame);
+
+	/** Ask for permission to start a new search. If denied, the unit is queued (if not already).
+	  * @param unitId id of the unit requesting a path
+	  * @param nodesUsed nodes already expanded this frame
+	  * @return true if the search may proceed now */
+	bool admit(int unitId, int nodesUsed);
+
+	/** Queue a unit (if not already) whose search was started but could not be completed */
+	void defer(int unitId);
+
+	/** A unit's request has been dealt with (successfully or otherwise), removes it if queued */
+	void serviced(int unitId);
+
+	/** A unit no longer wants its request, removes it if queued without counting it as serviced */
+	void remove(int unitId);
+
+	bool isQueued(int unitId) const { return m_lookup.find(unitId) != m_lookup.end(); }
+
+	int   getQueueDepth() const		{ return m_requests.size(); }
+	/** @return number of deferred requests serviced in the last second */
+	int   getServicedCount() const	{ return m_lastServiced;	}
+	/** @return average frames deferred requests waited, over the last second */
+	float getAvgLatency() const		{ return m_lastAvgLatency;	}
+	/** @return maximum frames a deferred request waited, over the last second */
+	int   getMaxLatency() const		{ return m_lastMaxLatency;	}
+};
+
+}}
+
+#endif
@@ -101,7 +101,9 @@ RoutePlanner::RoutePlanner(World *world)
 		, nsgSearchEngine(NULL)
 		, nodeStore(NULL)
 		, tSearchEngine(NULL)
-		, tNodeStore(NULL) {
+		, tNodeStore(NULL)
+		, m_activeSearch(NULL)
+		, m_nodesLastFrame(0) {
 	//g_logger.logProgramEvent( "Initialising SearchEngine", true );
 
 	const int &w = world->getMap()->getW();
@@ -124,6 +126,7 @@ RoutePlanner::RoutePlanner(World *world)
 
 /** delete SearchEngine objects */
 RoutePlanner::~RoutePlanner() {
+	delete m_activeSearch;
 	delete nsgSearchEngine;
 	delete tSearchEngine;
 }
@@ -266,33 +269,6 @@ HAAStarResult RoutePlanner::setupHierarchicalSearch(Unit *unit, const Vec2i &des
 					 : HAAStarResult::COMPLETE;
 }
 
-HAAStarResult RoutePlanner::findWaypointPath(Unit *unit, const Vec2i &dest, WaypointPath &waypoints) {
-	SECTION_TIMER(PATHFINDER_HIERARCHICAL);
-	TIME_FUNCTION();
-	_PROFILE_PATHFINDER();
-	TransitionGoal goal;
-	HAAStarResult setupResult = setupHierarchicalSearch(unit, dest, goal);
-	nsgSearchEngine->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
-	if (setupResult == HAAStarResult::FAILURE) {
-		return HAAStarResult::FAILURE;
-	}
-	TransitionCost cost(unit->getCurrField(), unit->getSize());
-	TransitionHeuristic heuristic(dest);
-	AStarResult res = tSearchEngine->aStar(goal,cost,heuristic);
-	if (res == AStarResult::COMPLETE) {
-		WaypointPath &wpPath = *unit->getWaypointPath();
-		wpPath.clear();
-		waypoints.push(dest);
-		const Transition *t = tSearchEngine->getGoalPos();
-		while (t) {
-			waypoints.push(t->nwPos);
-			t = tSearchEngine->getPreviousPos(t);
-		}
-		return setupResult;
-	}
-	return HAAStarResult::FAILURE;
-}
-
 /** goal function for search on cluster map when goal position is unexplored */
 class UnexploredGoal {
 private:
@@ -320,7 +296,8 @@ public:
 		float distToBest = numeric_limits<float>::infinity();
 		foreach (set<const Transition*>, it, potentialGoals) {
 			float myDist = (*it)->nwPos.dist(target) + (*it)->nwPos.dist(currPos);
-			if (myDist < distToBest) {
+			// break ties by id, the set is ordered by address which differs between peers
+			if (myDist < distToBest || (myDist == distToBest && best && (*it)->id < best->id)) {
 				best = *it;
 				distToBest = myDist;
 			}
@@ -355,32 +332,184 @@ public:
 	}
 };
 
-HAAStarResult RoutePlanner::findWaypointPathUnExplored(Unit *unit, const Vec2i &dest, WaypointPath &waypoints) {
+/** A hierarchical search in progress, kept across frames when suspended */
+struct HierarchicalSearch {
+	int unitId;
+	Vec2i target;
+	bool unexplored;
+	int clusterMapVersion;
+	HAAStarResult setupResult;
+	TransitionGoal goal;
+	UnexploredGoal unexploredGoal;
+
+	HierarchicalSearch(const Unit *unit, const Vec2i &target, bool unexplored, int version)
+			: unitId(unit->getId()), target(target), unexplored(unexplored)
+			, clusterMapVersion(version), setupResult(HAAStarResult::FAILURE)
+			, unexploredGoal(unit->getTeam()) {}
+};
+
+/** A cached route was found between the same pair of clusters, but clusters can be divided
+  * internally, so check (as setupHierarchicalSearch() does for a new search) that unit can reach
+  * the first transition within its cluster and that the last transition can reach dest within
+  * its. If not, a full hierarchical search is done, the route is kept for the units it suits. */
+bool RoutePlanner::isCachedRouteUsable(Unit *unit, const Vec2i &dest, const vector<Vec2i> &route) {
+	if (route.empty()) {
+		return false;
+	}
+	const float inf = numeric_limits<float>::infinity();
+	bool usable = true;
+	nsgSearchEngine->getNeighbourFunc().setSearchCluster(ClusterMap::cellToCluster(unit->getPos()));
+	if (quickSearch(unit->getCurrField(), unit->getSize(), unit->getPos(), route.front()) == inf) {
+		usable = false;
+	} else {
+		nsgSearchEngine->getNeighbourFunc().setSearchCluster(ClusterMap::cellToCluster(dest));
+		if (quickSearch(unit->getCurrField(), unit->getSize(), dest, route.back()) == inf) {
+			usable = false;
+		}
+	}
+	nsgSearchEngine->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
+	return usable;
+}
+
+/** Start or resume a hierarchical search. If the target is unexplored the search is for the
+  * transition leading to unexplored territory nearest the target. The search is suspended if
+  * it exhausts the frame's node budget, and only one search may be suspended at a time.
+  * @return SUSPENDED if the search is incomplete or the transition search engine is busy with
+  * another unit's search, else the result of the search */
+HAAStarResult RoutePlanner::findWaypointPath(Unit *unit, const Vec2i &dest, WaypointPath &waypoints) {
 	SECTION_TIMER(PATHFINDER_HIERARCHICAL);
 	TIME_FUNCTION();
 	_PROFILE_PATHFINDER();
-	// set-up open list
-	HAAStarResult res = setupHierarchicalOpenList(unit, dest);
-	nsgSearchEngine->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
-	if (res == HAAStarResult::FAILURE) {
-		return HAAStarResult::FAILURE;
+	if (m_activeSearch) {
+		if (m_activeSearch->unitId != unit->getId()) {
+			m_requestQueue.defer(unit->getId());
+			return HAAStarResult::SUSPENDED;
+		}
+		if (m_activeSearch->target != dest) {
+			endSearch();
+		}
+	}
+	WaypointCache::Key cacheKey(unit->getCurrField(), unit->getSize(),
+		ClusterMap::cellToCluster(unit->getPos()), ClusterMap::cellToCluster(dest));
+	if (!m_activeSearch) {
+		bool unexplored = unit->getTeam() != -1
+			&& !g_map.getTile(Map::toTileCoords(dest))->isExplored(unit->getTeam());
+		vector<Vec2i> cachedRoute;
+		bool cacheHit = !unexplored && m_waypointCache.lookup(cacheKey, world->getFrameCount(), cachedRoute);
+		if (cacheHit && !isCachedRouteUsable(unit, dest, cachedRoute)) {
+			m_waypointCache.rejectLookup();
+			cacheHit = false;
+		}
+		if (cacheHit) {
+			// another unit has recently been this way, only the low level path need be found
+			unit->getWaypointPath()->clear();
+			foreach (vector<Vec2i>, it, cachedRoute) {
+				waypoints.push_back(*it);
+			}
+			waypoints.push_back(dest);
+			return HAAStarResult::COMPLETE;
+		}
+		m_activeSearch = new HierarchicalSearch(unit, dest, unexplored, g_cartographer.getClusterMap()->getVersion());
+		tSearchEngine->reset();
+		if (unexplored) {
+			m_activeSearch->setupResult = setupHierarchicalOpenList(unit, dest);
+		} else {
+			m_activeSearch->setupResult = setupHierarchicalSearch(unit, dest, m_activeSearch->goal);
+		}
+		nsgSearchEngine->getNeighbourFunc().setSearchSpace(SearchSpace::CELLMAP);
+		if (m_activeSearch->setupResult == HAAStarResult::FAILURE) {
+			endSearch();
+			return HAAStarResult::FAILURE;
+		}
 	}
-	//bool startTrap = res == HAAStarResult::START_TRAP;
-	UnexploredGoal goal(unit->getTeam());
-	UnexploredCost cost(unit->getCurrField(), unit->getSize(), unit->getTeam());
 	TransitionHeuristic heuristic(dest);
-	tSearchEngine->aStar(goal, cost, heuristic);
-	const Transition *t = goal.getBestSeen(unit->getPos(), dest);
-	if (!t) {
-		return HAAStarResult::FAILURE;
+	AStarResult res;
+	tSearchEngine->setTimeLimit(std::max(1, PathRequestQueue::frameNodeBudget - nodesExpandedThisFrame()));
+	if (m_activeSearch->unexplored) {
+		UnexploredCost cost(unit->getCurrField(), unit->getSize(), unit->getTeam());
+		res = tSearchEngine->aStar(m_activeSearch->unexploredGoal, cost, heuristic);
+	} else {
+		TransitionCost cost(unit->getCurrField(), unit->getSize());
+		res = tSearchEngine->aStar(m_activeSearch->goal, cost, heuristic);
+	}
+	tSearchEngine->setTimeLimit(0);
+	if (res == AStarResult::TIME_LIMIT) {
+		m_requestQueue.defer(unit->getId());
+		return HAAStarResult::SUSPENDED;
 	}
+
+	HAAStarResult result = m_activeSearch->setupResult;
 	WaypointPath &wpPath = *unit->getWaypointPath();
-	wpPath.clear();
-	while (t) {
-		waypoints.push(t->nwPos);
-		t = tSearchEngine->getPreviousPos(t);
+	if (m_activeSearch->unexplored) {
+		// the goal function always 'fails', it builds a list of possible 'avenues of exploration'
+		const Transition *t = m_activeSearch->unexploredGoal.getBestSeen(unit->getPos(), dest);
+		if (t) {
+			wpPath.clear();
+			while (t) {
+				waypoints.push(t->nwPos);
+				t = tSearchEngine->getPreviousPos(t);
+			}
+		} else {
+			result = HAAStarResult::FAILURE;
+		}
+	} else if (res == AStarResult::COMPLETE) {
+		wpPath.clear();
+		waypoints.push(dest);
+		vector<const Transition*> route;
+		const Transition *t = tSearchEngine->getGoalPos();
+		while (t) {
+			waypoints.push(t->nwPos);
+			route.push_back(t);
+			t = tSearchEngine->getPreviousPos(t);
+		}
+		if (result == HAAStarResult::COMPLETE) { // don't share routes found from/to a trap
+			std::reverse(route.begin(), route.end());
+			m_waypointCache.store(cacheKey, world->getFrameCount(), route);
+		}
+	} else {
+		result = HAAStarResult::FAILURE;
+	}
+	endSearch();
+	return result;
+}
+
+void RoutePlanner::newFrame() {
+	m_nodesLastFrame = nodesExpandedThisFrame();
+	nsgSearchEngine->resetExpandedTotal();
+	tSearchEngine->resetExpandedTotal();
+	m_requestQueue.newFrame(world->getFrameCount());
+
+	// a suspended search can not be resumed if its owner has died or given up on it,
+	// or if the cluster map has changed under it (transitions may have been deleted)
+	if (m_activeSearch) {
+		const Unit *owner = world->findUnitById(m_activeSearch->unitId);
+		if (!owner || !owner->isAlive() || !m_requestQueue.isQueued(m_activeSearch->unitId)
+		|| m_activeSearch->clusterMapVersion != g_cartographer.getClusterMap()->getVersion()) {
+			endSearch();
+		}
+	}
+}
+
+/** discard the active hierarchical search, if any */
+void RoutePlanner::endSearch() {
+	delete m_activeSearch;
+	m_activeSearch = NULL;
+}
+
+/** a unit's path request has been dealt with, remove it from the queue and discard any search
+  * it has suspended */
+void RoutePlanner::finishRequest(const Unit *unit) {
+	m_requestQueue.serviced(unit->getId());
+	if (m_activeSearch && m_activeSearch->unitId == unit->getId()) {
+		endSearch();
+	}
+}
+
+void RoutePlanner::abandonRequest(const Unit *unit) {
+	m_requestQueue.remove(unit->getId());
+	if (m_activeSearch && m_activeSearch->unitId == unit->getId()) {
+		endSearch();
 	}
-	return res; // return setup res (in case of start trap)
 }
 
 /** refine waypoint path, extend low level path to next waypoint.
@@ -618,9 +747,17 @@ TravelState RoutePlanner::findAerialPath(Unit *unit, const Vec2i &targetPos) {
 /** Find a path to a location.
   * @param unit the unit requesting the path
   * @param finalPos the position the unit desires to go to
-  * @return ARRIVED, MOVING, BLOCKED or IMPOSSIBLE
+  * @return ARRIVED, MOVING, BLOCKED, IMPOSSIBLE or PENDING
   */
 TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos) {
+	TravelState res = doFindPathToLocation(unit, finalPos);
+	if (res != TravelState::PENDING) {
+		finishRequest(unit);
+	}
+	return res;
+}
+
+TravelState RoutePlanner::doFindPathToLocation(Unit *unit, const Vec2i &finalPos) {
 	SECTION_TIMER(PATHFINDER_TOTAL);
 	PF_UNIT_LOG( unit, "findPathToLocation() current pos = " << unit->getPos() << " target pos = " << finalPos );
 	PF_LOG( "Command class = " << CmdClassNames[g_simInterface.processingCommandClass()] );
@@ -664,6 +801,11 @@ TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos)
 	}
 	//unit->clearPath();
 
+	if (!m_requestQueue.admit(unit->getId(), nodesExpandedThisFrame())) {
+		PF_LOG( "Node budget exhausted or others waiting, path pending." );
+		return TravelState::PENDING;
+	}
+
 	if (unit->getCurrField() == Field::AIR) {
 		return findAerialPath(unit, target);
 	}
@@ -679,19 +821,13 @@ TravelState RoutePlanner::findPathToLocation(Unit *unit, const Vec2i &finalPos)
 	PF_LOG( "Performing hierarchical search." );
 
 	// Hierarchical Search
-	tSearchEngine->reset();
-	HAAStarResult res;
-	// Hierarchical Search
-	tSearchEngine->reset();
-
 	RUNTIME_CHECK(world->getMap()->isInside(target));
 
-	if (unit->getTeam() == -1 || g_map.getTile(Map::toTileCoords(target))->isExplored(unit->getTeam())) {
-		res = findWaypointPath(unit, target, wpPath);
-	} else {
-		res = findWaypointPathUnExplored(unit, target, wpPath);
-	}
-	if (res == HAAStarResult::FAILURE) {
+	HAAStarResult res = findWaypointPath(unit, target, wpPath);
+	if (res == HAAStarResult::SUSPENDED) {
+		PF_LOG( "Hierarchical search suspended, path pending." );
+		return TravelState::PENDING;
+	} else if (res == HAAStarResult::FAILURE) {
 		if (unit->getFaction()->isThisFaction()) {
 			g_console.addLine(g_lang.get("DestinationUnreachable"));
 		}
@@ -785,6 +921,14 @@ TravelState RoutePlanner::customGoalSearch(PMap1Goal &goal, Unit *unit, const Ve
 }
 
 TravelState RoutePlanner::findPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2i &target) {
+	TravelState res = doFindPathToGoal(unit, goal, target);
+	if (res != TravelState::PENDING) {
+		finishRequest(unit);
+	}
+	return res;
+}
+
+TravelState RoutePlanner::doFindPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2i &target) {
 	SECTION_TIMER(PATHFINDER_TOTAL);
 	PF_UNIT_LOG( unit, "findPathToGoal() current pos = " << unit->getPos() << " target pos = " << target );
 	PF_LOG( "Command class = " << CmdClassNames[g_simInterface.processingCommandClass()] );
@@ -810,6 +954,10 @@ TravelState RoutePlanner::findPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2
 		}
 		unit->clearPath();
 	}
+	if (!m_requestQueue.admit(unit->getId(), nodesExpandedThisFrame())) {
+		PF_LOG( "Node budget exhausted or others waiting, path pending." );
+		return TravelState::PENDING;
+	}
 	// try customGoalSearch if close to target
 	if (unit->getPos().dist(target) < 50.f) {
 		if (customGoalSearch(goal, unit, target) == TravelState::MOVING) {
@@ -821,23 +969,16 @@ TravelState RoutePlanner::findPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2
 	PF_LOG( "Performing hierarchical search." );
 
 	// Hierarchical Search
-	tSearchEngine->reset();
-	if (g_map.getTile(Map::toTileCoords(target))->isExplored(unit->getTeam())) {
-		if (!findWaypointPath(unit, target, wpPath)) {
-			//if (unit->getFaction()->isThisFaction()) {
-			//	CONSOLE_LOG( "Destination unreachable? [Custom Goal Search]" )
-			//}
-			PF_LOG( "Route not possible (normal search)." );
-			return TravelState::IMPOSSIBLE;
-		}
-	} else {
-		if (!findWaypointPathUnExplored(unit, target, wpPath)) {
-			//if (unit->getFaction()->isThisFaction()) {
-			//	CONSOLE_LOG( "Destination unreachable? [Custom Goal Search]" )
-			//}
-			PF_LOG( "Route not possible (un-explored goal)." );
-			return TravelState::IMPOSSIBLE;
-		}
+	HAAStarResult res = findWaypointPath(unit, target, wpPath);
+	if (res == HAAStarResult::SUSPENDED) {
+		PF_LOG( "Hierarchical search suspended, path pending." );
+		return TravelState::PENDING;
+	} else if (res == HAAStarResult::FAILURE) {
+		//if (unit->getFaction()->isThisFaction()) {
+		//	CONSOLE_LOG( "Destination unreachable? [Custom Goal Search]" )
+		//}
+		PF_LOG( "Route not possible." );
+		return TravelState::IMPOSSIBLE;
 	}
 	IF_DEBUG_EDITION( collectWaypointPath(unit); )
 	RUNTIME_CHECK(wpPath.size() > 1);
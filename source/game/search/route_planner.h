@@ -22,6 +22,8 @@
 
 #include "search_engine.h"
 #include "cartographer.h"
+#include "path_request_queue.h"
+#include "waypoint_cache.h"
 
 #include "world.h"
 
@@ -44,6 +46,8 @@ const int pathFindNodesMax = 2048;
 
 typedef SearchEngine<TransitionNodeStore,TransitionNeighbours,const Transition*> TransitionSearchEngine;
 
+struct HierarchicalSearch;
+
 class PMap1Goal {
 protected:
 	PatchMap<1> *pMap;
@@ -131,12 +135,20 @@ public:
 // =====================================================
 // 	class RoutePlanner
 // =====================================================
-/**	Finds paths for units using SearchEngine<>::aStar<>() */ 
+/**	Finds paths for units using SearchEngine<>::aStar<>(). New searches are rationed to a
+  * per-frame node budget, units that miss out are told their path is PENDING and queued. */ 
 class RoutePlanner {
 public:
 	RoutePlanner(World *world);
 	~RoutePlanner();
 
+	/** start of world frame, resets node budget and drops stale requests */
+	void newFrame();
+
+	/** the unit no longer wants the path it asked for (it died or its command changed),
+	  * removes it from the queue and frees the transition search if it had one suspended */
+	void abandonRequest(const Unit *unit);
+
 	TravelState findPathToLocation(Unit *unit, const Vec2i &finalPos);
 
 	/** @see findPathToLocation() */
@@ -166,7 +178,20 @@ public:
 
 	SearchEngine<NodePool>* getSearchEngine() { return nsgSearchEngine; }
 
+	const PathRequestQueue& getRequestQueue() const { return m_requestQueue; }
+	int getNodesExpandedLastFrame() const { return m_nodesLastFrame; }
+	const WaypointCache& getWaypointCache() const { return m_waypointCache; }
+
 private:
+	int nodesExpandedThisFrame() const {
+		return nsgSearchEngine->getExpandedTotal() + tSearchEngine->getExpandedTotal();
+	}
+	void finishRequest(const Unit *unit);
+	void endSearch();
+
+	TravelState doFindPathToLocation(Unit *unit, const Vec2i &finalPos);
+	TravelState doFindPathToGoal(Unit *unit, PMap1Goal &goal, const Vec2i &targetPos);
+
 	bool repairPath(Unit *unit);
 
 	TravelState findAerialPath(Unit *unit, const Vec2i &targetPos);
@@ -184,7 +209,7 @@ private:
 	HAAStarResult setupHierarchicalOpenList(Unit *unit, const Vec2i &target);
 	HAAStarResult setupHierarchicalSearch(Unit *unit, const Vec2i &dest, TransitionGoal &goalFunc);
 	HAAStarResult findWaypointPath(Unit *unit, const Vec2i &dest, WaypointPath &waypoints);
-	HAAStarResult findWaypointPathUnExplored(Unit *unit, const Vec2i &dest, WaypointPath &waypoints);
+	bool isCachedRouteUsable(Unit *unit, const Vec2i &dest, const vector<Vec2i> &route);
 
 	World *world;
 	SearchEngine<NodePool>	 *nsgSearchEngine;
@@ -192,6 +217,11 @@ private:
 	TransitionSearchEngine *tSearchEngine;
 	TransitionNodeStore *tNodeStore;
 
+	PathRequestQueue	m_requestQueue;
+	HierarchicalSearch *m_activeSearch;	/**< hierarchical search in progress, or NULL */
+	int					m_nodesLastFrame;
+	WaypointCache		m_waypointCache;
+
 	Vec2i computeNearestFreePos(const Unit *unit, const Vec2i &targetPos);
 
 	bool attemptMove(Unit *unit) const {
@@ -128,7 +128,8 @@ private:
 	DomainKey invalidKey;  /**< The DomainKey value indicating an invalid 'position' */
 	int expandLimit,	  /**< limit on number of nodes to expand					*/
 		nodeLimit,		 /**< limit on number of nodes to use					   */
-		expanded;		/**< number of nodes expanded this/last run				  */
+		expanded,		/**< number of nodes expanded this/last run				  */
+		totalExpanded;	/**< number of nodes expanded since last resetExpandedTotal() */
 	bool ownStore;	   /**< wether or not this SearchEngine 'owns' its storage   */
 	NeighbourFunc neighbourFunc;
 
@@ -142,6 +143,7 @@ public:
 			, expandLimit(-1)
 			, nodeLimit(-1)
 			, expanded(0)
+			, totalExpanded(0)
 			, ownStore(own)
 			, neighbourFunc(neighbourFunc) {
 	}
@@ -212,6 +214,10 @@ public:
 	/** How many nodes were expanded last search */
 	int getExpandedLastRun() { return expanded; }
 
+	/** How many nodes have been expanded, over all runs, since the total was last reset */
+	int getExpandedTotal() const { return totalExpanded; }
+	void resetExpandedTotal() { totalExpanded = 0; }
+
 	/** Retrieves cost to the node at pos (known to be visited) */
 	float getCostTo(const DomainKey &pos) {
 		assert(nodeStorage->isOpen(pos) || nodeStorage->isClosed(pos));
@@ -265,6 +271,7 @@ public:
 				}
 			} 
 			expanded++;
+			totalExpanded++;
 			if (expanded == expandLimit) { // run limit
 				goalPos = invalidKey;
 				return AStarResult::TIME_LIMIT;
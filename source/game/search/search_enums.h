@@ -17,13 +17,16 @@ namespace Glest { namespace Search {
 /** result set for path finding 
   * <ul><li><b>ARRIVED</b> Arrived at destination (or as close as unit can get to target)</li>
   *		<li><b>MOVING</b> On the way to destination</li>
-  *		<li><b>BLOCKED</b> path is blocked</li></ul>
+  *		<li><b>BLOCKED</b> path is blocked</li>
+  *		<li><b>IMPOSSIBLE</b> destination can not be reached</li>
+  *		<li><b>PENDING</b> search deferred or suspended, try again next update</li></ul>
   */
 STRINGY_ENUM( TravelState, 
 	ARRIVED,
 	MOVING,
 	BLOCKED,
-	IMPOSSIBLE
+	IMPOSSIBLE,
+	PENDING
 );
 
 /** result set for A*
@@ -43,13 +46,15 @@ STRINGY_ENUM( AStarResult,
   * <ul><li><b>FAILURE</b> No path exists</li>
   *		<li><b>COMPLETE</b> path found</li>
   *		<li><b>START_TRAP</b> path found, but transitions in start cluster are blocked</li>
-  *		<li><b>GOAL_TRAP</b> path found, but transitions in destination cluster are blocked</li></ul>
+  *		<li><b>GOAL_TRAP</b> path found, but transitions in destination cluster are blocked</li>
+  *		<li><b>SUSPENDED</b> search ran out of node budget, will be resumed</li></ul>
   */
 STRINGY_ENUM( HAAStarResult,
 	FAILURE,
 	COMPLETE,
 	START_TRAP,
-	GOAL_TRAP
+	GOAL_TRAP,
+	SUSPENDED
 );
 
 /** Specifies a 'space' to search 
@@ -0,0 +1,89 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+
+#include "waypoint_cache.h"
+#include "world.h"
+#include "cartographer.h"
+#include "cluster_map.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Search {
+
+// =====================================================
+// 	class WaypointCache
+// =====================================================
+
+bool WaypointCache::Key::operator<(const Key &that) const {
+	if (field != that.field) return field < that.field;
+	if (size != that.size) return size < that.size;
+	if (from.x != that.from.x) return from.x < that.from.x;
+	if (from.y != that.from.y) return from.y < that.from.y;
+	if (to.x != that.to.x) return to.x < that.to.x;
+	return to.y < that.to.y;
+}
+
+bool WaypointCache::isValid(const Entry &entry) const {
+	foreach_const (vector<Vec2i>, it, entry.clusters) {
+		if (g_cartographer.getClusterMap()->getClusterStamp(*it) > entry.stamp) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool WaypointCache::lookup(const Key &key, int frame, vector<Vec2i> &out_waypoints) {
+	Entries::iterator it = m_entries.find(key);
+	if (it == m_entries.end()) {
+		++m_misses;
+		return false;
+	}
+	if (!isValid(it->second)) {
+		m_entries.erase(it);
+		++m_misses;
+		return false;
+	}
+	it->second.lastUsed = frame;
+	out_waypoints = it->second.waypoints;
+	++m_hits;
+	return true;
+}
+
+void WaypointCache::store(const Key &key, int frame, const vector<const Transition*> &route) {
+	if (m_entries.find(key) == m_entries.end() && m_entries.size() >= unsigned(maxEntries)) {
+		// evict least recently used, ties go to the lowest key so all peers agree
+		Entries::iterator lru = m_entries.begin();
+		for (Entries::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+			if (it->second.lastUsed < lru->second.lastUsed) {
+				lru = it;
+			}
+		}
+		m_entries.erase(lru);
+	}
+	Entry &entry = m_entries[key];
+	entry.waypoints.clear();
+	entry.clusters.clear();
+	entry.stamp = g_cartographer.getClusterMap()->getDirtyCount();
+	entry.lastUsed = frame;
+
+	foreach_const (vector<const Transition*>, it, route) {
+		const Transition *t = *it;
+		entry.waypoints.push_back(t->nwPos);
+		// a transition straddles a border, nwPos is in the north/west cluster
+		Vec2i other = t->nwPos + (t->vertical ? Vec2i(1, 0) : Vec2i(0, 1));
+		entry.clusters.push_back(ClusterMap::cellToCluster(t->nwPos));
+		entry.clusters.push_back(ClusterMap::cellToCluster(other));
+	}
+}
+
+}}
@@ -0,0 +1,92 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+//
+// File: waypoint_cache.h
+//
+
+#ifndef _GLEST_GAME_PATHFINDER_WAYPOINT_CACHE_H_
+#define _GLEST_GAME_PATHFINDER_WAYPOINT_CACHE_H_
+
+#include <map>
+#include <vector>
+
+#include "vec.h"
+#include "game_constants.h"
+
+namespace Glest { namespace Search {
+
+using std::map;
+using std::vector;
+using Shared::Math::Vec2i;
+using Glest::Sim::Field;
+
+class ClusterMap;
+struct Transition;
+
+// =====================================================
+// 	class WaypointCache
+// =====================================================
+/** Caches the transition route found by hierarchical searches, so units moving as a group
+  * between the same pair of clusters need only refine the route. An entry is discarded when
+  * any cluster it passes through (or a border of one) is made dirty. */
+class WaypointCache {
+public:
+	struct Key {
+		Field field;
+		int size;
+		Vec2i from, to;	/**< source and destination clusters */
+
+		Key(Field f, int size, const Vec2i &from, const Vec2i &to)
+				: field(f), size(size), from(from), to(to) {}
+		bool operator<(const Key &that) const;
+	};
+
+	/** maximum number of routes kept, least recently used are evicted first */
+	static const int maxEntries = 128;
+
+private:
+	struct Entry {
+		vector<Vec2i> waypoints;	/**< transition positions, source cluster first	  */
+		vector<Vec2i> clusters;		/**< clusters the route passes through		   */
+		int stamp;					/**< ClusterMap dirty count when route was found */
+		int lastUsed;				/**< frame entry was last used				 */
+	};
+	typedef map<Key, Entry> Entries;
+
+	Entries m_entries;
+	int m_hits, m_misses;
+
+	bool isValid(const Entry &entry) const;
+
+public:
+	WaypointCache() : m_hits(0), m_misses(0) {}
+
+	/** Look up a route
+	  * @param out_waypoints [out] the route's transition positions, source cluster first
+	  * @return true if a valid route was found */
+	bool lookup(const Key &key, int frame, vector<Vec2i> &out_waypoints);
+
+	/** Store a route @param route the transitions on the route, source cluster first */
+	void store(const Key &key, int frame, const vector<const Transition*> &route);
+
+	/** the route last looked up did not suit the unit after all, count it as a miss */
+	void rejectLookup() { --m_hits; ++m_misses; }
+
+	void clear() { m_entries.clear(); }
+
+	int getSize() const		{ return m_entries.size(); }
+	int getHits() const		{ return m_hits;	}
+	int getMisses() const	{ return m_misses;	}
+};
+
+}}
+
+#endif
@@ -36,6 +36,7 @@ const float SoundRenderer::audibleDist= 50.f;
 
 SoundRenderer::SoundRenderer(){
 	loadConfig();
+	soundPlayer = 0;
 	musicStream = 0;
 }
 
@@ -67,12 +68,17 @@ SoundRenderer &SoundRenderer::getInstance(){
 }
 
 void SoundRenderer::update(){
-	soundPlayer->updateStreams();
+	if (soundPlayer) {
+		soundPlayer->updateStreams();
+	}
 }
 
 // ======================= Music ============================
 
 void SoundRenderer::playMusic(StrSound *strSound){
+	if (!soundPlayer) {
+		return;
+	}
 	strSound->setVolume(musicVolume);
 	strSound->restart();
 	soundPlayer->play(strSound);
@@ -80,6 +86,9 @@ void SoundRenderer::playMusic(StrSound *strSound){
 }
 
 void SoundRenderer::stopMusic(StrSound *strSound){
+	if (!soundPlayer) {
+		return;
+	}
 	soundPlayer->stop(strSound);
 	musicStream = 0;
 }
@@ -94,7 +103,7 @@ void SoundRenderer::setMusicVolume(float v) {
 // ======================= Fx ============================
 
 void SoundRenderer::playFx(StaticSound *staticSound, Vec3f soundPos, Vec3f camPos){
-	if(staticSound!=NULL){
+	if(staticSound!=NULL && soundPlayer){
 		float d= soundPos.dist(camPos);
 
 		if(d<audibleDist){
@@ -107,7 +116,7 @@ void SoundRenderer::playFx(StaticSound *staticSound, Vec3f soundPos, Vec3f camPo
 }
 
 void SoundRenderer::playFx(StaticSound *staticSound){
-	if(staticSound!=NULL){
+	if(staticSound!=NULL && soundPlayer){
 		staticSound->setVolume(fxVolume);
 		soundPlayer->play(staticSound);
 	}
@@ -120,12 +129,18 @@ void SoundRenderer::setFxVolume(float v) {
 // ======================= Ambient ============================
 
 void SoundRenderer::playAmbient(StrSound *strSound){
+	if (!soundPlayer) {
+		return;
+	}
 	strSound->setVolume(ambientVolume);
 	soundPlayer->play(strSound, ambientFade);
 	ambientStreams.insert(strSound);
 }
 
 void SoundRenderer::stopAmbient(StrSound *strSound){
+	if (!soundPlayer) {
+		return;
+	}
 	soundPlayer->stop(strSound, ambientFade);
 	ambientStreams.erase(strSound);
 }
@@ -140,7 +155,9 @@ void SoundRenderer::setAmbientVolume(float v) {
 // ======================= Misc ============================
 
 void SoundRenderer::stopAllSounds(){
-	soundPlayer->stopAllSounds();
+	if (soundPlayer) {
+		soundPlayer->stopAllSounds();
+	}
 }
 
 void SoundRenderer::loadConfig(){
@@ -37,7 +37,7 @@ public:
 	static const int ambientFade;
 	static const float audibleDist;
 private:
-	SoundPlayer *soundPlayer;
+	SoundPlayer *soundPlayer;	/**< NULL if init() was not called, then all sound calls are no-ops */
 
 	//volume
 	float fxVolume;
@@ -32,6 +32,7 @@
 #include "cartographer.h"
 #include "annotated_map.h"
 #include "FSFactory.hpp"
+#include "map_file.h"
 
 #include "leak_dumper.h"
 #include "fixed.h"
@@ -145,44 +146,18 @@ void Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 		path2 = cutLastExt(path.substr(1, path.length()-1));
 	}
 
-	FileOps *f = FSFactory::getInstance()->getFileOps();
-
-	FSFactory::getInstance()->usePhysFS = old_phys;
-
-	struct MapFileHeader {
-		int32 version;
-		int32 maxPlayers;
-		int32 width;
-		int32 height;
-		int32 altFactor;
-		int32 waterLevel;
-		int8 title[128];
-		int8 author[128];
-		union {
-			int8 description[256];
-			struct {
-				int8 short_desc[128];
-				int32 magic; // 0x01020304 for meta
-				int8 meta[124];
-			};
-		};
-	};
-
 	name = basename(path2);
 
 	try {
-		if (fileExists(path2 + ".mgm")) {
-			f->openRead((path2 + ".mgm").c_str());
-		} else {
-			f->openRead((path2 + ".gbm").c_str());
+		// read the whole file, then copy out of it
+		MapFile mapFile;
+		string filePath = MapFile::findFile(path2);
+		if (filePath.empty()) {
+			throw runtime_error("Map file not found");
 		}
-
-		//read header
-		MapFileHeader header;
-		
-		// FIXME: Better error handling starting here: report bad map instead of partially loading,
-		// etc.
-		f->read(&header, sizeof(MapFileHeader), 1);
+		mapFile.load(filePath);
+		FSFactory::getInstance()->usePhysFS = old_phys;
+		const MapFileHeader &header = mapFile.header;
 
 		if (!isPowerOfTwo(header.width)) {
 			throw runtime_error("Map width is not a power of 2");
@@ -205,10 +180,7 @@ void Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 		//start locations
 		startLocations = new Vec2i[maxPlayers];
 		for (int i = 0; i < maxPlayers; ++i) {
-			int x, y;
-			f->read(&x, sizeof(int32), 1);
-			f->read(&y, sizeof(int32), 1);
-			startLocations[i] = Vec2i(x, y) * GameConstants::cellScale;
+			startLocations[i] = mapFile.startLocations[i] * GameConstants::cellScale;
 		}
 
 		// Tiles & Cells
@@ -217,29 +189,22 @@ void Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 
 		m_heightMap = new float[m_tileSize.w * m_tileSize.h];
 
-		//read heightmap
-		for (int y = 0; y < m_tileSize.h; ++y) {
-			for (int x = 0; x < m_tileSize.w; ++x) {
-				float32 alt;
-				f->read(&alt, sizeof(float32), 1);
-				m_heightMap[y * m_tileSize.w + x] = alt / heightFactor;
-			}
+		//heightmap & surfaces
+		const int tileCount = m_tileSize.w * m_tileSize.h;
+		const float32 *heights = &mapFile.heights[0];
+		const int8 *surfaces = &mapFile.surfaces[0];
+		for (int i = 0; i < tileCount; ++i) {
+			m_heightMap[i] = heights[i] / heightFactor;
 		}
-
-		//read surfaces
-		for (int y = 0; y < m_tileSize.h; ++y) {
-			for (int x = 0; x < m_tileSize.w; ++x) {
-				int8 surf;
-				f->read(&surf, sizeof(int8), 1);
-				getTile(x, y)->setTileType(surf - 1);
-			}
+		for (int i = 0; i < tileCount; ++i) {
+			tiles[i].setTileType(surfaces[i] - 1);
 		}
 
-		//read objects and resources
+		//objects and resources
+		const int8 *objects = &mapFile.objects[0];
 		for (int y = 0; y < m_tileSize.h; ++y) {
 			for (int x = 0; x < m_tileSize.w; ++x) {
-				int8 objNumber;
-				f->read(&objNumber, sizeof(int8), 1);
+				int8 objNumber = objects[y * m_tileSize.w + x];
 				Tile *tile = getTile(Vec2i(x, y));
 				Vec3f vert(x * cellScale + cellScale / 2.f, 0.f, y * cellScale + cellScale / 2.f);
 
@@ -262,11 +227,12 @@ void Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 				}
 			}
 		}
-		delete f;
 	} catch (const exception &e) {
-		delete f;
+		FSFactory::getInstance()->usePhysFS = old_phys;
 		delete [] cells;
 		delete [] tiles;
+		cells = NULL;
+		tiles = NULL;
 		throw MapException(path, "Error loading map: " + path + "\n" + e.what());
 	}
 }
@@ -292,6 +258,7 @@ void Map::doChecksum(Checksum &checksum) {
 void Map::init() {
 	g_logger.logProgramEvent("Heightmap computations", true);
 	m_vertexData = new MapVertexData(m_tileSize);
+	m_unitIndex.init(m_cellSize);
 	smoothSurface();
 	computeNormals();
 	computeInterpolatedHeights();
@@ -752,6 +719,7 @@ void Map::putUnitCells(Unit *unit, const Vec2i &pos){
 			}
 		}
 	}
+	m_unitIndex.add(unit, pos);
 	unit->setPos(pos);
 	ScriptManager::unitMoved(unit);
 }
@@ -775,6 +743,7 @@ void Map::clearUnitCells(Unit *unit, const Vec2i &pos){
 			}
 		}
 	}
+	m_unitIndex.remove(unit, pos);
 }
 
 // ==================== misc ====================
@@ -31,6 +31,7 @@
 #include "fixed.h"
 
 #include "unit.h"
+#include "unit_index.h"
 
 using namespace Shared::Math;
 using Shared::Graphics::Texture2D;
@@ -228,6 +229,7 @@ private:
 
 	float *m_heightMap;
 	MapVertexData *m_vertexData;
+	UnitIndex m_unitIndex;
 
 //	Earthquakes earthquakes;
 
@@ -293,6 +295,7 @@ public:
 	void setTileHeight(const Vec2i &pos, float h) { m_vertexData->get(pos).vert().y = h; }
 
 	MapVertexData* getVertexData() { return m_vertexData; }
+	const UnitIndex& getUnitIndex() const { return m_unitIndex; }
 	//const Earthquakes &getEarthquakes() const			{return earthquakes;}
 
 	//is
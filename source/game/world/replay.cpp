@@ -0,0 +1,223 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "replay.h"
+
+#include <cstring>
+
+#include "checksum.h"
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Sim {
+
+using Shared::Util::Checksum;
+
+// =====================================================
+//	class ReplayWriter
+// =====================================================
+
+const char ReplayWriter::magic[4] = { 'G', 'R', 'P', 'L' };
+
+ReplayWriter::ReplayWriter(const string &path, const GameSettings &settings,
+		const vector<int32> &aiSeeds, World &world)
+		: m_file(0)
+		, m_frame(0)
+		, m_lastRecord(0) {
+	m_writer.writeBytes(magic, sizeof(magic));
+	m_writer.writeUnsigned(version);
+	settings.save(m_writer);
+
+	m_writer.writeUnsigned(aiSeeds.size());
+	foreach_const (vector<int32>, it, aiSeeds) {
+		m_writer.writeInt32(*it);
+	}
+	DataSyncMessage dataSync(world);
+	m_writer.writeUnsigned(dataSync.getChecksumCount());
+	for (int i=0; i < dataSync.getChecksumCount(); ++i) {
+		m_writer.writeInt32(dataSync.getChecksum(i));
+	}
+
+	m_file = g_fileFactory.getFileOps();
+	try {
+		m_file->openWrite(path.c_str());
+	} catch (runtime_error &) {
+		delete m_file;
+		throw;
+	}
+	flush();
+}
+
+ReplayWriter::~ReplayWriter() {
+	try {
+		writeRecord(ReplayRecord::END, m_frame);
+		flush();
+	} catch (runtime_error &e) {
+		g_logger.logError(string("Error writing replay: ") + e.what());
+	}
+	delete m_file;
+}
+
+void ReplayWriter::endFrame(const World &world) {
+	m_frame = world.getFrameCount();
+	if (!m_commands.empty()) {
+		writeRecord(ReplayRecord::COMMANDS, m_frame);
+		m_writer.writeUnsigned(m_commands.size());
+		m_writer.writeBytes(&m_commands[0], m_commands.size() * sizeof(NetworkCommand));
+		m_commands.clear();
+	}
+	if (m_frame % checksumInterval == 0) {
+		Checksum checksum;
+		world.doChecksum(checksum);
+		writeRecord(ReplayRecord::CHECKSUM, m_frame);
+		m_writer.writeInt32(checksum.getSum());
+	}
+	if (m_writer.getSize() >= flushSize) {
+		flush();
+	}
+}
+
+void ReplayWriter::writeRecord(ReplayRecord tag, int frame) {
+	m_writer.writeUnsigned(tag);
+	m_writer.writeUnsigned(frame - m_lastRecord);
+	m_lastRecord = frame;
+}
+
+void ReplayWriter::flush() {
+	const vector<uint8> &data = m_writer.getData();
+	if (!data.empty() && m_file->write(&data[0], data.size(), 1) != 1) {
+		throw runtime_error("Error writing replay");
+	}
+	m_writer.clear();
+}
+
+// =====================================================
+//	class ReplayInterface
+// =====================================================
+
+ReplayInterface::ReplayInterface(Program &program, const string &path, bool watch)
+		: SimulationInterface(program)
+		, m_nextCommands(0)
+		, m_nextChecksum(0)
+		, m_endFrame(-1)
+		, m_divergedFrame(-1)
+		, m_watch(watch) {
+	m_recordReplay = false;
+
+	BinaryReader reader;
+	reader.load(path);
+	if (memcmp(reader.skip(sizeof(ReplayWriter::magic)), ReplayWriter::magic, sizeof(ReplayWriter::magic))) {
+		throw runtime_error(path + " is not a replay");
+	}
+	int fileVersion = reader.readUnsigned();
+	if (fileVersion != ReplayWriter::version) {
+		throw runtime_error(path + " is replay version " + intToStr(fileVersion) + ", expected "
+			+ intToStr(ReplayWriter::version));
+	}
+	gameSettings = GameSettings(reader);
+
+	m_aiSeeds.resize(reader.readUnsigned());
+	foreach (vector<int32>, it, m_aiSeeds) {
+		*it = reader.readInt32();
+	}
+	m_dataChecksums.resize(reader.readUnsigned());
+	foreach (vector<int32>, it, m_dataChecksums) {
+		*it = reader.readInt32();
+	}
+
+	int frame = 0;
+	while (m_endFrame == -1) {
+		ReplayRecord tag = enum_cast<ReplayRecord>(reader.readUnsigned());
+		frame += reader.readUnsigned();
+		switch (tag) {
+			case ReplayRecord::COMMANDS: {
+				m_commands.push_back(FrameCommands());
+				m_commands.back().frame = frame;
+				Commands &commands = m_commands.back().commands;
+				commands.resize(reader.readUnsigned());
+				if (!commands.empty()) {
+					reader.readBytes(&commands[0], commands.size() * sizeof(NetworkCommand));
+				}
+				break;
+			}
+			case ReplayRecord::CHECKSUM:
+				m_checksums.push_back(std::make_pair(frame, reader.readInt32()));
+				break;
+			case ReplayRecord::END:
+				m_endFrame = frame;
+				break;
+			default:
+				throw runtime_error(path + " has a bad record, at frame " + intToStr(frame));
+		}
+	}
+}
+
+void ReplayInterface::doDataSync() {
+	DataSyncMessage dataSync(*world);
+	if (dataSync.getChecksumCount() != int(m_dataChecksums.size())) {
+		throw runtime_error("The replay was recorded with different data, the prototype counts differ");
+	}
+	for (int i=0; i < dataSync.getChecksumCount(); ++i) {
+		if (dataSync.getChecksum(i) != m_dataChecksums[i]) {
+			throw runtime_error("The replay was recorded with different data, checksum " + intToStr(i)
+				+ " differs");
+		}
+	}
+}
+
+void ReplayInterface::syncAiSeeds(int aiCount, int *seeds) {
+	if (aiCount != int(m_aiSeeds.size())) {
+		throw runtime_error("The replay has " + intToStr(m_aiSeeds.size()) + " AI seeds, the game "
+			+ intToStr(aiCount) + " AI players");
+	}
+	std::copy(m_aiSeeds.begin(), m_aiSeeds.end(), seeds);
+}
+
+void ReplayInterface::frameProccessed() {
+	// the local player only watches
+	requestedCommands.clear();
+
+	int frame = world->getFrameCount();
+	if (m_nextCommands < m_commands.size() && m_commands[m_nextCommands].frame == frame) {
+		const Commands &commands = m_commands[m_nextCommands].commands;
+		std::copy(commands.begin(), commands.end(), std::back_inserter(pendingCommands));
+		++m_nextCommands;
+	}
+	if (m_nextChecksum < m_checksums.size() && m_checksums[m_nextChecksum].first == frame) {
+		Checksum checksum;
+		world->doChecksum(checksum);
+		int32 expected = m_checksums[m_nextChecksum].second;
+		if (checksum.getSum() != expected && m_divergedFrame == -1) {
+			m_divergedFrame = frame;
+			g_logger.logError("Replay diverged at frame " + intToStr(frame) + ", world checksum "
+				+ intToHex(checksum.getSum()) + ", recorded " + intToHex(expected));
+		}
+		++m_nextChecksum;
+	}
+	if (frame == m_endFrame && m_watch) {
+		g_console.addLine("End of replay");
+		pause();
+	}
+}
+
+void ReplayInterface::report(ostream &stream) const {
+	stream << "Replay: " << m_endFrame << " frames, " << m_nextChecksum << " of "
+		<< m_checksums.size() << " world checksums checked" << endl;
+	if (hasDiverged()) {
+		stream << "   Diverged at frame " << m_divergedFrame << endl;
+	} else {
+		stream << "   No divergence" << endl;
+	}
+}
+
+}}
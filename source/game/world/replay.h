@@ -0,0 +1,113 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GAME_REPLAY_H_
+#define _GAME_REPLAY_H_
+
+#include <ostream>
+#include <utility>
+
+#include "sim_interface.h"
+#include "binary_stream.h"
+
+namespace Glest { namespace Sim {
+
+using std::ostream;
+using std::pair;
+using Shared::Util::BinaryWriter;
+using Shared::Util::BinaryReader;
+
+/** Replay records, each is the tag, the frame delta from the last record, then the payload:
+  * COMMANDS a count and the raw commands given that frame, CHECKSUM a world checksum */
+WRAPPED_ENUM( ReplayRecord, COMMANDS, CHECKSUM, END )
+
+// =====================================================
+//	class ReplayWriter
+// =====================================================
+/** Records a game as it is played. The world is deterministic given the settings, the data, the
+  * AI seeds and the commands players give, so only those are kept. A replay file is a header
+  * (magic, version, game settings, AI seeds, data checksums) followed by records, with a world
+  * checksum every checksumInterval frames so playback can find where it diverges. */
+class ReplayWriter {
+public:
+	static const char magic[4];
+	static const int version = 2;
+	static const int checksumInterval = 100;	/**< world frames between checksums */
+	static const int flushSize = 64 * 1024;		/**< bytes buffered before writing */
+
+private:
+	FileOps *m_file;
+	BinaryWriter m_writer;
+	SimulationInterface::Commands m_commands;	/**< commands given this frame */
+	int m_frame;		/**< the last frame ended */
+	int m_lastRecord;	/**< frame of the last record written */
+
+public:
+	/** open the file and write the header @throws runtime_error */
+	ReplayWriter(const string &path, const GameSettings &settings, const vector<int32> &aiSeeds,
+		World &world);
+	/** write the end record and close the file */
+	~ReplayWriter();
+
+	/** add a command given by a player this frame */
+	void addCommand(const NetworkCommand &cmd)	{m_commands.push_back(cmd);}
+	/** write the frame's commands, and a world checksum if due */
+	void endFrame(const World &world);
+
+private:
+	void writeRecord(ReplayRecord tag, int frame);
+	void flush();
+};
+
+// =====================================================
+//	class ReplayInterface
+// =====================================================
+/** Plays a replay back, re-simulating the game from the recorded settings, AI seeds and commands.
+  * Anything the local player does is ignored. World checksums are compared to the recorded ones,
+  * the first mismatch is logged and reported. */
+class ReplayInterface : public SimulationInterface {
+private:
+	struct FrameCommands {
+		int frame;
+		Commands commands;
+	};
+	typedef vector<FrameCommands> FrameCommandList;
+	typedef vector< pair<int, int32> > Checksums;
+
+	vector<int32> m_aiSeeds;
+	vector<int32> m_dataChecksums;
+	FrameCommandList m_commands;
+	Checksums m_checksums;	/**< frame and world checksum */
+	size_t m_nextCommands;
+	size_t m_nextChecksum;
+	int m_endFrame;
+	int m_divergedFrame;	/**< frame of the first checksum mismatch, or -1 */
+	bool m_watch;			/**< rendered playback, pause at the end */
+
+public:
+	/** read a replay file and set the game settings from it @throws runtime_error */
+	ReplayInterface(Program &program, const string &path, bool watch);
+
+	int getEndFrame() const			{return m_endFrame;}
+	bool hasDiverged() const		{return m_divergedFrame != -1;}
+
+	/** write the checksums verified and where playback diverged, if it did */
+	void report(ostream &stream) const;
+
+protected:
+	virtual void doDataSync() override;
+	virtual void syncAiSeeds(int aiCount, int *seeds) override;
+	virtual void frameProccessed() override;
+};
+
+}}
+
+#endif
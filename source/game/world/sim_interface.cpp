@@ -12,6 +12,7 @@
 
 #include "client_interface.h"
 #include "server_interface.h"
+#include "replay.h"
 
 #include "profiler.h"
 #include "leak_dumper.h"
@@ -87,11 +88,16 @@ SimulationInterface::SimulationInterface(Program &program)
 		, speed(GameSpeed::NORMAL)
 		, m_prototypeFactory(0)
 		, m_skillCycleTable(0)
+		, m_aiSeed(-1)
+		, m_recordReplay(g_config.getGsRecordReplays())
+		, m_replayWriter(0)
+		, m_worldHash(0)
 		, m_processingCommand(CmdClass::NULL_COMMAND) {
 	m_prototypeFactory = new PrototypeFactory();
 }
 
 SimulationInterface::~SimulationInterface() {
+	delete m_replayWriter;
 	delete stats;
 	stats = 0;
 	delete m_gaia;
@@ -108,6 +114,7 @@ void SimulationInterface::constructGameWorld(GameState *g) {
 	world = new World(this);
 	stats = new Stats(this);
 	commander = new Commander(this);
+	m_worldHash = 0;
 	IF_MAD_SYNC_CHECKS(
 		worldLog = new WorldLog();
 	);
@@ -115,6 +122,8 @@ void SimulationInterface::constructGameWorld(GameState *g) {
 
 void SimulationInterface::destroyGameWorld() {
 	NETWORK_LOG( __FUNCTION__ );
+	delete m_replayWriter;
+	m_replayWriter = 0;
 	deleteValues(aiInterfaces.begin(), aiInterfaces.end());
 	aiInterfaces.clear();
 	delete world;
@@ -188,6 +197,7 @@ void SimulationInterface::initWorld() {
 	if (seeds) {
 		syncAiSeeds(aiCount, seeds);
 	}
+	vector<int32> aiSeeds(seeds, seeds + aiCount);
 	// create AIs
 	int seedCount = 0;
 	aiInterfaces.resize(world->getFactionCount());
@@ -213,6 +223,15 @@ void SimulationInterface::initWorld() {
 	doDataSync();
 
 	createSkillCycleTable(world->getTechTree());
+
+	// a saved game would need the world state recorded too
+	if (m_recordReplay && !savedGame) {
+		try {
+			m_replayWriter = new ReplayWriter("replays/last_game.rpl", gameSettings, aiSeeds, *world);
+		} catch (runtime_error &e) {
+			g_logger.logError(string("Could not record replay: ") + e.what());
+		}
+	}
 }
 
 /** @return maximum update backlog (must be -1 for multiplayer) */
@@ -250,6 +269,9 @@ bool SimulationInterface::updateWorld() {
 	// World
 	world->processFrame();
 	frameProccessed();
+	if (m_replayWriter) {
+		m_replayWriter->endFrame(*world);
+	}
 
 	// give pending commands
 	foreach (Commands, it, pendingCommands) {
@@ -410,8 +432,26 @@ void SimulationInterface::requestCommand(Command *command) {
 	g_world.deleteCommand(command);
 }
 
+void SimulationInterface::recordCommand(const NetworkCommand &cmd) {
+	if (m_replayWriter) {
+		m_replayWriter->addCommand(cmd);
+	}
+}
+
+/** pack a position into a word, map dimensions fit 16 bits */
+inline int32 packPos(const Vec2i &pos) {
+	return (pos.x << 16) | (pos.y & 0xFFFF);
+}
+
+void SimulationInterface::hashUnitState(const Unit *unit, int32 a, int32 b) {
+	m_worldHash = Checksum::combine(m_worldHash, (uint64(uint32(unit->getId())) << 32) | uint32(a));
+	m_worldHash = Checksum::combine(m_worldHash, uint32(b));
+}
+
 void SimulationInterface::doUpdateUnitCommand(Unit *unit) {
 	unit->doUpdateCommand();
+	hashUnitState(unit, unit->getCurrSkill()->getId(), unit->getHp());
+	hashUnitState(unit, packPos(unit->getPos()), packPos(unit->getNextPos()));
 	IF_MAD_SYNC_CHECKS(
 		UnitStateRecord usr(unit);
 		worldLog->addUnitRecord(usr);
@@ -432,6 +472,7 @@ void SimulationInterface::startFrame(int frame) {
 
 void SimulationInterface::doUpdateAnimOnDeath(Unit *unit) {
 	unit->doUpdateAnimOnDeath(m_skillCycleTable);
+	hashUnitState(unit, unit->getCurrSkill()->getId(), -1);
 }
 
 void SimulationInterface::doUpdateAnim(Unit *unit) {
@@ -443,6 +484,7 @@ void SimulationInterface::doUpdateAnim(Unit *unit) {
 
 void SimulationInterface::doUnitBorn(Unit *unit) {
 	unit->doUnitBorn(m_skillCycleTable);
+	hashUnitState(unit, unit->getType()->getId(), packPos(unit->getPos()));
 	
 	IF_MAD_SYNC_CHECKS(
 		postUnitBorn(unit);
@@ -451,6 +493,7 @@ void SimulationInterface::doUnitBorn(Unit *unit) {
 
 void SimulationInterface::doUpdateProjectile(Unit *u, Projectile *pps, const Vec3f &start, const Vec3f &end) {
 	updateProjectilePath(u, pps, start, end);
+	hashUnitState(u, pps->getEndFrame(), 0);
 	IF_MAD_SYNC_CHECKS(
 		postProjectileUpdate(u, pps->getEndFrame());
 	)
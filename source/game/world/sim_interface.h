@@ -104,6 +104,8 @@ using namespace Debug;
 
 namespace Sim {
 
+class ReplayWriter;
+
 WRAPPED_ENUM( QuitSource, LOCAL, SERVER )
 WRAPPED_ENUM( GameStatus, NO_CHANGE, LOST, WON )
 
@@ -201,6 +203,10 @@ protected:
 
 	PrototypeFactory *m_prototypeFactory;
 	SkillCycleTable *m_skillCycleTable;
+	int m_aiSeed; /**< seed for the AI random number seeds, -1 to seed from the clock */
+	bool m_recordReplay;			/**< record new games, from config */
+	ReplayWriter *m_replayWriter;	/**< non-zero while recording */
+	uint64 m_worldHash;				/**< rolling hash of unit state changes, see getWorldHash() */
 
 	IF_MAD_SYNC_CHECKS(
 		WorldLog *worldLog;
@@ -222,6 +228,14 @@ public:
 	const World *getWorld() const			{ return world; }
 	Stats* getStats()						{ return stats; }
 	bool getQuit() const					{ return quit; }
+
+	/** a hash of every unit state change so far (commands updated, units born and killed,
+	  * projectiles launched) in the order they happened, cheap enough to keep in every build.
+	  * Network games compare it each keyframe to catch desyncs. */
+	uint64 getWorldHash() const				{ return m_worldHash; }
+
+	/** fix the AI random number seeds, for reproducible runs @param seed -1 to seed from the clock */
+	void setAiSeed(int seed)				{ m_aiSeed = seed; }
 	
 	void setProcessingCommandClass(CmdClass cc = CmdClass::NULL_COMMAND) {
 		m_processingCommand = cc;
@@ -304,7 +318,7 @@ protected:
 	/** Create & Synchronise AI random number seeds */
 	virtual void syncAiSeeds(int aiCount, int *seeds) {
 		Random r;
-		r.init(Chrono::getCurMillis());
+		r.init(m_aiSeed == -1 ? int(Chrono::getCurMillis()) : m_aiSeed);
 		for (int i=0; i < aiCount; ++i) {
 			seeds[i] = r.rand();
 		}
@@ -318,10 +332,19 @@ protected:
 
 	/** Called after each world frame is processed, issues pending commands */
 	virtual void frameProccessed() {
+		foreach (Commands, it, requestedCommands) {
+			recordCommand(*it);
+		}
 		std::copy(requestedCommands.begin(), requestedCommands.end(), std::back_inserter(pendingCommands));
 		requestedCommands.clear();
 	}
 
+	/** Add a player's command to the replay, call for each one given, AI commands are not needed */
+	void recordCommand(const NetworkCommand &cmd);
+
+	/** fold a unit's change of state into the world hash */
+	void hashUnitState(const Unit *unit, int32 a, int32 b);
+
 	/** Called when a quit request is received */
 	virtual void quitGame(QuitSource) { }
 
@@ -22,32 +22,150 @@ namespace Glest { namespace Sim {
 using namespace ProtoTypes;
 
 // ===================================================================
-//  class EntityFactory, a factory class for transient instance types
+//  class ObjectPool, storage for objects of one type
 // ===================================================================
+/** Allocates raw storage for objects of type T in blocks, and recycles it. Storage is only
+  * returned to the heap when the pool is destroyed. */
+template<typename T> class ObjectPool {
+private:
+	union Slot {
+		char	storage[sizeof(T)];
+		Slot   *next;
+		double	alignDouble;
+		int64	alignInt64;
+	};
+	static const int blockSize = 256;
+
+	vector<Slot*>	m_blocks;
+	Slot		   *m_freeList;
+
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+
+public:
+	ObjectPool() : m_freeList(0) { }
+
+	~ObjectPool() {
+		for (typename vector<Slot*>::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+			delete [] *it;
+		}
+	}
+
+	void* allocate() {
+		if (!m_freeList) {
+			Slot *block = new Slot[blockSize];
+			m_blocks.push_back(block);
+			for (int i = blockSize - 1; i >= 0; --i) {
+				block[i].next = m_freeList;
+				m_freeList = &block[i];
+			}
+		}
+		Slot *slot = m_freeList;
+		m_freeList = slot->next;
+		return slot;
+	}
+
+	void release(void *ptr) {
+		Slot *slot = static_cast<Slot*>(ptr);
+		slot->next = m_freeList;
+		m_freeList = slot;
+	}
+};
 
+// ===================================================================
+//  class EntityFactory, a factory class for transient instance types
+// ===================================================================
+/** Ids are issued sequentially and never reused, so a stale id finds nothing. Lookup is by a
+  * paged table indexed by id, pages are released once every id in them is dead. Objects
+  * owned by the factory are constructed in pooled storage, unless MEMORY_CHECK is defined. */
 template<typename Entity> class EntityFactory {
 
 	friend class World; // needs to get and set id counters for save games
 
 private:
-	typedef std::map<int, Entity*>  ObjectTable;
-	typedef std::list<Entity*>      ObjectList;
+	typedef vector<Entity*> ObjectList;
+
+	static const int pageBits = 10;
+	static const int pageSize = 1 << pageBits;
+
+	/** placement new would bypass the classes' MEMORY_CHECK operator new/delete, so with
+	  * memory checking on every object gets its own allocation */
+#	ifdef MEMORY_CHECK
+	static const bool usePool = false;
+#	else
+	static const bool usePool = true;
+#	endif
+
+	struct Page {
+		Entity *objects[pageSize];
+		int     listIndex[pageSize]; /**< position of object in m_allObjs */
+		int     liveCount;
+
+		Page() : liveCount(0) { memset(objects, 0, sizeof(objects)); }
+	};
+	typedef vector<Page*> PageTable;
 
 private:
-	ObjectTable  m_objTable;
-	ObjectList   m_allObjs;
-	int          m_idCounter;
-	const bool   m_destoryObjects;
+	PageTable           m_pages;
+	ObjectList          m_allObjs;  /**< live objects, in no particular order */
+	ObjectPool<Entity>  m_pool;
+	int                 m_idCounter;
+	const bool          m_destoryObjects;
 
 private:
+	Page* getPage(int id) const {
+		unsigned ndx = unsigned(id) >> pageBits;
+		return ndx < m_pages.size() ? m_pages[ndx] : 0;
+	}
+
 	void registerInstance(Entity *obj) {
 		if (obj->getId() == -1) {
 			obj->setId(m_idCounter++);
 		} else {
-			RUNTIME_CHECK(m_objTable.find(obj->getId()) == m_objTable.end());
+			RUNTIME_CHECK(!getInstance(obj->getId()));
+			if (obj->getId() >= m_idCounter) {
+				m_idCounter = obj->getId() + 1;
+			}
+		}
+		const int id = obj->getId();
+		const unsigned ndx = unsigned(id) >> pageBits;
+		if (ndx >= m_pages.size()) {
+			m_pages.resize(ndx + 1, 0);
+		}
+		if (!m_pages[ndx]) {
+			m_pages[ndx] = new Page();
 		}
+		Page *page = m_pages[ndx];
+		page->objects[id & (pageSize - 1)] = obj;
+		page->listIndex[id & (pageSize - 1)] = m_allObjs.size();
+		++page->liveCount;
 		m_allObjs.push_back(obj);
-		m_objTable[obj->getId()] = obj;
+	}
+
+	void unregisterInstance(int id) {
+		Page *page = getPage(id);
+		const int ndx = page->listIndex[id & (pageSize - 1)];
+
+		// move last object into the vacated position
+		Entity *last = m_allObjs.back();
+		m_allObjs[ndx] = last;
+		getPage(last->getId())->listIndex[last->getId() & (pageSize - 1)] = ndx;
+		m_allObjs.pop_back();
+
+		page->objects[id & (pageSize - 1)] = 0;
+		if (--page->liveCount == 0) {
+			m_pages[unsigned(id) >> pageBits] = 0;
+			delete page;
+		}
+	}
+
+	void destroy(Entity *obj) {
+		if (m_destoryObjects && usePool) {
+			obj->~Entity();
+			m_pool.release(obj);
+		} else {
+			delete obj;
+		}
 	}
 
 protected:
@@ -57,17 +175,28 @@ protected:
 public:
 	template <typename Arg1>
 	Entity* newInstance(Arg1 a1) {
-		Entity *newbie = new Entity(a1);
+		Entity *newbie;
+		if (m_destoryObjects && usePool) {
+			void *mem = m_pool.allocate();
+			try {
+				newbie = ::new (mem) Entity(a1);
+			} catch (...) {
+				m_pool.release(mem);
+				throw;
+			}
+		} else {
+			// objects not owned by the factory are deleted elsewhere, by destroy() otherwise
+			newbie = new Entity(a1);
+		}
 		registerInstance(newbie);
 		return newbie;
 	}
 
 	void deleteInstance(int id) {
-		typename ObjectTable::iterator it = m_objTable.find(id);
-		RUNTIME_CHECK(it != m_objTable.end());
-		m_allObjs.erase(std::find(m_allObjs.begin(), m_allObjs.end(), it->second));
-		delete it->second;
-		m_objTable.erase(it);
+		Entity *obj = getInstance(id);
+		RUNTIME_CHECK(obj != 0);
+		unregisterInstance(id);
+		destroy(obj);
 	}
 
 	void deleteInstance(const Entity *ptr) {
@@ -80,20 +209,19 @@ public:
 	virtual ~EntityFactory() {
 		if (m_destoryObjects) {
 			for (typename ObjectList::iterator it = m_allObjs.begin(); it != m_allObjs.end(); ++it) {
-				delete *it;
+				destroy(*it);
 			}
 		}
+		for (typename PageTable::iterator it = m_pages.begin(); it != m_pages.end(); ++it) {
+			delete *it;
+		}
 	}
 
 	unsigned getInstanceCount() const { return m_allObjs.size(); }
 
 	Entity* getInstance(int id) {
-		typename ObjectTable::iterator it = m_objTable.find(id);
-		if (it != m_objTable.end()) {
-			return it->second;
-		} else {
-			return 0;
-		}
+		Page *page = getPage(id);
+		return page ? page->objects[id & (pageSize - 1)] : 0;
 	}
 
 	typename ObjectList::const_iterator begin() const { return m_allObjs.begin(); }
@@ -0,0 +1,120 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+
+#include <algorithm>
+
+#include "unit_index.h"
+#include "unit.h"
+#include "unit_type.h"
+
+#include "leak_dumper.h"
+
+namespace Glest { namespace Sim {
+
+// =====================================================
+// 	class UnitIndex
+// =====================================================
+
+bool UnitIndex::Result::operator<(const Result &that) const {
+	if (dist == that.dist) {
+		return unit->getId() < that.unit->getId();
+	}
+	return dist < that.dist;
+}
+
+void UnitIndex::init(const Vec2i &cellDims) {
+	m_sectorDims = Vec2i((cellDims.w + sectorSize - 1) / sectorSize, (cellDims.h + sectorSize - 1) / sectorSize);
+	m_teamSlots = GameConstants::maxPlayers + 1;
+	m_maxUnitSize = 1;
+	m_buckets.clear();
+	m_buckets.resize(m_teamSlots * m_sectorDims.w * m_sectorDims.h);
+}
+
+void UnitIndex::clear() {
+	m_buckets.clear();
+	m_sectorDims = Vec2i(0);
+	m_teamSlots = 0;
+}
+
+void UnitIndex::add(Unit *unit, const Vec2i &pos) {
+	assert(unit->getTeam() >= -1 && unit->getTeam() < m_teamSlots - 1);
+	getBucket(unit->getTeam(), pos).push_back(unit);
+	if (unit->getSize() > m_maxUnitSize) {
+		m_maxUnitSize = unit->getSize();
+	}
+}
+
+void UnitIndex::remove(Unit *unit, const Vec2i &pos) {
+	Bucket &bucket = getBucket(unit->getTeam(), pos);
+	Bucket::iterator it = std::find(bucket.begin(), bucket.end(), unit);
+	assert(it != bucket.end());
+	if (it != bucket.end()) {
+		*it = bucket.back();
+		bucket.pop_back();
+	}
+}
+
+/** @return the truncated distance from pos to the nearest cell occupied by unit,
+  * matching the distances produced by PosCircularIteratorFactory */
+static fixed nearestCellDist(const Unit *unit, const Vec2i &pos) {
+	const UnitType *ut = unit->getType();
+	const Vec2i &uPos = unit->getPos();
+	int best;
+	if (ut->hasCellMap()) {
+		best = std::numeric_limits<int>::max();
+		for (int y = 0; y < ut->getSize(); ++y) {
+			for (int x = 0; x < ut->getSize(); ++x) {
+				if (ut->getCellMapCell(x, y, unit->getModelFacing())) {
+					Vec2i d = uPos + Vec2i(x, y) - pos;
+					best = std::min(best, d.x * d.x + d.y * d.y);
+				}
+			}
+		}
+	} else {
+		Vec2i d(clamp(pos.x, uPos.x, uPos.x + ut->getSize() - 1) - pos.x,
+				clamp(pos.y, uPos.y, uPos.y + ut->getSize() - 1) - pos.y);
+		best = d.x * d.x + d.y * d.y;
+	}
+	return fixed(int(sqrtf(float(best))));
+}
+
+void UnitIndex::findEnemies(int team, const Vec2i &pos, int range, Results &out_results) const {
+	// a unit is bucketed by its north-west cell, so extend the search back by the largest unit size
+	const int margin = m_maxUnitSize - 1;
+	const Vec2i tl(std::max(0, (pos.x - range - margin) / sectorSize),
+	               std::max(0, (pos.y - range - margin) / sectorSize));
+	const Vec2i br(std::min(m_sectorDims.w - 1, (pos.x + range) / sectorSize),
+	               std::min(m_sectorDims.h - 1, (pos.y + range) / sectorSize));
+	const int sectorCount = m_sectorDims.w * m_sectorDims.h;
+
+	for (int slot = 0; slot < m_teamSlots; ++slot) {
+		if (slot - 1 == team) {
+			continue;
+		}
+		const int base = slot * sectorCount;
+		for (int y = tl.y; y <= br.y; ++y) {
+			for (int x = tl.x; x <= br.x; ++x) {
+				const Bucket &bucket = m_buckets[base + y * m_sectorDims.w + x];
+				foreach_const (Bucket, it, bucket) {
+					fixed dist = nearestCellDist(*it, pos);
+					if (dist <= range) {
+						out_results.push_back(Result(*it, dist));
+					}
+				}
+			}
+		}
+	}
+	std::sort(out_results.begin(), out_results.end());
+}
+
+}} // end namespace Glest::Sim
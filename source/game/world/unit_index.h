@@ -0,0 +1,88 @@
+// ==============================================================
+//	This file is part of Glest (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_UNIT_INDEX_H_
+#define _GLEST_GAME_UNIT_INDEX_H_
+
+#include <vector>
+
+#include "vec.h"
+#include "fixed.h"
+#include "game_constants.h"
+
+#include "forward_decs.h"
+
+namespace Glest { namespace Sim {
+
+using std::vector;
+using Shared::Math::Vec2i;
+using Shared::Math::fixed;
+using Entities::Unit;
+
+// =====================================================
+// 	class UnitIndex
+//
+/// Spatial index of the units occupying map cells, bucketed by team and sector
+// =====================================================
+
+class UnitIndex {
+public:
+	/** A unit found by a range query and its distance (in cells) from the query position */
+	struct Result {
+		Unit  *unit;
+		fixed  dist;
+
+		Result(Unit *u, fixed d) : unit(u), dist(d) {}
+		bool operator<(const Result &that) const;
+	};
+	typedef vector<Result> Results;
+
+	/** sector size in cells, a sight range of 10-15 cells should touch at most 5x5 sectors */
+	static const int sectorSize = 8;
+
+private:
+	typedef vector<Unit*> Bucket;
+
+	/** buckets, indexed [team slot][sector], team slot 0 is reserved for the glestimals (team -1) */
+	vector<Bucket>  m_buckets;
+	Vec2i           m_sectorDims;
+	int             m_teamSlots;
+	int             m_maxUnitSize;
+
+	int sectorIndex(const Vec2i &cellPos) const {
+		return (cellPos.y / sectorSize) * m_sectorDims.w + cellPos.x / sectorSize;
+	}
+	Bucket& getBucket(int team, const Vec2i &cellPos) {
+		return m_buckets[(team + 1) * m_sectorDims.w * m_sectorDims.h + sectorIndex(cellPos)];
+	}
+
+public:
+	UnitIndex() : m_sectorDims(0), m_teamSlots(0), m_maxUnitSize(1) {}
+
+	void init(const Vec2i &cellDims);
+	void clear();
+
+	/** Adds a unit to the index, called from Map::putUnitCells() @param pos the unit's new position */
+	void add(Unit *unit, const Vec2i &pos);
+	/** Removes a unit from the index, called from Map::clearUnitCells() @param pos the unit's old position */
+	void remove(Unit *unit, const Vec2i &pos);
+
+	/** Find all units not on team that are within range of pos.
+	  * @param team team index of the searching unit, units of this team are excluded
+	  * @param pos cell co-ordinates to search from
+	  * @param range maximum distance (in cells, truncated) from pos to any cell the unit occupies
+	  * @param out_results [out] the units found, sorted nearest first (ties broken by unit id) */
+	void findEnemies(int team, const Vec2i &pos, int range, Results &out_results) const;
+};
+
+}} // end namespace Glest::Sim
+
+#endif
@@ -75,6 +75,8 @@ World::World(SimulationInterface *simInterface)
 		, cartographer(0)
 		, routePlanner(0)
 		, thisFactionIndex(-1)
+		, m_fowAlphaMap(0)
+		, m_fowSectorDims(0)
 		, posIteratorFactory(65)
 		, m_cloakGroupIdCounter(0) {
 	GameSettings &gs = m_simInterface->getGameSettings();
@@ -101,6 +103,7 @@ World::~World() {
 	delete scenario;
 	delete cartographer;
 	delete routePlanner;
+	delete m_fowAlphaMap;
 
 	singleton = 0;
 }
@@ -141,6 +144,12 @@ void World::init(const XmlNode *worldNode) {
 	} else {
 		g_userInterface.initMinimap(fogOfWar, shroudOfDarkness, false);
 	}
+	m_fowAlphaMap = new TypeMap<float>(Rectangle(0, 0, map.getTileW(), map.getTileH()), 0.f);
+	m_fowAlphaMap->clearMap(numeric_limits<float>::infinity());
+	m_fowSectorDims = Vec2i((map.getTileW() + fowSectorSize - 1) / fowSectorSize,
+		(map.getTileH() + fowSectorSize - 1) / fowSectorSize);
+	m_fowDirtySectors.assign(m_fowSectorDims.w * m_fowSectorDims.h, true);
+	cartographer->initVisibility();
 	computeFow();
 	alive = true;
 }
@@ -225,7 +234,9 @@ bool World::loadTech() {
 			names.insert(gs.getFactionTypeName(i));
 		}
 	}
-	return techTree.load(gs.getTechPath(), names);
+	m_assetLoader.begin();
+	bool loadOk = techTree.load(gs.getTechPath(), names);
+	return m_assetLoader.end() && loadOk;
 }
 
 //load map
@@ -306,11 +317,33 @@ void World::updateUnits(const Faction *f) {
 	}
 }
 
+void World::doChecksum(Checksum &checksum) const {
+	checksum.add<int>(frameCount);
+	for (int i=0; i < getFactionCount(); ++i) {
+		const Faction *f = getFaction(i);
+		for (int j=0; j < techTree.getResourceTypeCount(); ++j) {
+			checksum.add<int>(f->getResource(j)->getAmount());
+		}
+		checksum.add<int>(f->getUnitCount());
+		for (int j=0; j < f->getUnitCount(); ++j) {
+			const Unit *unit = f->getUnit(j);
+			checksum.add<int>(unit->getId());
+			checksum.add<int>(unit->getType()->getId());
+			checksum.add<int>(unit->getCurrSkill()->getId());
+			checksum.add<Vec2i>(unit->getPos());
+			checksum.add<int>(unit->getHp());
+			checksum.add<int>(unit->getEp());
+			checksum.add<int>(unit->getKills());
+		}
+	}
+}
+
 void World::processFrame() {
 	//_PROFILE_FUNCTION);
 
 	++frameCount;
 	m_simInterface->startFrame(frameCount);
+	routePlanner->newFrame();
 	g_userInterface.getMinimap()->update(frameCount);
 
 	// check ScriptTimers
@@ -356,6 +389,7 @@ void World::processFrame() {
 		computeFow();
 		tick();
 	}
+	tickUnits(frameCount % WORLD_FPS);
 }
 
 void World::hit(Unit *attacker) {
@@ -514,10 +548,23 @@ void World::tick() {
 
 	cartographer->tick();
 
-	//apply regen/degen
+	// consumable balances are kept up to date as units are born, die and morph
 	for (int i = 0; i < getFactionCount(); ++i) {
-		for (int j = 0; j < getFaction(i)->getUnitCount(); ++j) {
-			Unit *unit = getFaction(i)->getUnit(j);
+		getFaction(i)->publishResourceBalances();
+	}
+}
+
+/** Unit::tick() (regen/degen, command & effect ticks) is done once a second for each unit, spread
+  * over the frames by unit id so there is no spike every WORLD_FPS frames.
+  * @param phase the frame within the second, units with (id % WORLD_FPS == phase) are ticked */
+void World::tickUnits(int phase) {
+	for (int i = 0; i < getFactionCount(); ++i) {
+		Faction *faction = getFaction(i);
+		for (int j = 0; j < faction->getUnitCount(); ++j) {
+			Unit *unit = faction->getUnit(j);
+			if (unit->getId() % WORLD_FPS != phase) {
+				continue;
+			}
 			Unit *killer = unit->tick();
 
 			assert((unit->getHp() == 0 && unit->isDead()) || (unit->getHp() > 0 && unit->isAlive()));
@@ -526,35 +573,6 @@ void World::tick() {
 			}
 		}
 	}
-
-	///@todo foreach(Factions, f, factions) { (*f)->computeResourceBalances(); }
-
-	//compute resources balance
-	for (int k = 0; k < getFactionCount(); ++k) {
-		Faction *faction = getFaction(k);
-
-		//for each resource
-		for (int i = 0; i < techTree.getResourceTypeCount(); ++i) {
-			const ResourceType *rt = techTree.getResourceType(i);
-
-			//if consumable
-			if (rt->getClass() == ResourceClass::CONSUMABLE) {
-				int balance = 0;
-				for (int j = 0; j < faction->getUnitCount(); ++j) {
-
-					//if unit operative and has this cost
-					const Unit *u =  faction->getUnit(j);
-					if (u->isOperative()) {
-						ResourceAmount r = u->getType()->getCost(rt, faction);
-						if (r.getType()) {
-							balance -= r.getAmount();
-						}
-					}
-				}
-				faction->setResourceBalance(rt, balance);
-			}
-		}
-	}
 }
 
 const UnitType* World::findUnitTypeById(const FactionType* factionType, int id) {
@@ -1107,67 +1125,132 @@ void World::doUnfog() {
 	--unfogTTL;
 	if (!unfogTTL) {
 		unfogActive = false;
+		cartographer->restoreVisibility(thisTeamIndex, start, end);
 	}
 }
 
-void World::exploreCells(const Vec2i &newPos, int sightRange, int teamIndex) {
+/** Mark the minimap FoW sectors a unit's sight (plus indirect sight) covers as needing re-rasterising
+  * @param cellPos the unit's position @param sightRange the unit's sight range */
+void World::markFowDirty(const Vec2i &cellPos, int sightRange) {
+	if (m_fowDirtySectors.empty()) {
+		return; // not initialised yet, everything will be rasterised on init
+	}
+	const int range = sightRange + indirectSightRange;
+	const int sectorCells = fowSectorSize * GameConstants::cellScale;
+	const int x0 = std::max(0, (cellPos.x - range) / sectorCells);
+	const int y0 = std::max(0, (cellPos.y - range) / sectorCells);
+	const int x1 = std::min(m_fowSectorDims.w - 1, (cellPos.x + range) / sectorCells);
+	const int y1 = std::min(m_fowSectorDims.h - 1, (cellPos.y + range) / sectorCells);
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			m_fowDirtySectors[y * m_fowSectorDims.w + x] = true;
+		}
+	}
+}
 
-	Vec2i newSurfPos = Map::toTileCoords(newPos);
-	int surfSightRange = sightRange / GameConstants::cellScale + 1;
-	int sweepRange = surfSightRange + indirectSightRange + 1;
+/** re-compute the FoW alpha values for tiles in dirty sectors, from this team's units */
+void World::rasteriseFowAlpha() {
+	const int sectorCells = fowSectorSize * GameConstants::cellScale;
+	bool anyDirty = false;
+	for (int sy = 0; sy < m_fowSectorDims.h; ++sy) {
+		for (int sx = 0; sx < m_fowSectorDims.w; ++sx) {
+			if (m_fowDirtySectors[sy * m_fowSectorDims.w + sx]) {
+				anyDirty = true;
+				RectIterator iter(Vec2i(sx, sy) * fowSectorSize, Vec2i(sx + 1, sy + 1) * fowSectorSize - Vec2i(1));
+				while (iter.more()) {
+					m_fowAlphaMap->setInfluence(iter.next(), numeric_limits<float>::infinity());
+				}
+			}
+		}
+	}
+	if (!anyDirty) {
+		return;
+	}
+	for (int i = 0; i < getFactionCount(); ++i) {
+		Faction *faction = getFaction(i);
+		if (faction->getTeam() != thisTeamIndex) {
+			continue;
+		}
+		for (int j = 0; j < faction->getUnitCount(); ++j) {
+			const Unit *unit = faction->getUnit(j);
+			if (!unit->isOperative() || unit->isCarried()) {
+				continue;
+			}
+			int sightRange = unit->getSight();
+			const Vec2i &uPos = unit->getPos();
+			const int range = sightRange + indirectSightRange;
+
+			// skip units that don't touch a dirty sector
+			bool touchesDirty = false;
+			const int x0 = std::max(0, (uPos.x - range) / sectorCells);
+			const int y0 = std::max(0, (uPos.y - range) / sectorCells);
+			const int x1 = std::min(m_fowSectorDims.w - 1, (uPos.x + range) / sectorCells);
+			const int y1 = std::min(m_fowSectorDims.h - 1, (uPos.y + range) / sectorCells);
+			for (int y = y0; y <= y1 && !touchesDirty; ++y) {
+				for (int x = x0; x <= x1 && !touchesDirty; ++x) {
+					touchesDirty = m_fowDirtySectors[y * m_fowSectorDims.w + x];
+				}
+			}
+			if (!touchesDirty) {
+				continue;
+			}
+			Vec2i pos;
+			float distance;
+
+			//iterate through all cells
+			PosCircularIteratorSimple pci(map.getBounds(), uPos, range);
+			while (pci.getNext(pos, distance)) {
+				Vec2i surfPos = Map::toTileCoords(pos);
+				if (!m_fowDirtySectors[(surfPos.y / fowSectorSize) * m_fowSectorDims.w + surfPos.x / fowSectorSize]) {
+					continue;
+				}
+				float curr = m_fowAlphaMap->getInfluence(surfPos);
+				if (curr == 1.f) {
+					continue; // already max
+				}
 
-	//explore
-	for (int x = -sweepRange; x <= sweepRange; ++x) {
-		for (int y = -sweepRange; y <= sweepRange; ++y) {
-			Vec2i currRelPos(x, y);
-			Vec2i currPos = newSurfPos + currRelPos;
+				// compute max alpha
+				float maxAlpha;
+				if (surfPos.x > 1 && surfPos.y > 1 && surfPos.x < map.getTileW() - 2 && surfPos.y < map.getTileH() - 2) {
+					// strictly inside map
+					maxAlpha = 1.f;
+				} else {
+					// map boundary
+					maxAlpha = 0.f;
+					if (curr == 0.3f) {
+						continue; // already max
+					}
+				}
 
-			if (map.isInsideTile(currPos)) {
-				float dist = currRelPos.length();
-				Tile *sc = map.getTile(currPos);
+				// compute alpha
+				float alpha;
 
-				// explore
-				if (shroudOfDarkness && dist < sweepRange) {
-					sc->setExplored(teamIndex, true);
+				if (distance > sightRange) {
+					alpha = clamp(1.f - (distance - sightRange) / (indirectSightRange), 0.f, maxAlpha);
+				} else {
+					alpha = maxAlpha;
 				}
-
-				// visible
-				if (dist < surfSightRange) {
-					sc->setVisible(teamIndex, true);
+				if (alpha != 0.f && (curr == numeric_limits<float>::infinity() || alpha > curr)) {
+					m_fowAlphaMap->setInfluence(surfPos, alpha);
 				}
 			}
 		}
 	}
+	m_fowDirtySectors.assign(m_fowDirtySectors.size(), false);
 }
 
 //computes the fog of war texture, contained in the minimap
 void World::computeFow() {
-	//GameSettings &gs = m_simInterface->getGameSettings();
-	
 	///@todo move to Minimap
 	//reset texture
 	Minimap *minimap = g_userInterface.getMinimap();
 	minimap->resetFowTex();
 
-	// reset visibility in cells		
-	for (int i = 0; i < map.getTileW(); ++i) {
-		for (int j = 0; j < map.getTileH(); ++j) {
-			Tile *tile = map.getTile(i, j);
-			for (int k = 0; k < GameConstants::maxPlayers; ++k) {
-				bool val =			// if no fog and no shroud, or no fog and shroud with this 
-					(!fogOfWar		// tile seen previously, then set visible
-					&& (!shroudOfDarkness || (shroudOfDarkness && tile->isExplored(k))));
-				tile->setVisible(k, val);
-			}
-		}
-	}
-	// explore cells
+	// bring unit visibility up to date, tile visibility is otherwise maintained incrementally
+	// by the Cartographer as units are born, move between tiles and die
 	for (int i = 0; i < getFactionCount(); ++i) {
 		for (int j = 0; j < getFaction(i)->getUnitCount(); ++j) {
-			Unit *unit = getFaction(i)->getUnit(j);
-			if (unit->isOperative() && !unit->isCarried()) {
-				exploreCells(unit->getCenteredPos(), unit->getSight(), unit->getTeam());
-			}
+			cartographer->updateUnitVisibility(getFaction(i)->getUnit(j));
 		}
 	}
 	// turn fires on/off (redundant ? all particle-systems now subjected to visibilty checks)
@@ -1186,63 +1269,11 @@ void World::computeFow() {
 	if (unfogActive) { // scripted map reveal
 		doUnfog();
 	}
-	Rectangle rect(0,0, map.getTileW(), map.getTileH());
-	TypeMap<> tmpMap(rect, numeric_limits<float>::infinity());
-	tmpMap.clearMap(numeric_limits<float>::infinity());
-	for (int i = 0; i < getFactionCount(); ++i) {
-		Faction *faction = getFaction(i);
-		if (faction->getTeam() != thisTeamIndex) {
-			continue;
-		}
-		for (int j = 0; j < faction->getUnitCount(); ++j) {
-			const Unit *unit = faction->getUnit(j);
-			if (unit->isOperative() && !unit->isCarried()) {
-				int sightRange = unit->getSight();
-				Vec2i pos;
-				float distance;
-
-				//iterate through all cells
-				PosCircularIteratorSimple pci(map.getBounds(), unit->getPos(), sightRange + indirectSightRange);
-				while (pci.getNext(pos, distance)) {
-					Vec2i surfPos = Map::toTileCoords(pos);
-					float curr = tmpMap.getInfluence(surfPos);
-					if (curr == 1.f) {
-						continue; // already max
-					}
-
-					// compute max alpha
-					float maxAlpha;
-					if (surfPos.x > 1 && surfPos.y > 1 && surfPos.x < map.getTileW() - 2 && surfPos.y < map.getTileH() - 2) {
-						// strictly inside map
-						maxAlpha = 1.f;
-					} else {
-						// map boundary
-						maxAlpha = 0.f;
-						if (tmpMap.getInfluence(surfPos) == 0.3f) {
-							continue; // already max
-						}
-					}
-
-					// compute alpha
-					float alpha;
-
-					if (distance > sightRange) {
-						alpha = clamp(1.f - (distance - sightRange) / (indirectSightRange), 0.f, maxAlpha);
-					} else {
-						alpha = maxAlpha;
-					}
-					if (alpha != 0.f && (curr == numeric_limits<float>::infinity() || alpha > curr)) {
-						tmpMap.setInfluence(surfPos, alpha);
-					}
-					//minimap->incFowTextureAlphaSurface(surfPos, alpha);
-				}
-			}
-		}
-	}
-	RectIterator iter(Vec2i(0,0), Vec2i(rect.w - 1, rect.h - 1));
+	rasteriseFowAlpha();
+	RectIterator iter(Vec2i(0,0), Vec2i(map.getTileW() - 1, map.getTileH() - 1));
 	while (iter.more()) {
 		Vec2i tPos = iter.next();
-		float val = tmpMap.getInfluence(tPos);
+		float val = m_fowAlphaMap->getInfluence(tPos);
 		if (val != numeric_limits<float>::infinity()) {
 			minimap->incFowTextureAlphaSurface(tPos, val);
 		} else if (!shroudOfDarkness) {
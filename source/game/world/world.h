@@ -31,6 +31,7 @@
 #include "game_constants.h"
 #include "pos_iterator.h"
 #include "type_factories.h"
+#include "asset_loader.h"
 #include "command.h"
 #include "upgrade.h"
 
@@ -209,6 +210,12 @@ private:
 	int unfogTTL;
 	Vec4i unfogArea;
 
+	// minimap FoW alpha for this team, only sectors touched by a change in unit visibility are re-rasterised
+	static const int fowSectorSize = 8; // in tiles
+	TypeMap<float> *m_fowAlphaMap;
+	vector<bool>    m_fowDirtySectors;
+	Vec2i           m_fowSectorDims;
+
 	static World *singleton;
 	bool alive;
 
@@ -217,6 +224,7 @@ private:
 	PosCircularIteratorFactory posIteratorFactory;
 
 	ModelFactory			 m_modelFactory;
+	AssetLoader				 m_assetLoader;
 
 	// cloaking groups
 	CloakGroupIdMap      m_cloakGroupIds;
@@ -233,6 +241,7 @@ public:
 	static bool isConstructed() { return singleton != 0; }
 
 	ModelFactory& getModelFactory()						{return m_modelFactory;}
+	AssetLoader& getAssetLoader()						{return m_assetLoader;}
 
 	int getMaxPlayers() const						{return map.getMaxPlayers();}
 	int getThisFactionIndex() const					{return thisFactionIndex;}
@@ -256,6 +265,8 @@ public:
 	Faction *getGlestimals()						{return &glestimals;}
 	const WaterEffects *getWaterEffects() const		{return &waterEffects;}
 	int getFrameCount() const						{return frameCount;}
+	bool getFogOfWar() const						{return fogOfWar;}
+	bool getShroudOfDarkness() const				{return shroudOfDarkness;}
 	static World *getCurrWorld()					{return singleton;}
 	bool isAlive() const							{return alive;}
 	const PosCircularIteratorFactory &getPosIteratorFactory() const {return posIteratorFactory;}
@@ -279,6 +290,9 @@ public:
 	// update
 	void processFrame();
 
+	/** add the simulation state (resources, units) to checksum, for comparing runs */
+	void doChecksum(Checksum &checksum) const;
+
 	//misc
 	void moveUnitCells(Unit *unit);
 	Unit* findUnitById(int id) { return getUnit(id); }
@@ -315,6 +329,7 @@ public:
 	int getUnitCountOfType(int factionIndex, const string &typeName);
 
 	void unfogMap(const Vec4i &rect, int time);
+	void markFowDirty(const Vec2i &cellPos, int sightRange);
 
 #ifdef _GAE_DEBUG_EDITION_
 	// these should be in DebugRenderer
@@ -331,9 +346,10 @@ private:
 	//misc
 	//void updateEarthquakes(float seconds);
 	void tick();
+	void tickUnits(int phase);
 	void computeFow();
+	void rasteriseFowAlpha();
 	void doUnfog();
-	void exploreCells(const Vec2i &newPos, int sightRange, int teamIndex);
 	void loadSaved(const XmlNode *worldNode);
 	void moveAndEvict(Unit *unit, vector<Unit*> &evicted, Vec2i *oldPos);
 	void updateUnits(const Faction *f);
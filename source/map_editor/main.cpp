@@ -443,6 +443,10 @@ void MainWindow::setExtension() {
 		return;
 	}
 	string extnsn = ext(currentFile);
+	if (extnsn == "gbmz") {
+		// compressed maps hold any number of players
+		return;
+	}
 	if (extnsn == "gbm" || extnsn == "mgm") {
 		currentFile = cutLastExt(currentFile);
 	}
@@ -539,7 +543,7 @@ void MainWindow::onMenuFileNew(wxCommandEvent &event){
 void MainWindow::onMenuFileLoad(wxCommandEvent &event) {
 	if (checkChanges()) {
 		wxFileDialog fileDialog(this);
-		fileDialog.SetWildcard(wxT("Glest Map (*.gbm)|*.gbm|Mega Map (*.mgm)|*.mgm"));
+		fileDialog.SetWildcard(wxT("Glest Map (*.gbm)|*.gbm|Mega Map (*.mgm)|*.mgm|Compressed Map (*.gbmz)|*.gbmz"));
 		if (fileDialog.ShowModal() == wxID_OK) {
 			currentFile = fileDialog.GetPath().ToAscii();
 			program->loadMap(currentFile);
@@ -565,8 +569,8 @@ void MainWindow::onMenuFileSave(wxCommandEvent &event) {
 }
 
 void MainWindow::onMenuFileSaveAs(wxCommandEvent &event) {
-	wxFileDialog fileDialog(this, wxT("Select file"), wxT(""), wxT(""), wxT("*.gbm|*.mgm"), wxSAVE);
-	fileDialog.SetWildcard(wxT("Glest Map (*.gbm)|*.gbm|Mega Map (*.mgm)|*.mgm"));
+	wxFileDialog fileDialog(this, wxT("Select file"), wxT(""), wxT(""), wxT("*.gbm|*.mgm|*.gbmz"), wxSAVE);
+	fileDialog.SetWildcard(wxT("Glest Map (*.gbm)|*.gbm|Mega Map (*.mgm)|*.mgm|Compressed Map (*.gbmz)|*.gbmz"));
 	if (fileDialog.ShowModal() == wxID_OK) {
 		currentFile = fileDialog.GetPath().ToAscii();
 		setExtension();
@@ -570,121 +570,71 @@ void Map::switchSurfaces(int surf1, int surf2) {
 }
 
 void Map::loadFromFile(const string &path) {
+	MapFile mapFile;
+	mapFile.load(path);
+	const MapFileHeader &header = mapFile.header;
+
+	altFactor = header.altFactor;
+	waterLevel = header.waterLevel;
+	title = header.title;
+	author = header.author;
+	desc = header.description;
+
+	//start locations
+	resetFactions(header.maxPlayers);
+	for (int i = 0; i < maxFactions; ++i) {
+		startLocations[i] = mapFile.startLocations[i];
+	}
 
-	FILE *f1 = fopen(path.c_str(), "rb");
-	if (f1 != NULL) {
-
-		//read header
-		MapFileHeader header;
-		fread(&header, sizeof(MapFileHeader), 1, f1);
-
-		altFactor = header.altFactor;
-		waterLevel = header.waterLevel;
-		title = header.title;
-		author = header.author;
-		desc = header.description;
-
-		//read start locations
-		resetFactions(header.maxFactions);
-		for (int i = 0; i < maxFactions; ++i) {
-			fread(&startLocations[i].x, sizeof(int32), 1, f1);
-			fread(&startLocations[i].y, sizeof(int32), 1, f1);
-		}
-
-		//read Heights
-		reset(header.width, header.height, 10, 1);
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				fread(&cells[i][j].height, sizeof(float), 1, f1);
-			}
-		}
-
-		//read surfaces
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				fread(&cells[i][j].surface, sizeof(int8), 1, f1);
-			}
-		}
-
-		//read objects
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				int8 obj;
-				fread(&obj, sizeof(int8), 1, f1);
-				if (obj <= 10) {
-					cells[i][j].object = obj;
-				} else {
-					cells[i][j].resource = obj - 10;
-				}
+	//heights, surfaces and objects
+	reset(header.width, header.height, 10, 1);
+	for (int j = 0; j < h; ++j) {
+		for (int i = 0; i < w; ++i) {
+			const int n = j * w + i;
+			cells[i][j].height = mapFile.heights[n];
+			cells[i][j].surface = mapFile.surfaces[n];
+			int8 obj = mapFile.objects[n];
+			if (obj <= 10) {
+				cells[i][j].object = obj;
+			} else {
+				cells[i][j].resource = obj - 10;
 			}
 		}
-
-		fclose(f1);
-	} else {
-		throw runtime_error("error opening map file: " + path);
 	}
 }
 
 
 void Map::saveToFile(const string &path) {
-
-	FILE *f1 = fopen(path.c_str(), "wb");
-	if (f1 != NULL) {
-
-		//write header
-		MapFileHeader header;
-
-		header.version = 1;
-		header.maxFactions = maxFactions;
-		header.width = w;
-		header.height = h;
-		header.altFactor = altFactor;
-		header.waterLevel = waterLevel;
-		strncpy(header.title, title.c_str(), 128);
-		strncpy(header.author, author.c_str(), 128);
-		strncpy(header.description, desc.c_str(), 256);
-
-		fwrite(&header, sizeof(MapFileHeader), 1, f1);
-
-		//write start locations
-		for (int i = 0; i < maxFactions; ++i) {
-			fwrite(&startLocations[i].x, sizeof(int32), 1, f1);
-			fwrite(&startLocations[i].y, sizeof(int32), 1, f1);
-		}
-
-		//write Heights
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				fwrite(&cells[i][j].height, sizeof(float32), 1, f1);
-			}
-		}
-
-		//write surfaces
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				fwrite(&cells[i][j].surface, sizeof(int8), 1, f1);
-			}
-		}
-
-		//write objects
-		for (int j = 0; j < h; ++j) {
-			for (int i = 0; i < w; ++i) {
-				if (cells[i][j].resource == 0)
-					fwrite(&cells[i][j].object, sizeof(int8), 1, f1);
-				else {
-					int8 res = cells[i][j].resource + 10;
-					fwrite(&res, sizeof(int8), 1, f1);
-				}
+	MapFile mapFile;
+	MapFileHeader &header = mapFile.header;
+
+	header.version = 1;
+	header.maxPlayers = maxFactions;
+	header.width = w;
+	header.height = h;
+	header.altFactor = altFactor;
+	header.waterLevel = waterLevel;
+	strncpy(header.title, title.c_str(), 128);
+	strncpy(header.author, author.c_str(), 128);
+	strncpy(header.description, desc.c_str(), 256);
+
+	mapFile.startLocations.assign(startLocations, startLocations + maxFactions);
+	mapFile.heights.resize(w * h);
+	mapFile.surfaces.resize(w * h);
+	mapFile.objects.resize(w * h);
+	for (int j = 0; j < h; ++j) {
+		for (int i = 0; i < w; ++i) {
+			const int n = j * w + i;
+			mapFile.heights[n] = cells[i][j].height;
+			mapFile.surfaces[n] = cells[i][j].surface;
+			if (cells[i][j].resource == 0) {
+				mapFile.objects[n] = cells[i][j].object;
+			} else {
+				mapFile.objects[n] = cells[i][j].resource + 10;
 			}
 		}
-
-		fclose(f1);
-
-	} else {
-		throw runtime_error("Error opening map file: " + path);
 	}
-
-	void randomHeight(int x, int y, int height);
+	mapFile.save(path);
 }
 
 // ==================== PRIVATE ====================
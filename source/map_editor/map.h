@@ -16,24 +16,15 @@
 #include "util.h"
 #include "types.h"
 #include "random.h"
+#include "map_file.h"
 
 namespace MapEditor {
 
 using namespace Shared::Platform;
 using Shared::Math::Vec2i;
 using Shared::Util::Random;
-
-struct MapFileHeader {
-	int32 version;
-	int32 maxFactions;
-	int32 width;
-	int32 height;
-	int32 altFactor;
-	int32 waterLevel;
-	int8 title[128];
-	int8 author[128];
-	int8 description[256];
-};
+using Shared::Util::MapFile;
+using Shared::Util::MapFileHeader;
 
 class MapMaker;
 
@@ -0,0 +1,85 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_COMPRESSEDTEXTURE_H_
+#define _SHARED_GRAPHICS_COMPRESSEDTEXTURE_H_
+
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace Shared { namespace Graphics {
+
+using std::string;
+using std::vector;
+using Shared::Platform::uint8;
+using Shared::Platform::uint64;
+
+class Pixmap2D;
+
+/** Halve an image with a 2x2 box filter, a dimension of 1 is left as is.
+  * @param dst max(1, w/2) * max(1, h/2) pixels */
+void halveImage(const uint8 *src, int w, int h, int components, uint8 *dst);
+
+/** Encode a 4x4 block of RGBA pixels, as DXT1 (8 bytes, alpha ignored) or DXT5 (16 bytes) */
+void compressDxtBlock(const uint8 *rgba, bool dxt5, uint8 *out);
+
+/** Decode a block encoded by compressDxtBlock() to 4x4 RGBA pixels */
+void decompressDxtBlock(const uint8 *in, bool dxt5, uint8 *out_rgba);
+
+// =====================================================
+//	class CompressedTexture
+// =====================================================
+/** A mipmapped texture, the mipmaps built and DXT compressed on the CPU, to be uploaded as is.
+  * RGB images are DXT1 compressed, RGBA DXT5. Compressed textures can be cached on disk, by
+  * a hash of the source file, so later loads skip decoding, filtering and compressing. */
+class CompressedTexture {
+public:
+	struct Level {
+		int w, h;
+		vector<uint8> data;
+	};
+
+private:
+	static string cacheDir;
+
+	bool m_dxt5;
+	vector<Level> m_levels;
+
+public:
+	CompressedTexture() : m_dxt5(false) {}
+
+	/** set the directory for cached textures, empty (the default) disables the cache */
+	static void setCacheDir(const string &dir)	{cacheDir = dir;}
+	static bool isCacheEnabled()				{return !cacheDir.empty();}
+
+	/** @return true if a pixmap can be compressed: 3 or 4 components and sides a power of two */
+	static bool canCompress(const Pixmap2D *pixmap);
+
+	bool isDxt5() const					{return m_dxt5;}
+	int getLevelCount() const			{return m_levels.size();}
+	const Level &getLevel(int i) const	{return m_levels[i];}
+	int getMemoryUsage() const;
+
+	/** build and compress the mipmaps of a pixmap, which canCompress() */
+	void compress(const Pixmap2D *pixmap);
+
+	/** read the texture cached for a source file hash @return false if there is none, or it is
+	  * from another version */
+	bool loadCached(uint64 hash);
+	/** write the texture to the cache, failures are ignored */
+	void saveCached(uint64 hash) const;
+};
+
+}}//end namespace
+
+#endif
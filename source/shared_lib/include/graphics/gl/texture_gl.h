@@ -50,6 +50,9 @@ public:
 // =====================================================
 
 class Texture2DGl: public Texture2D, public TextureGl{
+private:
+	void initCompressed(Filter filter, int maxAnisotropy);
+
 public:
 	virtual void init(Filter filter, int maxAnisotropy= 1) override;
 	virtual void deletePixmap() override;
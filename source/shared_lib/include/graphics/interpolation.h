@@ -22,22 +22,53 @@ void test_interpolate();
 // =====================================================
 //	class InterpolationData
 // =====================================================
-
+/** Interpolated vertex data for an animated mesh. Animation progress is quantised to one of
+  * phaseSteps phases, and the results for the most recently used phases are kept, so many
+  * instances of a model at the same point in an animation cost one interpolation. */
 class InterpolationData {
+public:
+	/** number of distinct phases an animation is quantised to */
+	static const int phaseSteps = 512;
+	/** maximum number of phases kept per mesh */
+	static const int maxSlots = 4;
+	/** limit on memory used by extra slots (beyond the first), across all meshes */
+	static const int maxCacheBytes = 16 * 1024 * 1024;
+
 private:
+	struct Slot {
+		MeshVertexBlock data;
+		int phase;		/**< quantised t, or -1 if slot holds nothing */
+		bool cycle;
+		uint32 lastUsed;	/**< value of useCounter when last used */
+	};
+
 	Mesh *mesh;
 
-	MeshVertexBlock data;
+	Slot slots[maxSlots];
+	int slotCount;		/**< number of slots allocated */
+	int current;		/**< slot last updated to */
+	uint32 useCounter;	/**< incremented each update, may wrap */
+
+	static int cacheBytes;
+	static int hits, misses;
+
+	void interpolateTo(MeshVertexBlock &data, float t, bool cycle);
 
 public:
 	InterpolationData(Mesh *mesh);
 	~InterpolationData();
 
 	const MeshVertexBlock& getVertexBlock() const {
-		return data;
+		return slots[current].data;
 	}
 	
+	/** make the vertex block hold the mesh interpolated to t (0-1 over the whole animation) */
 	void update(float t, bool cycle);
+
+	static int getCacheBytes()	{ return cacheBytes; }
+	static int getCacheHits()	{ return hits;		 }
+	static int getCacheMisses()	{ return misses;	 }
+	static void resetCacheStats() { hits = misses = 0; }
 	//void updateVertices(float t, bool cycle);
 	//void updateNormals(float t, bool cycle);
 };
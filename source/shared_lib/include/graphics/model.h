@@ -15,6 +15,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "gl_wrap.h"
 #include "types.h"
@@ -199,6 +200,30 @@ struct MeshIndexBlock {
 	}
 };
 
+// =====================================================
+// struct MeshLoadData
+//
+// Mesh data read from file, held in system RAM until the mesh is uploaded
+// =====================================================
+
+struct MeshLoadData {
+	Vec3f *vertices;
+	Vec3f *normals;
+	Vec3f *tangents;
+	Vec2f *texCoords;
+	uint32 *indices;
+	string texturePaths[MeshTexture::COUNT];
+
+	MeshLoadData() : vertices(0), normals(0), tangents(0), texCoords(0), indices(0) {}
+	~MeshLoadData() {
+		delete [] vertices;
+		delete [] normals;
+		delete [] tangents;
+		delete [] texCoords;
+		delete [] indices;
+	}
+};
+
 // =====================================================
 // class Mesh
 //
@@ -232,12 +257,22 @@ private:
 	bool customColor;
 	bool noSelect;
 
+	// extent of the vertices over all frames
+	Vec3f m_boundsMin;
+	Vec3f m_boundsMax;
+
 	InterpolationData *interpolationData;
 
+	// read by read() or readV3(), uploaded and deleted by upload()
+	MeshLoadData *m_loadData;
+
+	// bytes of vertex and index data, set by fillBuffers()
+	uint32 m_memoryUsage;
+
 private:
 	void initMemory();
 	void fillBuffers(Vec3f *pos, Vec3f *norm, Vec3f *tan, Vec2f *uv, uint32 *indices);
-	void loadAdditionalTextures(const string &dtPath, TextureManager *textureManager);
+	void findAdditionalTextures(const string &dtPath);
 	void computeTangents(Vec3f *verts, Vec2f *uvs, uint32 *indices, Vec3f *&tangents);
 
 public:
@@ -254,6 +289,7 @@ public:
 
 	uint32 getIndexCount() const			{return indexCount;}
 	uint32 getTriangleCount() const;
+	uint32 getMemoryUsage() const			{return m_memoryUsage;}
 
 	// data
 	MeshVertexBlock& getStaticVertData() { return m_vertices_frame0; }
@@ -277,6 +313,10 @@ public:
 	bool usesTeamTexture() const            {return customColor;}
 	bool isNoSelect() const                 {return noSelect;}
 
+	// bounds
+	const Vec3f &getBoundsMin() const		{return m_boundsMin;}
+	const Vec3f &getBoundsMax() const		{return m_boundsMax;}
+
 	// external data
 	const InterpolationData *getInterpolationData() const {return interpolationData;}
 
@@ -285,9 +325,21 @@ public:
 	void updateInterpolationData(float t, bool cycle) const;
 	//void updateInterpolationVertices(float t, bool cycle) const;
 
-	// load
-	void loadV3(const string &dir, FileOps *f, TextureManager *textureManager);
-	void load(const string &dir, FileOps *f, TextureManager *textureManager);
+	// load, the read functions make no GL or texture manager calls and may be used off the main
+	// thread, upload() must be called on the main thread to complete the load
+	void readV3(const string &dir, FileOps *f, bool readTextures);
+	void read(const string &dir, FileOps *f, bool readTextures);
+	void upload(TextureManager *textureManager);
+	void getTexturePaths(vector<string> &out_paths) const;
+
+	void loadV3(const string &dir, FileOps *f, TextureManager *textureManager) {
+		readV3(dir, f, textureManager != NULL);
+		upload(textureManager);
+	}
+	void load(const string &dir, FileOps *f, TextureManager *textureManager) {
+		read(dir, f, textureManager != NULL);
+		upload(textureManager);
+	}
 	void save(const string &dir, FileOps *f);
 
 	void buildCube(int size, int height, Texture2D *tex);
@@ -308,6 +360,14 @@ private:
 	uint32 meshCount;
 	Mesh *meshes;
 
+	// extent of the selectable meshes over all frames, min > max if there are none
+	Vec3f m_boundsMin;
+	Vec3f m_boundsMax;
+
+	// path and error (if any) of the last read()
+	string m_loadPath;
+	string m_loadError;
+
 public:
 	// constructor & destructor
 	Model();
@@ -330,6 +390,11 @@ public:
 
 	uint32 getTriangleCount() const;
 	uint32 getVertexCount() const;
+	/** @return bytes of vertex and index data */
+	uint32 getMemoryUsage() const;
+
+	const Vec3f &getBoundsMin() const	{return m_boundsMin;}
+	const Vec3f &getBoundsMax() const	{return m_boundsMax;}
 
 	// io
 	void load(const string &path, int size, int height);
@@ -337,9 +402,21 @@ public:
 	void loadG3d(const string &path);
 	void saveS3d(const string &path);
 
+	/** read a model file, no GL calls are made so this can be done on a worker thread. Errors
+	  * are held until upload() */
+	void read(const string &path);
+	/** complete loading a model after read(), on the main thread. If reading failed a box of the
+	  * given size is substituted */
+	void upload(int size, int height);
+	/** texture files referenced by a model that has been read but not yet uploaded */
+	void getTexturePaths(vector<string> &out_paths) const;
+
 	void setTextureManager(TextureManager *textureManager) {this->textureManager = textureManager;}
 
 private:
+	void readG3d(const string &path);
+	void uploadMeshes();
+	void computeBounds();
 	void buildInterpolationData() const {
 		for (int i = 0; i < meshCount; ++i) {
 			meshes[i].buildInterpolationData();
@@ -15,6 +15,7 @@
 #include "model.h"
 
 #include <vector>
+#include <map>
 
 namespace Shared{ namespace Graphics{
 
@@ -24,19 +25,31 @@ class TextureManager;
 //	class ModelManager
 // =====================================================
 
+/** Creates and owns models. Models created for a file are indexed by path, so each file is
+  * loaded once. Models live until end(), when their resource scope ends. */
 class ModelManager {
 protected:
 	typedef vector<Model*> ModelContainer;
+	typedef std::map<string, Model*> PathIndex;
 
 protected:
 	ModelContainer models;
+	PathIndex m_pathIndex;
 	TextureManager *textureManager;
 
 public:
 	ModelManager();
 	virtual ~ModelManager();
 
+	/** create an unindexed model */
 	Model *newModel();
+	/** create a model for a file, which the caller is to load */
+	Model *newModel(const string &path);
+	/** @return the model created for a file, or NULL if there is none */
+	Model *getModel(const string &path);
+
+	/** @return bytes of vertex and index data of the models */
+	int64 getMemoryUsage() const;
 
 	void init();
 	void end();
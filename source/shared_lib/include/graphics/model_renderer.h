@@ -33,7 +33,6 @@ public:
 
 WRAPPED_ENUM( RenderMode, 
 	WIREFRAME,
-	SELECTION,
 	OBJECTS,
 	UNITS,
 	SHADOWS
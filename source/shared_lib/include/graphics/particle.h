@@ -22,6 +22,7 @@
 #include "math_util.h"
 #include "xml_parser.h"
 #include "util.h"
+#include "worker_pool.h"
 
 using std::list;
 
@@ -29,6 +30,7 @@ namespace Shared{
 
 using Xml::XmlNode;
 using Util::Random;
+using Platform::WorkerPool;
 	
 namespace Graphics{
 
@@ -115,33 +117,28 @@ struct EnergyVec {
 // =====================================================
 //	class Particle
 // =====================================================
-
+/** A single particle, new particles are set up in one of these by
+  * ParticleSystem::initParticle() and then copied into the system's ParticleStore */
 class Particle {
 public:
 	//attributes
-	Vec3f pos;              // 12 bytes
-	Vec3f lastPos;          // 12 bytes
-	Vec3f speed;            // 12 bytes
-	Vec3f accel;            // 12 bytes
-	                        // 48
-
-	EnergyVec energy;       // 8 bytes
-	ValStep<float> size;    // 8 bytes
-	ValStep<float> angle;   // 8 bytes
-	                        // 24
+	Vec3f pos;
+	Vec3f lastPos;
+	Vec3f speed;
+	Vec3f accel;
 
-	ValStep<Vec4f> colour;  // 32
-	ValStep<Vec4f> colour2; // 32
-	                        // 64
+	EnergyVec energy;
+	ValStep<float> size;
+	ValStep<float> angle;
 
-	//Vec4f color;		      //  bytes // belongs in (or already is in) owner system's proto-type ?
-	//Vec4f color2;		      //  bytes // belongs in (or already is in) owner system's proto-type ? only used for line systems...
+	ValStep<Vec4f> colour;
+	ValStep<Vec4f> colour2;
 
-	int texture;            // 4 bytes
-	unsigned char padding[20];
-	                        // 160
+	int texture;
 
 public:
+	Particle();
+
 	//get
 	float getEnergyRatio() const        { return float(energy.current) / float(energy.start); }
 	Vec3f getPos() const				{return pos;}
@@ -158,6 +155,66 @@ public:
 	MEMORY_CHECK_DECLARATIONS(Particle);
 };
 
+// =====================================================
+//	class ParticleStore
+// =====================================================
+/** Structure of arrays storage for the particles of one system. Each attribute is a contiguous
+  * array, so the update kernels can treat (for example) pos and speed as flat float arrays
+  * and process four floats at a time with SSE, regardless of how many components they have. */
+class ParticleStore {
+public:
+	Vec3f *pos;
+	Vec3f *lastPos;
+	Vec3f *speed;
+	Vec3f *accel;
+	Vec4f *colour;
+	Vec4f *colourStep;
+	Vec4f *colour2;
+	Vec4f *colour2Step;
+	float *size;
+	float *sizeStep;
+	float *angle;
+	float *angleStep;
+	int   *energy;
+	int   *energyStart;
+	int   *texture;
+
+private:
+	char *m_block;
+	int   m_capacity;
+
+public:
+	ParticleStore();
+	~ParticleStore() { deallocate(); }
+
+	void allocate(int capacity);
+	void deallocate();
+	int  getCapacity() const { return m_capacity; }
+
+	void set(int i, const Particle &p);
+	void copy(int dst, int src);
+
+	float getEnergyRatio(int i) const { return float(energy[i]) / float(energyStart[i]); }
+
+	// update kernels, each operates on the particles [0, n)
+	void move(int n);							/**< lastPos = pos; pos += speed			*/
+	void moveTrail(int n);						/**< lastPos += speed; pos += speed			*/
+	void accelerate(int n);						/**< speed += accel							*/
+	void scaleSpeed(int n, const Vec3f &s);		/**< speed *= s (component-wise)			*/
+	void translate(int n, const Vec3f &d);		/**< pos += d; lastPos += d					*/
+	void stepColour(int n);						/**< colour += colourStep					*/
+	void stepColour2(int n);					/**< colour2 += colour2Step					*/
+	void stepSize(int n);						/**< size += sizeStep						*/
+	void stepAngle(int n);						/**< angle = (angle + angleStep) mod 2 pi	*/
+	void age(int n);							/**< --energy								*/
+
+	// kill kernels, compact the live particles to the front of the arrays
+	/** remove particles with no energy left @return new number of live particles */
+	int killExpired(int n);
+	/** remove particles that have dropped below y = 0 @return new number of live particles */
+	int killGrounded(int n);
+};
+
 // =====================================================
 //	class ParticleSystemType
 // =====================================================
@@ -306,7 +363,7 @@ protected:
 	//int id;
 	ParticleUse use;
 	int particleCount;
-	Particle *particles;
+	ParticleStore particles;
 	State state;
 	bool active;
 	bool visible;
@@ -326,14 +383,17 @@ public:
 	void freeArray();
 
 	//public
+	/** advance live particles and remove dead ones. Touches only this system's particles, so
+	  * systems may be stepped concurrently; called before update() */
+	void step();
+	/** per frame logic, and emission of new particles */
 	virtual void update();
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr);
 
 	//get
 	State getState() const						{return state;}
 	Vec3f getPos() const						{return pos;}
-	Particle *getParticle(int i)				{return &particles[i];}
-	const Particle *getParticle(int i) const	{return &particles[i];}
+	const ParticleStore& getParticles() const	{return particles;}
 	int getAliveParticleCount() const			{return aliveParticleCount;}
 	bool getActive() const						{return active;}
 	bool getVisible() const						{return visible;}
@@ -366,13 +426,14 @@ public:
 
 protected:
 	//protected
-	Particle *createParticle();
-	void killParticle(Particle *p)				{aliveParticleCount--;}
+	int createParticle();
 
 	//virtual protected
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual void updateParticle(Particle *p);
-	virtual bool deathTest(Particle *p)			{return p->energy.current <= 0;}
+	/** update all live particles, systems override this to run the kernels they need */
+	virtual void updateParticles();
+	/** remove dead particles, by default those with no energy left */
+	virtual void killParticles() { aliveParticleCount = particles.killExpired(aliveParticleCount); }
 };
 
 // =====================================================
@@ -387,7 +448,7 @@ public:
 	//virtual
 	virtual void render(ParticleRenderer *pr, ModelRenderer *mr);
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
+	virtual void killParticles() { aliveParticleCount = particles.killGrounded(aliveParticleCount); }
 };
 
 // =====================================================
@@ -401,7 +462,7 @@ public:
 
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
-	virtual bool deathTest(Particle *p);
+	virtual void killParticles() { aliveParticleCount = particles.killGrounded(aliveParticleCount); }
 };
 
 // =====================================================
@@ -414,9 +475,15 @@ public:
 
 protected:
 	ParticleSystemList particleSystems;
+	WorkerPool *workerPool;
+
+	void step();
 
 public:
+	ParticleManager() : workerPool(0) {}
 	virtual ~ParticleManager();
+	/** use pool to step particle systems in parallel, may be NULL (the default) for serial */
+	void setWorkerPool(WorkerPool *pool) { workerPool = pool; }
 	virtual void update();
 	void render(ParticleRenderer *pr, ModelRenderer *mr) const;
 	void manage(ParticleSystem *ps);
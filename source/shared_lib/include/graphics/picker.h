@@ -0,0 +1,74 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_GRAPHICS_PICKER_H_
+#define _SHARED_GRAPHICS_PICKER_H_
+
+#include "vec.h"
+#include "types.h"
+
+using namespace Shared::Math;
+using Shared::Platform::uint32;
+
+namespace Shared { namespace Graphics {
+
+// =====================================================
+//	class Picker
+// =====================================================
+/** Picking on the CPU, a replacement for GL_SELECT. Boxes (model bounds, rotated about the y axis
+  * and translated as models are rendered) are tested against a selection rectangle, using the
+  * same camera transform and perspective projection as the renderer, without touching GL.
+  *
+  * The camera is as set up by glRotatef(vAng, -1, 0, 0), glRotatef(hAng, 0, 1, 0) then
+  * glTranslatef(-pos), the projection as by gluPerspective(fov, aspect, nearPlane, farPlane). */
+class Picker {
+private:
+	// camera
+	Vec3f m_camPos;
+	float m_sinH, m_cosH;
+	float m_sinV, m_cosV;
+
+	// projection
+	float m_xScale, m_yScale;
+	float m_nearPlane, m_farPlane;
+	int m_screenW, m_screenH;
+
+	// selection rectangle in window coordinates (origin bottom left)
+	float m_minX, m_minY, m_maxX, m_maxY;
+	bool m_point;		/**< single pixel, test the ray through it rather than the rectangle */
+	Vec3f m_rayDir;		/**< world space direction of the ray, scaled so eye space z is -1 */
+
+	Vec3f toEye(const Vec3f &world) const;
+	Vec3f toWorldDir(const Vec3f &eyeDir) const;
+	uint32 toSelectDepth(float eyeDist) const;
+
+public:
+	Picker(const Vec3f &camPos, float hAng, float vAng, float fov, float aspect,
+		float nearPlane, float farPlane, int screenW, int screenH);
+
+	/** set the selection rectangle, in screen coordinates (origin top left) as for the mouse.
+	  * The same rectangle gluPickMatrix would be given, at least one pixel wide and high. */
+	void setRect(const Vec2i &posDown, const Vec2i &posUp);
+
+	/** Test a box against the selection rectangle
+	  * @param pos translation of the box
+	  * @param rotation rotation of the box about the y axis, in degrees
+	  * @param boxMin minimum corner of the box before transformation
+	  * @param boxMax maximum corner of the box before transformation, a box with min > max is empty
+	  * @param out_depth [out] depth of the nearest hit, scaled as GL_SELECT depths
+	  * @return true if the box was hit */
+	bool pick(const Vec3f &pos, float rotation, const Vec3f &boxMin, const Vec3f &boxMax,
+		uint32 &out_depth) const;
+};
+
+}}//end namespace
+
+#endif
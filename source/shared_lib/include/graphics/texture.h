@@ -23,6 +23,7 @@ using Shared::Platform::uint8;
 namespace Shared{ namespace Graphics{
 
 class TextureParams;
+class CompressedTexture;
 
 // =====================================================
 //	class Texture
@@ -59,6 +60,7 @@ protected:
 	Format format;
 
 	bool inited;
+	int memoryUsage;	/**< estimated bytes of texture memory, set by init() */
 
 public:
 	Texture();
@@ -69,6 +71,7 @@ public:
 	bool getPixmapInit() const		{return pixmapInit;}
 	Format getFormat() const		{return format;}
 	const string getPath() const	{return path;}
+	int getMemoryUsage() const		{return memoryUsage;}
 
 	void setMipmap(bool mipmap)			{this->mipmap= mipmap;}
 	void setWrapMode(WrapMode wrapMode)	{this->wrapMode= wrapMode;}
@@ -104,14 +107,18 @@ public:
 class Texture2D: public Texture{
 protected:
 	Pixmap2D *pixmap;
+	CompressedTexture *m_compressed;	/**< set by loadCompressed(), uploaded in place of the pixmap */
 
 public:
 	static Texture2D *defaultTexture;
 
 public:
-	Texture2D() : pixmap(new Pixmap2D()) { }
-	~Texture2D() { delete pixmap; }
+	Texture2D() : pixmap(new Pixmap2D()), m_compressed(0) { }
+	~Texture2D();
 	void load(const string &path);
+	/** load, and if compressed textures are cached and this is mipmapped, use the compressed
+	  * mipmaps from the cache or build and cache them. Makes no GL calls. */
+	void loadCompressed(const string &path);
 
 	Pixmap2D *getPixmap()				{return pixmap;}
 	void setPixmap(Pixmap2D *pm);
@@ -13,11 +13,17 @@
 #define _SHARED_GRAPHICS_TEXTUREMANAGER_H_
 
 #include <vector>
+#include <map>
 
 #include "texture.h"
 #include "util.h"
+#include "worker_pool.h"
 
 using std::vector;
+using std::map;
+using Shared::Platform::WorkerPool;
+using Shared::Platform::int64;
+using Shared::Platform::uint64;
 
 namespace Shared{ namespace Graphics{
 
@@ -25,19 +31,29 @@ namespace Shared{ namespace Graphics{
 //	class TextureManager
 // =====================================================
 
-//manages textures, creation on request and deletion on destruction
+/** Manages textures, creation on request and deletion on destruction. 2D textures loaded from
+  * files are shared, indexed by path (and optionally by content, so identical files stored under
+  * different paths share a texture). They are deleted in end(), with their resource scope. */
 class TextureManager{
 protected:
 	typedef vector<Texture*> TextureContainer;
+	typedef map<string, Texture2D*> PathIndex;
+	typedef map<uint64, Texture2D*> ContentIndex;
 	
 protected:
 	WRAPPED_ENUM( TextureType,  ONE_D, TWO_D, THREE_D, CUBE_MAP );
 
 	TextureContainer textures[TextureType::COUNT];
+	PathIndex m_pathIndex;			/**< 2D textures loaded from files, by cleaned path */
+	ContentIndex m_contentIndex;	/**< as m_pathIndex by content hash, if m_shareByContent */
+	bool m_shareByContent;
 	
 	Texture::Filter textureFilter;
 	int maxAnisotropy;
 
+	Texture2D *findTexture2D(const string &cleanedPath, uint64 *contentHash);
+	void addTexture2D(Texture2D *tex, const string &cleanedPath, uint64 *contentHash);
+
 public:
 	TextureManager();
 	~TextureManager();
@@ -46,14 +62,26 @@ public:
 
 	void setFilter(Texture::Filter textureFilter);
 	void setMaxAnisotropy(int maxAnisotropy);
+	/** share textures loaded from identical files under different paths, costs a read and hash of
+	  * each file not already loaded */
+	void setShareByContent(bool v)	{m_shareByContent = v;}
 
+	/** get the texture for a file, loading it if not already @return the texture, or the default
+	  * texture if the file could not be loaded */
 	Texture2D *getTexture(const string &path);
+
+	/** Load textures ahead of getTexture(), decoding on the pool's threads (and this one) then
+	  * initialising on this thread. Failures are left for getTexture() to report. */
+	void preload(const vector<string> &paths, WorkerPool &pool);
 	Texture1D *newTexture1D();
 	Texture2D *newTexture2D();
 	Texture3D *newTexture3D();
 	TextureCube *newTextureCube();
 
 	bool deleteTexture2D(Texture2D *tex);
+
+	/** @return estimated bytes of texture memory used by the textures initialised */
+	int64 getMemoryUsage() const;
 };
 
 
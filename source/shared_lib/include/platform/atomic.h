@@ -0,0 +1,75 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_PLATFORM_ATOMIC_H_
+#define _SHARED_PLATFORM_ATOMIC_H_
+
+#ifdef _MSC_VER
+#	include <windows.h>
+#	include <intrin.h>
+#endif
+
+#include "types.h"
+
+namespace Shared { namespace Platform {
+
+// Atomic operations on 32 bit words, full barriers all. Loads and stores through these order the
+// memory accesses around them, plain volatile accesses don't.
+
+#ifdef _MSC_VER
+
+inline void memoryBarrier() {
+	MemoryBarrier();
+}
+
+/** @return the value before adding */
+inline uint32 atomicAdd(volatile uint32 *p, uint32 value) {
+	return uint32(InterlockedExchangeAdd(reinterpret_cast<volatile LONG*>(p), LONG(value)));
+}
+
+/** set *p to desired if it is expected @return true if it was */
+inline bool atomicCompareAndSwap(volatile uint32 *p, uint32 expected, uint32 desired) {
+	return uint32(InterlockedCompareExchange(reinterpret_cast<volatile LONG*>(p),
+		LONG(desired), LONG(expected))) == expected;
+}
+
+#else // gcc and compatibles
+
+inline void memoryBarrier() {
+	__sync_synchronize();
+}
+
+/** @return the value before adding */
+inline uint32 atomicAdd(volatile uint32 *p, uint32 value) {
+	return __sync_fetch_and_add(p, value);
+}
+
+/** set *p to desired if it is expected @return true if it was */
+inline bool atomicCompareAndSwap(volatile uint32 *p, uint32 expected, uint32 desired) {
+	return __sync_bool_compare_and_swap(p, expected, desired);
+}
+
+#endif
+
+inline uint32 atomicLoad(volatile uint32 *p) {
+	uint32 value = *p;
+	memoryBarrier();
+	return value;
+}
+
+inline void atomicStore(volatile uint32 *p, uint32 value) {
+	memoryBarrier();
+	*p = value;
+}
+
+}}//end namespace
+
+#endif
@@ -72,6 +72,10 @@ inline void freeDirIterator(DirIterator &di) {
 
 void mkdir(const string &path, bool ignoreDirExists = false);
 size_t getFileSize(const string &path);
+/** @return number of logical processors available, at least 1 */
+int getProcessorCount();
+/** @return the peak resident memory of this process in bytes, 0 if unknown */
+int64 getPeakMemoryUsage();
 
 string videoModeToString(const VideoMode in_mode);
 bool changeVideoMode(const VideoMode in_mode);
@@ -108,6 +108,23 @@ public:
 	~MutexLock() {mutex.v();}
 };
 
+// =====================================================
+//	class Semaphore
+// =====================================================
+
+class Semaphore {
+private:
+	SemaphoreType semaphore;
+
+public:
+	Semaphore(int initialCount = 0);
+	~Semaphore();
+	/** decrement the count, blocking while it is zero */
+	void wait();
+	/** increment the count, releasing one waiting thread */
+	void signal();
+};
+
 }}//end namespace
 
 #endif
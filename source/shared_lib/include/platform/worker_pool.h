@@ -0,0 +1,80 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_PLATFORM_WORKER_POOL_H_
+#define _SHARED_PLATFORM_WORKER_POOL_H_
+
+#include <deque>
+#include <vector>
+
+#include "thread.h"
+
+namespace Shared { namespace Platform {
+
+using std::deque;
+using std::vector;
+
+// =====================================================
+//	class Task
+// =====================================================
+/** A unit of work for a WorkerPool */
+class Task {
+public:
+	virtual ~Task() {}
+	virtual void execute() = 0;
+};
+
+// =====================================================
+//	class WorkerPool
+// =====================================================
+/** A fixed set of threads executing Tasks. Tasks are added in batches, the thread adding them
+  * then calls wait(), helping to execute the batch until it is complete. Tasks are owned by
+  * the caller and must stay alive until wait() returns. */
+class WorkerPool {
+private:
+	class Worker : public Thread {
+	private:
+		WorkerPool *pool;
+
+	public:
+		Worker(WorkerPool *pool) : pool(pool) {}
+		virtual void execute();
+	};
+
+	vector<Worker*> workers;
+	deque<Task*> tasks;		/**< tasks waiting to be executed */
+	Mutex mutex;			/**< guards tasks, pending, waiting and quit */
+	Semaphore taskSignal;	/**< signalled once per task added (and once per worker on quit) */
+	Semaphore doneSignal;	/**< signalled when the last pending task completes, if waiting */
+	int pending;			/**< tasks added and not yet complete */
+	bool waiting;
+	bool quit;
+
+	Task* takeTask();
+	void taskDone();
+
+public:
+	/** @param threadCount number of worker threads, may be 0 in which case tasks are all
+	  * executed by the thread calling wait() */
+	WorkerPool(int threadCount);
+	~WorkerPool();
+
+	int getThreadCount() const { return workers.size(); }
+
+	void add(Task *task);
+
+	/** execute tasks until all added so far are complete */
+	void wait();
+};
+
+}}//end namespace
+
+#endif
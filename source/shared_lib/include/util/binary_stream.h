@@ -0,0 +1,90 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_BINARYSTREAM_H_
+#define _SHARED_UTIL_BINARYSTREAM_H_
+
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+namespace Shared { namespace Util {
+
+using std::string;
+using std::vector;
+using Shared::Platform::int32;
+using Shared::Platform::uint8;
+using Shared::Platform::uint32;
+using Shared::Platform::float32;
+
+// =====================================================
+//	class BinaryWriter
+// =====================================================
+/** Builds a little endian byte stream in memory. Integers are varints, zigzagged if signed,
+  * strings a varint length and the bytes. */
+class BinaryWriter {
+private:
+	vector<uint8> m_data;
+
+public:
+	const vector<uint8>& getData() const	{return m_data;}
+	size_t getSize() const					{return m_data.size();}
+	void clear()							{m_data.clear();}
+
+	void writeUnsigned(uint32 value);
+	void writeSigned(int32 value);
+	void writeBool(bool value)				{m_data.push_back(value ? 1 : 0);}
+	void writeFloat(float32 value);
+	void writeInt32(int32 value);
+	void writeString(const string &value);
+	void writeBytes(const void *data, size_t size);
+
+	/** write the stream to a file @throws runtime_error */
+	void save(const string &path) const;
+};
+
+// =====================================================
+//	class BinaryReader
+// =====================================================
+/** Reads a stream written by BinaryWriter. Reads past the end throw runtime_error. */
+class BinaryReader {
+private:
+	vector<uint8> m_buffer;		/**< the data when loaded from a file */
+	const uint8 *m_ptr;
+	const uint8 *m_end;
+
+	void check(size_t size) const;
+
+public:
+	BinaryReader() : m_ptr(0), m_end(0) {}
+	BinaryReader(const uint8 *data, size_t size) : m_ptr(data), m_end(data + size) {}
+
+	/** read a whole file into the reader @throws runtime_error */
+	void load(const string &path);
+
+	bool atEnd() const						{return m_ptr == m_end;}
+	size_t getRemaining() const				{return m_end - m_ptr;}
+
+	uint32 readUnsigned();
+	int32 readSigned();
+	bool readBool();
+	float32 readFloat();
+	int32 readInt32();
+	string readString();
+	void readBytes(void *out_data, size_t size);
+	/** @return a pointer to the next size bytes, and skip them */
+	const uint8* skip(size_t size);
+};
+
+}}//end namespace
+
+#endif
@@ -13,51 +13,103 @@
 #define _SHARED_UTIL_CHECKSUM_H_
 
 #include <string>
+#include <cstring>
 
 #include "types.h"
 
 using std::string;
 using Shared::Platform::int32;
 using Shared::Platform::int8;
+using Shared::Platform::uint8;
+using Shared::Platform::uint64;
 
 namespace Shared { namespace Util {
 
 // =====================================================
 //	class Checksum
 // =====================================================
-
+/** A 64 bit hash of everything added, xxHash64 in all but the seed. Data is buffered and hashed
+  * 32 bytes at a time in four independent lanes, a word each, so the compiler can keep them in
+  * registers or vectorise them. The sum depends on the order of the bytes added, not on how they
+  * were split into add() calls. */
 class Checksum {
-private:
-	int32	sum;
-	int32	r;
-    int32	c1;
-    int32	c2;
+public:
+	static const int blockSize = 32;
+
+	static const uint64 prime1 = 0x9E3779B185EBCA87ULL;
+	static const uint64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+	static const uint64 prime3 = 0x165667B19E3779F9ULL;
+	static const uint64 prime4 = 0x85EBCA77C2B2AE63ULL;
+	static const uint64 prime5 = 0x27D4EB2F165667C5ULL;
 
 private:
-	void addByte(int8 value) {
-		int32 cipher = (value ^ (r >> 8));
-		r = (cipher + r) * c1 + c2;
-		sum += cipher;
+	uint64	m_lanes[4];
+	uint8	m_buffer[blockSize];
+	int		m_bufferSize;
+	uint64	m_totalSize;
+
+	static uint64 rotl(uint64 x, int r)	{return (x << r) | (x >> (64 - r));}
+
+	static uint64 mixLane(uint64 acc, uint64 input) {
+		acc += input * prime2;
+		return rotl(acc, 31) * prime1;
+	}
+
+	void addBlock(const uint8 *block) {
+		uint64 words[4];
+		memcpy(words, block, blockSize);
+		m_lanes[0] = mixLane(m_lanes[0], words[0]);
+		m_lanes[1] = mixLane(m_lanes[1], words[1]);
+		m_lanes[2] = mixLane(m_lanes[2], words[2]);
+		m_lanes[3] = mixLane(m_lanes[3], words[3]);
 	}
 
 public:
-	Checksum() : sum(0), r(55665), c1(52845), c2(22719) {}
+	Checksum()	{reset();}
 
-	int32 getSum() const	{return sum;}
+	void reset();
 
-	template <typename T> void add(const T &val) {
-		for (unsigned i=0; i < sizeof(T); ++i) {
-			int8 *byte = (int8*)&val + i;
-			addByte(*byte);
+	/** mix a word into a running hash, for hashes updated too often to keep a Checksum for */
+	static uint64 combine(uint64 hash, uint64 value) {
+		return rotl(hash ^ mixLane(0, value), 27) * prime1 + prime4;
+	}
+
+	/** @return the hash of everything added so far, adding more afterwards is fine */
+	uint64 getSum64() const;
+	/** @return getSum64() folded to 32 bits */
+	int32 getSum() const	{uint64 h = getSum64(); return int32(h ^ (h >> 32));}
+
+	void addBytes(const void *data, size_t size) {
+		const uint8 *bytes = static_cast<const uint8*>(data);
+		m_totalSize += size;
+		if (m_bufferSize + size < blockSize) {
+			memcpy(m_buffer + m_bufferSize, bytes, size);
+			m_bufferSize += size;
+			return;
+		}
+		if (m_bufferSize) {
+			size_t fill = blockSize - m_bufferSize;
+			memcpy(m_buffer + m_bufferSize, bytes, fill);
+			addBlock(m_buffer);
+			bytes += fill;
+			size -= fill;
+			m_bufferSize = 0;
+		}
+		for ( ; size >= blockSize; size -= blockSize, bytes += blockSize) {
+			addBlock(bytes);
 		}
+		memcpy(m_buffer, bytes, size);
+		m_bufferSize = size;
+	}
+
+	template <typename T> void add(const T &val) {
+		addBytes(&val, sizeof(T));
 	}
 };
 
 // specialise for strings
 template <> inline void Checksum::add<string>(const string &value) {
-	for(int i=0; i < value.size(); ++i) {
-		addByte(value[i]);
-	}
+	addBytes(value.data(), value.size());
 }
 
 }}//end namespace
@@ -0,0 +1,77 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_LOGRING_H_
+#define _SHARED_UTIL_LOGRING_H_
+
+#include <string>
+
+#include "types.h"
+
+namespace Shared { namespace Util {
+
+using std::string;
+using Shared::Platform::int32;
+using Shared::Platform::uint32;
+using Shared::Platform::int64;
+
+// =====================================================
+//	class LogRing
+// =====================================================
+/** A bounded queue of log messages, pushed from any number of threads without locking and
+  * popped by one. Messages are copied into fixed size slots, a long message taking several
+  * consecutive slots (up to maxMessageSlots, the rest is cut). When the ring is full messages
+  * are dropped and counted, producers never wait.
+  *
+  * Each slot has a sequence number, equal to its position when it is free for that position and
+  * one more once a message in it is published. A producer claims a run of slots by advancing the
+  * push position with a compare and swap, once the last slot of the run is free, the consumer
+  * frees them in order. */
+class LogRing {
+public:
+	static const int slotSize = 128;
+	static const int maxMessageSlots = 32;
+	static const int payloadSize = slotSize - 16;
+
+private:
+	struct Slot {
+		volatile uint32 sequence;
+		int32 size;			/**< message bytes, in the first slot of a message */
+		int64 time;			/**< as given to push(), in the first slot */
+		char text[payloadSize];
+	};
+
+	Slot *m_slots;
+	uint32 m_mask;
+	volatile uint32 m_pushPos;	/**< next position to claim */
+	uint32 m_popPos;			/**< next position to pop, only the consumer touches it */
+	volatile uint32 m_dropped;	/**< messages dropped since the last takeDropped() */
+
+public:
+	/** @param capacity in slots, rounded up to a power of two */
+	LogRing(int capacity);
+	~LogRing();
+
+	int getCapacity() const	{return m_mask + 1;}
+
+	/** copy a message in, from any thread @return false if the ring was full and it was dropped */
+	bool push(const char *text, int size, int64 time);
+
+	/** take the oldest message, consumer only @return false if there is none ready */
+	bool pop(string &out_text, int64 &out_time);
+
+	/** @return messages dropped since the last call, and reset the count */
+	int takeDropped();
+};
+
+}}//end namespace
+
+#endif
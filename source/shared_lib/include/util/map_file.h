@@ -0,0 +1,87 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_MAPFILE_H_
+#define _SHARED_UTIL_MAPFILE_H_
+
+#include <string>
+#include <vector>
+
+#include "types.h"
+#include "vec.h"
+
+namespace Shared { namespace Util {
+
+using std::string;
+using std::vector;
+using Shared::Platform::int8;
+using Shared::Platform::int32;
+using Shared::Platform::float32;
+using Shared::Math::Vec2i;
+
+struct MapFileHeader {
+	int32 version;
+	int32 maxPlayers;
+	int32 width;
+	int32 height;
+	int32 altFactor;
+	int32 waterLevel;
+	int8 title[128];
+	int8 author[128];
+	union {
+		int8 description[256];
+		struct {
+			int8 short_desc[128];
+			int32 magic; // 0x01020304 for meta
+			int8 meta[124];
+		};
+	};
+};
+
+// =====================================================
+//	class MapFile
+// =====================================================
+/** The contents of a map file, read and written a section at a time.
+  *
+  * .gbm and .mgm files are the header followed by the start locations, heights, surfaces and
+  * objects, uncompressed. .gbmz files are a magic and version, the header, then a table giving
+  * the offset and size of each section, the sections zlib compressed. */
+class MapFile {
+public:
+	MapFileHeader header;
+	vector<Vec2i> startLocations;	/**< header.maxPlayers of them, in tiles */
+	vector<float32> heights;		/**< header.width * header.height, by rows */
+	vector<int8> surfaces;			/**< as heights, 1 based surface types */
+	vector<int8> objects;			/**< as heights, 0 for none, 1 based objects then resources */
+
+public:
+	MapFile();
+
+	/** @return the map file for a path without extension, .gbmz preferred, or empty if none */
+	static string findFile(const string &pathNoExt);
+
+	/** read a map file, of either format by its extension @throws runtime_error */
+	void load(const string &path);
+	/** read only the header @throws runtime_error */
+	void loadHeader(const string &path);
+	/** write a map file, compressed if the extension is gbmz @throws runtime_error */
+	void save(const string &path) const;
+
+private:
+	void checkHeader(const string &path) const;
+	int getSectionSize(int section) const;
+	void setSections(const char *const *sections);
+	void getSections(vector<char> *out_sections) const;
+};
+
+}}//end namespace
+
+#endif
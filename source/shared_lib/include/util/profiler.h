@@ -14,50 +14,75 @@
 #define _SHARED_UTIL_PROFILER_H_
 
 //#define SL_PROFILE
+//#define SL_NO_PROFILE
 
-// SL_PROFILE controls if profile is enabled or not
+// The profiler is compiled in but idle by default, Profile::setEnabled() switches it on at runtime.
+// SL_PROFILE starts it enabled, SL_NO_PROFILE compiles the sections out altogether.
 
 // The Profiler and Section classes have been 'hidden away', just put _PROFILE_FUNCTION(); at the 
-// beginning of any function you want timed.
+// beginning of any function you want timed, or _PROFILE_SCOPE("name"); in a block. Each use site
+// registers its section once, a section costs a test of a flag when the profiler is disabled and
+// two timestamps and no allocation when it is enabled. Every thread records to its own buffers.
 
 #include <string>
 using std::string;
 
 namespace Shared { namespace Util {
 
-#ifndef SL_PROFILE
+#ifdef SL_NO_PROFILE
 #	define _PROFILE_FUNCTION() {}
 #	define _PROFILE_SCOPE(name) {}
 	namespace Profile {
 		inline void profileEnd() {}
+		inline void setEnabled(bool) {}
+		inline bool isEnabled() { return false; }
 	}
 
-#else // SL_PROFILE
+#else // SL_NO_PROFILE
 
 	namespace Profile {
+		extern volatile bool enabled;
+
+		/** switch recording on or off, sections open when it changes are still closed properly */
+		void setEnabled(bool enable);
+		inline bool isEnabled() { return enabled; }
+
+		/** write profiler.log, the per thread section trees, and profiler.json, the recent
+		  * sections as a Chrome trace_event timeline (load in chrome://tracing). Threads should be
+		  * idle, the buffers are not locked. */
 		void profileEnd();
-		void sectionBegin(const string &name);
-		void sectionEnd(const string &name);
+
+		/** @param name must outlive the profiler, a literal or __FUNCTION__ @return section id */
+		int registerSection(const char *name);
+		void sectionBegin(int id);
+		void sectionEnd(int id);
 	}
 
 	/** Helper, created on stack at start of functions to profile */
 	class ProfileSection {
 	private:
-		const string name;
+		int m_id;
+		bool m_active;
 
 	public:
-		ProfileSection(const char *name) : name(name) {
-			Profile::sectionBegin(this->name);
+		ProfileSection(int id) : m_id(id), m_active(Profile::enabled) {
+			if (m_active) {
+				Profile::sectionBegin(m_id);
+			}
 		}
 		~ProfileSection() {
-			Profile::sectionEnd(name);
+			if (m_active) {
+				Profile::sectionEnd(m_id);
+			}
 		}
 	};
 
-#	define _PROFILE_FUNCTION() Shared::Util::ProfileSection _func_profile(__FUNCTION__)
-#	define _PROFILE_SCOPE(name) Shared::Util::ProfileSection _func_profile(name)
+#	define _PROFILE_SCOPE(name) \
+		static const int _profile_id = Shared::Util::Profile::registerSection(name); \
+		Shared::Util::ProfileSection _func_profile(_profile_id)
+#	define _PROFILE_FUNCTION() _PROFILE_SCOPE(__FUNCTION__)
 
-#endif //SL_PROFILE
+#endif // SL_NO_PROFILE
 
 }}//end namespace Shared::Util
 
@@ -180,6 +180,8 @@ public:
 //
 #if _GAE_DEBUG_EDITION_ && !_GAE_LEAK_DUMP_
 
+#	define MEMORY_CHECK
+
 #	define MEMORY_CHECK_DECLARATIONS(Class)			\
 		static void* operator new(size_t n);		\
 		static void  operator delete(void *ptr);	\
@@ -286,6 +288,20 @@ extern MediaErrorLog mediaErrorLog;
 /// check existence of a file 
 ///@todo move into Shared::PhysFS?
 bool fileExists(const string &path);
+
+/// 64 bit hash of a block of memory, as Checksum::getSum64()
+Platform::uint64 hashBytes(const void *data, size_t size);
+/// hash of a file's content, as hashBytes() @throws runtime_error if the file can't be read
+Platform::uint64 hashFile(const string &path);
+
+/// append an unsigned varint, 7 bits a byte low bits first, the top bit set if more follow
+void writeVarint(vector<Platform::uint8> &out, Platform::uint32 value);
+/// read a varint written by writeVarint() @return false if it runs past end
+bool readVarint(const Platform::uint8 *&ptr, const Platform::uint8 *end, Platform::uint32 &out_value);
+/// map signed to unsigned so small magnitudes stay small, 0, -1, 1, -2 ... to 0, 1, 2, 3 ...
+inline Platform::uint32 zigzag(Platform::int32 v) { return (Platform::uint32(v) << 1) ^ Platform::uint32(v >> 31); }
+inline Platform::int32 unzigzag(Platform::uint32 v) { return Platform::int32(v >> 1) ^ -Platform::int32(v & 1); }
+
 ///@todo move into Shared::PhysFS?
 /** Find all files in a directory
   * @param out_results stores the found paths, can be 0 size if doThrow = false
@@ -0,0 +1,80 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_XML_XMLBINARY_H_
+#define _SHARED_XML_XMLBINARY_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "binary_stream.h"
+
+namespace Shared { namespace Xml {
+
+using std::map;
+using std::string;
+using std::vector;
+using Shared::Util::BinaryWriter;
+using Shared::Util::BinaryReader;
+
+class XmlNode;
+
+// =====================================================
+//	class XmlBinaryWriter
+// =====================================================
+/** Encodes XmlNode trees to a byte stream. A node is its name, attributes, text then children.
+  * Names and short values are written in full the first time and by index after, values that
+  * are plain integers are written as varints. */
+class XmlBinaryWriter {
+public:
+	/** values at most this long are put in the string table */
+	static const size_t maxTableString = 32;
+
+private:
+	typedef map<string, int> StringTable;
+
+	BinaryWriter &m_out;
+	StringTable m_strings;
+
+public:
+	XmlBinaryWriter(BinaryWriter &out) : m_out(out) {}
+
+	void writeNode(const XmlNode *node);
+
+private:
+	void writeTableString(const string &s);
+	void writeValue(const string &s);
+};
+
+// =====================================================
+//	class XmlBinaryReader
+// =====================================================
+/** Decodes nodes written by an XmlBinaryWriter, which must have started on the same stream. */
+class XmlBinaryReader {
+private:
+	BinaryReader &m_in;
+	vector<string> m_strings;
+
+public:
+	XmlBinaryReader(BinaryReader &in) : m_in(in) {}
+
+	/** read a node and add it to parent @throws runtime_error if the data is bad */
+	XmlNode *readNode(XmlNode *parent);
+
+private:
+	const string &readTableString();
+	string readValue();
+};
+
+}}//end namespace
+
+#endif
@@ -22,6 +22,7 @@
 #include "tinyxml.h"
 #include "vec.h"
 #include "conversion.h"
+#include "types.h"
 
 using std::string;
 using std::vector;
@@ -30,6 +31,7 @@ using std::auto_ptr;	// This isn't as good as shared_ptr from tr1 or boost, but
 						// than what we've been doing with toString()
 using namespace Shared::Math;
 using namespace Shared::Util;
+using Shared::Platform::uint64;
 
 namespace Shared { namespace Xml {
 
@@ -50,15 +52,37 @@ class XmlAttribute;
 class XmlIo {
 private:
 	static bool initialized;
+	static string cacheDir;
 
 private:
 	XmlIo() {}
 	~XmlIo() {}
 
+	XmlNode *loadCached(uint64 hash, int size);
+	void saveCached(uint64 hash, int size, const XmlNode *node);
+
 public:
 	static XmlIo &getInstance();
-	XmlNode *load(const string &path);
+
+	/** set the directory (ending in a slash) binary copies of parsed documents are kept in, loads
+	  * asking for the cache use it. Empty (the default) disables the cache. */
+	static void setCacheDir(const string &dir)	{cacheDir = dir;}
+
+	/** @param useCache if the cache is enabled look for the document there, keyed by a hash of
+	  * the file's content, rather than parsing it. Documents parsed are added to the cache. */
+	XmlNode *load(const string &path, bool useCache = false);
 	void save(const string &path, const XmlNode *node);
+
+	/** write a document in the binary format, which load() also reads. This is an encoding of
+	  * an already built XmlNode tree, not a streaming writer: the root's name and attributes
+	  * are followed by a section for each of its children (for saved games gui, settings and
+	  * world), encoded separately and zlib compressed if compress is set. @throws runtime_error */
+	void saveBinary(const string &path, const XmlNode *node, bool compress = true);
+	/** read a binary document back into an XmlNode tree @param section if not empty only the
+	  * root's child of this name is decoded, the other sections are skipped @throws runtime_error */
+	XmlNode *loadBinary(const string &path, const string &section = "");
+	/** @return true if the file is a binary document */
+	static bool isBinary(const string &path);
 	XmlNode *parseString(const char *doc, size_t size = (size_t)-1);
 };
 
@@ -133,6 +157,7 @@ public:
 
 	XmlNode *getParent() const;
 	const string &getText() const	{return text;}
+	void setText(const string &v)	{text = v;}
 
 	// get methods that return a specific type using the "value" attribute or appropriate attributes
 	// for vector types
@@ -370,7 +395,9 @@ public:
 	~XmlTree()						{delete rootNode;}
 
 	void init(const string &name)	{rootNode = new XmlNode(name);}
-	void load(const string &path)	{rootNode = XmlIo::getInstance().load(path);}
+	void load(const string &path, bool useCache = false) {
+		rootNode = XmlIo::getInstance().load(path, useCache);
+	}
 	void save(const string &path)	{XmlIo::getInstance().save(path, rootNode);}
 	void parse(const string &xml)	{rootNode = XmlIo::getInstance().parseString(xml.c_str());}
 
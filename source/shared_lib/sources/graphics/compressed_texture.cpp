@@ -0,0 +1,473 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "compressed_texture.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "pixmap.h"
+#include "math_util.h"
+#include "simd.h"
+#include "FSFactory.hpp"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Graphics {
+
+using namespace PhysFS;
+using Shared::Platform::uint16;
+using Shared::Platform::uint32;
+using std::min;
+using std::max;
+
+// =====================================================
+//	mipmaps
+// =====================================================
+
+void halveImage(const uint8 *src, int w, int h, int components, uint8 *dst) {
+	const int dw = max(1, w / 2);
+	const int dh = max(1, h / 2);
+	const int xStep = w > 1 ? 1 : 0;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+
+	for (int y=0; y < dh; ++y) {
+		const uint8 *row0 = src + 2 * y * w * components;
+		const uint8 *row1 = h > 1 ? row0 + w * components : row0;
+		uint8 *out = dst + y * dw * components;
+		int x = 0;
+		if (components == 4 && xStep) {
+			// four output pixels at a time, sums of a pixel's components are kept in 16 bits
+			for ( ; x + 4 <= dw; x += 4) {
+				const uint8 *p0 = row0 + x * 8, *p1 = row1 + x * 8;
+				__m128i result[2];
+				for (int i=0; i < 2; ++i) {
+					__m128i top = _mm_loadu_si128((const __m128i*)(p0 + i * 16));
+					__m128i bottom = _mm_loadu_si128((const __m128i*)(p1 + i * 16));
+					__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+					__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+					__m128i left = _mm_unpacklo_epi64(lo, hi);
+					__m128i right = _mm_unpackhi_epi64(lo, hi);
+					__m128i sum = _mm_add_epi16(_mm_add_epi16(left, right), two);
+					result[i] = _mm_srli_epi16(sum, 2);
+				}
+				_mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(result[0], result[1]));
+			}
+		}
+		for ( ; x < dw; ++x) {
+			const int x0 = 2 * x * components;
+			const int x1 = x0 + xStep * components;
+			for (int c=0; c < components; ++c) {
+				out[x * components + c] =
+					uint8((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+			}
+		}
+	}
+}
+
+// =====================================================
+//	DXT blocks
+// =====================================================
+
+namespace {
+
+inline uint16 toRgb565(const int *c) {
+	return uint16(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+inline void fromRgb565(uint16 v, uint8 *out) {
+	const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+	out[0] = uint8((r << 3) | (r >> 2));
+	out[1] = uint8((g << 2) | (g >> 4));
+	out[2] = uint8((b << 3) | (b >> 2));
+	out[3] = 255;
+}
+
+inline uint16 readUint16(const uint8 *in) {
+	return uint16(in[0] | (in[1] << 8));
+}
+
+inline void writeUint16(uint16 v, uint8 *out) {
+	out[0] = uint8(v);
+	out[1] = uint8(v >> 8);
+}
+
+/** The end points are the corners of the colours' bounding box, inset a little, along the
+  * diagonal that best follows the colours */
+void compressColourBlock(const uint8 *rgba, uint8 *out) {
+	int lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+	for (int i=0; i < 16; ++i) {
+		for (int c=0; c < 3; ++c) {
+			lo[c] = min(lo[c], int(rgba[i * 4 + c]));
+			hi[c] = max(hi[c], int(rgba[i * 4 + c]));
+		}
+	}
+	int centre[3], covRG = 0, covBG = 0;
+	for (int c=0; c < 3; ++c) {
+		centre[c] = (lo[c] + hi[c]) / 2;
+	}
+	for (int i=0; i < 16; ++i) {
+		const int dg = rgba[i * 4 + 1] - centre[1];
+		covRG += (rgba[i * 4] - centre[0]) * dg;
+		covBG += (rgba[i * 4 + 2] - centre[2]) * dg;
+	}
+	for (int c=0; c < 3; ++c) {
+		const int inset = (hi[c] - lo[c]) >> 4;
+		lo[c] += inset;
+		hi[c] -= inset;
+	}
+	if (covRG < 0) {
+		std::swap(lo[0], hi[0]);
+	}
+	if (covBG < 0) {
+		std::swap(lo[2], hi[2]);
+	}
+	uint16 c0 = toRgb565(hi), c1 = toRgb565(lo);
+	if (c0 < c1) {
+		// four colour mode needs c0 > c1
+		std::swap(c0, c1);
+	}
+	writeUint16(c0, out);
+	writeUint16(c1, out + 2);
+
+	uint32 indices = 0;
+	if (c0 != c1) {
+		uint8 palette[4][4];
+		fromRgb565(c0, palette[0]);
+		fromRgb565(c1, palette[1]);
+		for (int c=0; c < 3; ++c) {
+			palette[2][c] = uint8((2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = uint8((palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+		for (int i=0; i < 16; ++i) {
+			int best = 0, bestDist = 0x7FFFFFFF;
+			for (int j=0; j < 4; ++j) {
+				int dist = 0;
+				for (int c=0; c < 3; ++c) {
+					const int d = rgba[i * 4 + c] - palette[j][c];
+					dist += d * d;
+				}
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = j;
+				}
+			}
+			indices |= uint32(best) << (2 * i);
+		}
+	}
+	for (int i=0; i < 4; ++i) {
+		out[4 + i] = uint8(indices >> (8 * i));
+	}
+}
+
+/** The end points are the alpha extremes, using the eight value mode */
+void compressAlphaBlock(const uint8 *rgba, uint8 *out) {
+	int a0 = 0, a1 = 255;
+	for (int i=0; i < 16; ++i) {
+		a0 = max(a0, int(rgba[i * 4 + 3]));
+		a1 = min(a1, int(rgba[i * 4 + 3]));
+	}
+	out[0] = uint8(a0);
+	out[1] = uint8(a1);
+
+	uint64 indices = 0;
+	if (a0 != a1) {
+		int palette[8] = { a0, a1 };
+		for (int k=1; k < 7; ++k) {
+			palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+		}
+		for (int i=0; i < 16; ++i) {
+			int best = 0, bestDist = 256;
+			for (int j=0; j < 8; ++j) {
+				const int dist = abs(rgba[i * 4 + 3] - palette[j]);
+				if (dist < bestDist) {
+					bestDist = dist;
+					best = j;
+				}
+			}
+			indices |= uint64(best) << (3 * i);
+		}
+	}
+	for (int i=0; i < 6; ++i) {
+		out[2 + i] = uint8(indices >> (8 * i));
+	}
+}
+
+void decompressColourBlock(const uint8 *in, bool fourColour, uint8 *out_rgba) {
+	const uint16 c0 = readUint16(in), c1 = readUint16(in + 2);
+	uint8 palette[4][4];
+	fromRgb565(c0, palette[0]);
+	fromRgb565(c1, palette[1]);
+	if (fourColour || c0 > c1) {
+		for (int c=0; c < 3; ++c) {
+			palette[2][c] = uint8((2 * palette[0][c] + palette[1][c]) / 3);
+			palette[3][c] = uint8((palette[0][c] + 2 * palette[1][c]) / 3);
+		}
+		palette[2][3] = palette[3][3] = 255;
+	} else {
+		for (int c=0; c < 3; ++c) {
+			palette[2][c] = uint8((palette[0][c] + palette[1][c]) / 2);
+			palette[3][c] = 0;
+		}
+		palette[2][3] = 255;
+		palette[3][3] = 0;
+	}
+	const uint32 indices = in[4] | (in[5] << 8) | (in[6] << 16) | (uint32(in[7]) << 24);
+	for (int i=0; i < 16; ++i) {
+		memcpy(out_rgba + i * 4, palette[(indices >> (2 * i)) & 3], 4);
+	}
+}
+
+void decompressAlphaBlock(const uint8 *in, uint8 *out_rgba) {
+	const int a0 = in[0], a1 = in[1];
+	int palette[8] = { a0, a1 };
+	if (a0 > a1) {
+		for (int k=1; k < 7; ++k) {
+			palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+		}
+	} else {
+		for (int k=1; k < 5; ++k) {
+			palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	uint64 indices = 0;
+	for (int i=0; i < 6; ++i) {
+		indices |= uint64(in[2 + i]) << (8 * i);
+	}
+	for (int i=0; i < 16; ++i) {
+		out_rgba[i * 4 + 3] = uint8(palette[(indices >> (3 * i)) & 7]);
+	}
+}
+
+} // end anonymous namespace
+
+void compressDxtBlock(const uint8 *rgba, bool dxt5, uint8 *out) {
+	if (dxt5) {
+		compressAlphaBlock(rgba, out);
+		compressColourBlock(rgba, out + 8);
+	} else {
+		compressColourBlock(rgba, out);
+	}
+}
+
+void decompressDxtBlock(const uint8 *in, bool dxt5, uint8 *out_rgba) {
+	if (dxt5) {
+		decompressColourBlock(in + 8, true, out_rgba);
+		decompressAlphaBlock(in, out_rgba);
+	} else {
+		decompressColourBlock(in, false, out_rgba);
+	}
+}
+
+// =====================================================
+//	class CompressedTexture
+// =====================================================
+
+string CompressedTexture::cacheDir;
+
+namespace {
+
+// cache files are a header followed by the levels, each its size then the blocks. Integers are
+// little endian.
+const char cacheMagic[4] = {'G', 'D', 'X', 'T'};
+const uint32 cacheVersion = 1;
+
+string cacheFileName(uint64 hash) {
+	std::ostringstream ss;
+	ss << std::hex;
+	ss.width(16);
+	ss.fill('0');
+	ss << hash << ".dxt";
+	return ss.str();
+}
+
+void appendUint32(vector<uint8> &data, uint32 v) {
+	for (int i=0; i < 4; ++i) {
+		data.push_back(uint8(v >> (i * 8)));
+	}
+}
+
+bool readUint32(const vector<uint8> &data, size_t &pos, uint32 &out) {
+	if (data.size() - pos < 4) {
+		return false;
+	}
+	out = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) | (uint32(data[pos + 3]) << 24);
+	pos += 4;
+	return true;
+}
+
+/** number of levels in a full mipmap chain for a w x h base level, log2(max(w,h)) + 1 */
+uint32 fullChainLength(uint32 w, uint32 h) {
+	uint32 n = 1;
+	for (uint32 size = max(w, h); size > 1; size >>= 1) {
+		++n;
+	}
+	return n;
+}
+
+/** one level of the mipmaps, blocks at the edges are padded by repeating the last row/column */
+void compressLevel(const uint8 *pixels, int w, int h, int components, bool dxt5,
+		CompressedTexture::Level &level) {
+	const int blockSize = dxt5 ? 16 : 8;
+	const int bw = (w + 3) / 4, bh = (h + 3) / 4;
+	level.w = w;
+	level.h = h;
+	level.data.resize(bw * bh * blockSize);
+	uint8 block[16 * 4];
+	for (int by=0; by < bh; ++by) {
+		for (int bx=0; bx < bw; ++bx) {
+			for (int y=0; y < 4; ++y) {
+				const int sy = min(by * 4 + y, h - 1);
+				for (int x=0; x < 4; ++x) {
+					const int sx = min(bx * 4 + x, w - 1);
+					const uint8 *src = pixels + (sy * w + sx) * components;
+					uint8 *dst = block + (y * 4 + x) * 4;
+					dst[0] = src[0];
+					dst[1] = src[1];
+					dst[2] = src[2];
+					dst[3] = components == 4 ? src[3] : 255;
+				}
+			}
+			compressDxtBlock(block, dxt5, &level.data[(by * bw + bx) * blockSize]);
+		}
+	}
+}
+
+} // end anonymous namespace
+
+bool CompressedTexture::canCompress(const Pixmap2D *pixmap) {
+	return (pixmap->getComponents() == 3 || pixmap->getComponents() == 4)
+		&& isPowerOfTwo(pixmap->getW()) && isPowerOfTwo(pixmap->getH());
+}
+
+int CompressedTexture::getMemoryUsage() const {
+	int bytes = 0;
+	for (int i=0; i < m_levels.size(); ++i) {
+		bytes += m_levels[i].data.size();
+	}
+	return bytes;
+}
+
+void CompressedTexture::compress(const Pixmap2D *pixmap) {
+	assert(canCompress(pixmap));
+	const int components = pixmap->getComponents();
+	int w = pixmap->getW(), h = pixmap->getH();
+	m_dxt5 = components == 4;
+	m_levels.clear();
+
+	vector<uint8> image, half;
+	const uint8 *pixels = pixmap->getPixels();
+	while (true) {
+		m_levels.push_back(Level());
+		compressLevel(pixels, w, h, components, m_dxt5, m_levels.back());
+		if (w == 1 && h == 1) {
+			break;
+		}
+		half.resize(max(1, w / 2) * max(1, h / 2) * components);
+		halveImage(pixels, w, h, components, &half[0]);
+		image.swap(half);
+		pixels = &image[0];
+		w = max(1, w / 2);
+		h = max(1, h / 2);
+	}
+}
+
+bool CompressedTexture::loadCached(uint64 hash) {
+	const string cachePath = cacheDir + cacheFileName(hash);
+	if (!FSFactory::fileExists(cachePath)) {
+		return false;
+	}
+	FileOps *fops = FSFactory::getInstance()->getFileOps();
+	vector<uint8> data;
+	try {
+		fops->openRead(cachePath.c_str());
+		data.resize(fops->fileSize());
+		if (!data.empty() && fops->read(&data[0], data.size(), 1) != 1) {
+			data.clear();
+		}
+	} catch (runtime_error &) {
+		data.clear();
+	}
+	delete fops;
+
+	size_t pos = 4;
+	uint32 version, hashLo, hashHi, dxt5, levelCount;
+	if (data.size() < 4 || memcmp(&data[0], cacheMagic, 4) != 0
+	|| !readUint32(data, pos, version) || version != cacheVersion
+	|| !readUint32(data, pos, hashLo) || !readUint32(data, pos, hashHi)
+	|| (uint64(hashLo) | (uint64(hashHi) << 32)) != hash
+	|| !readUint32(data, pos, dxt5) || !readUint32(data, pos, levelCount)) {
+		return false;
+	}
+	if (levelCount == 0) {
+		return false;
+	}
+	vector<Level> levels;
+	for (uint32 i=0; i < levelCount; ++i) {
+		uint32 w, h, size;
+		if (!readUint32(data, pos, w) || !readUint32(data, pos, h) || !readUint32(data, pos, size)
+		|| data.size() - pos < size) {
+			return false;
+		}
+		if (i == 0) {
+			// a corrupt count is a cache miss, not a huge allocation
+			if (w == 0 || h == 0 || levelCount > fullChainLength(w, h)) {
+				return false;
+			}
+			levels.resize(levelCount);
+		}
+		levels[i].w = w;
+		levels[i].h = h;
+		levels[i].data.assign(data.begin() + pos, data.begin() + pos + size);
+		pos += size;
+	}
+	if (pos != data.size()) {
+		return false;
+	}
+	m_dxt5 = dxt5 != 0;
+	m_levels.swap(levels);
+	return true;
+}
+
+void CompressedTexture::saveCached(uint64 hash) const {
+	vector<uint8> data(cacheMagic, cacheMagic + 4);
+	appendUint32(data, cacheVersion);
+	appendUint32(data, uint32(hash));
+	appendUint32(data, uint32(hash >> 32));
+	appendUint32(data, m_dxt5 ? 1 : 0);
+	appendUint32(data, m_levels.size());
+	for (int i=0; i < m_levels.size(); ++i) {
+		appendUint32(data, m_levels[i].w);
+		appendUint32(data, m_levels[i].h);
+		appendUint32(data, m_levels[i].data.size());
+		data.insert(data.end(), m_levels[i].data.begin(), m_levels[i].data.end());
+	}
+
+	const string cachePath = cacheDir + cacheFileName(hash);
+	FileOps *fops = FSFactory::getInstance()->getFileOps();
+	try {
+		fops->openWrite(cachePath.c_str());
+		fops->write(&data[0], data.size(), 1);
+	} catch (runtime_error &) {
+		// the cache is only an optimisation, failing to write it is not an error
+	}
+	delete fops;
+}
+
+}}//end namespace
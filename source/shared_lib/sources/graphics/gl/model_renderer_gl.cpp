@@ -332,9 +332,6 @@ void ModelRendererGl::renderMesh(const Mesh *mesh, float fade, int frame, int id
 	assertGl();
 
 	const RenderMode &mode = m_renderMode;
-	if (mode == RenderMode::SELECTION && mesh->isNoSelect()) {
-		return;
-	}
 
 	bool renderTextures = (mode == RenderMode::UNITS || mode == RenderMode::OBJECTS || mode == RenderMode::SHADOWS);
 	bool sendNormals = (mode == RenderMode::UNITS || mode == RenderMode::OBJECTS);
@@ -404,7 +401,7 @@ void ModelRendererGl::renderMesh(const Mesh *mesh, float fade, int frame, int id
 	}
 
 	ShaderProgram *shaderProgram;
-	if (m_shaderIndex == -1 || mode == RenderMode::SELECTION || mode == RenderMode::SHADOWS) {
+	if (m_shaderIndex == -1 || mode == RenderMode::SHADOWS) {
 		shaderProgram = m_fixedFunctionProgram;
 		if (m_meshCallback) {
 			m_meshCallback->execute(mesh);
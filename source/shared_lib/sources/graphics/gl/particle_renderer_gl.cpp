@@ -164,14 +164,14 @@ void ParticleRendererGl::renderSystem(ParticleSystem *ps) {
 	//fill vertex buffer with billboards
 	int bufferIndex[MAX_PARTICLE_BUFFERS] = { 0 };
 
+	const ParticleStore &particles = ps->getParticles();
 	for (int i = 0; i < ps->getAliveParticleCount(); ++i) {
-		const Particle *particle = ps->getParticle(i);
-		int tex = particle->texture;
-		float size = particle->getSize() * 0.5f;
-		Vec3f pos = particle->getPos();
-		Vec4f color = particle->getColor();
-		if (particle->getAngle() != 0.f) {
-			GLMatrix rotMat = buildRotationMatrix(particle->getAngle(), rotAxis);
+		int tex = particles.texture[i];
+		float size = particles.size[i] * 0.5f;
+		const Vec3f &pos = particles.pos[i];
+		const Vec4f &color = particles.colour[i];
+		if (particles.angle[i] != 0.f) {
+			GLMatrix rotMat = buildRotationMatrix(particles.angle[i], rotAxis);
 			Vec3f myRightVec = rotMat * rightVector;
 			Vec3f myUpVec = rotMat * upVector;
 			vertexBuffer[tex][bufferIndex[tex]] = pos - (myRightVec - myUpVec) * size;
@@ -210,7 +210,7 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps) {
 	assert(rendering);
 
 	if (ps->anyParticle()) {
-		const Particle *particle = ps->getParticle(0);
+		const ParticleStore &particles = ps->getParticles();
 
 		setBlendFunc(ps->getSrcBlendFactor(), ps->getDestBlendFactor());
 		setBlendEquation(ps->getBlendEquationMode());
@@ -224,16 +224,14 @@ void ParticleRendererGl::renderSystemLine(ParticleSystem *ps) {
 
 		//fill vertex buffer with lines
 		int bufferIndex = 0;
-		glLineWidth(particle->getSize());
+		glLineWidth(particles.size[0]);
 
 		for (int i = 0; i < ps->getAliveParticleCount(); ++i) {
-			particle = ps->getParticle(i);
+			vertexBuffer[0][bufferIndex] = particles.pos[i];
+			vertexBuffer[0][bufferIndex + 1] = particles.lastPos[i];
 
-			vertexBuffer[0][bufferIndex] = particle->getPos();
-			vertexBuffer[0][bufferIndex + 1] = particle->getLastPos();
-
-			colorBuffer[0][bufferIndex] = particle->getColor();
-			colorBuffer[0][bufferIndex + 1] = particle->getColor2();
+			colorBuffer[0][bufferIndex] = particles.colour[i];
+			colorBuffer[0][bufferIndex + 1] = particles.colour2[i];
 
 			bufferIndex += 2;
 
@@ -16,6 +16,7 @@
 
 #include "opengl.h"
 #include "math_util.h"
+#include "compressed_texture.h"
 
 #include "leak_dumper.h"
 
@@ -219,7 +220,46 @@ void Texture1DGl::end() {
 //	class Texture2DGl
 // =====================================================
 
+/** upload mipmaps compressed on the CPU */
+void Texture2DGl::initCompressed(Filter filter, int maxAnisotropy) {
+	const GLenum glInternalFormat = m_compressed->isDxt5()
+		? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	GLint wrap = toWrapModeGl(wrapMode);
+	GLuint glFilter = filter == fTrilinear ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST;
+
+	glGenTextures(1, &handle);
+	glBindTexture(GL_TEXTURE_2D, handle);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+	if (isGlExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	for (int i=0; i < m_compressed->getLevelCount(); ++i) {
+		const CompressedTexture::Level &level = m_compressed->getLevel(i);
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, level.w, level.h, 0,
+			level.data.size(), &level.data[0]);
+	}
+	GLint error = glGetError();
+	if (error != GL_NO_ERROR) {
+		string msg = (char*)gluErrorString(error);
+		stringstream ss;
+		ss	<< "Error sending compressed texture data to GL: " << msg << endl
+			<< "Width: " << m_compressed->getLevel(0).w << ", height: " << m_compressed->getLevel(0).h << endl;
+		throw runtime_error(ss.str());
+	}
+	memoryUsage = m_compressed->getMemoryUsage();
+	delete m_compressed;
+	m_compressed = 0;
+}
+
 void Texture2DGl::init(Filter filter, int maxAnisotropy) {
+	if (!inited && m_compressed) {
+		initCompressed(filter, maxAnisotropy);
+		inited = true;
+	}
 	if (!inited) {
 		if (!isPowerOfTwo(pixmap->getW()) || !isPowerOfTwo(pixmap->getH())) {
 			throw runtime_error("Texture dimensions are not both a power of two.");
@@ -237,6 +277,15 @@ void Texture2DGl::init(Filter filter, int maxAnisotropy) {
 		//pixel init var
 		const uint8* pixels = pixmap->getPixels();
 
+		// a full mipmap chain adds a third, compressed formats are 4:1 or better
+		memoryUsage = pixmap->getW() * pixmap->getH() * pixmap->getComponents();
+		if (mipmap) {
+			memoryUsage = memoryUsage * 4 / 3;
+		}
+		if (compressTextures) {
+			memoryUsage /= 4;
+		}
+
 		//gen texture
 		glGenTextures(1, &handle);
 		glBindTexture(GL_TEXTURE_2D, handle);
@@ -114,19 +114,70 @@ void test_interpolate() {
 // class InterpolationData
 // =====================================================
 
-InterpolationData::InterpolationData(Mesh *mesh) {
-	this->mesh = mesh;
+int InterpolationData::cacheBytes = 0;
+int InterpolationData::hits = 0;
+int InterpolationData::misses = 0;
+
+InterpolationData::InterpolationData(Mesh *mesh)
+		: mesh(mesh), slotCount(0), current(0), useCounter(0) {
+	for (int i = 0; i < maxSlots; ++i) {
+		slots[i].phase = -1;
+		slots[i].cycle = false;
+		slots[i].lastUsed = 0;
+	}
 	if (mesh->getFrameCount() > 1) {
-		data.init(mesh->getAnimVertBlock(0).type, mesh->getVertexCount());
+		slots[0].data.init(mesh->getAnimVertBlock(0).type, mesh->getVertexCount());
+		slotCount = 1;
 	}
 }
 
-InterpolationData::~InterpolationData() { }
+InterpolationData::~InterpolationData() {
+	if (slotCount > 1) {
+		cacheBytes -= (slotCount - 1) * slots[0].data.getStride() * mesh->getVertexCount();
+	}
+}
 
 void InterpolationData::update(float t, bool cycle) {
     // this shouldn't be needed...
 	t = clamp(t, 0.f, 1.f);
+	const int phase = int(t * phaseSteps + 0.5f);
+	++useCounter;
+
+	// already have it?
+	for (int i = 0; i < slotCount; ++i) {
+		if (slots[i].phase == phase && slots[i].cycle == cycle) {
+			slots[i].lastUsed = useCounter;
+			current = i;
+			++hits;
+			return;
+		}
+	}
+	++misses;
+
+	// allocate another slot if allowed, else reuse the least recently used
+	const int slotBytes = slots[0].data.getStride() * mesh->getVertexCount();
+	if (slotCount < maxSlots && cacheBytes + slotBytes <= maxCacheBytes) {
+		current = slotCount++;
+		slots[current].data.init(slots[0].data.type, mesh->getVertexCount());
+		cacheBytes += slotBytes;
+	} else {
+		current = 0;
+		for (int i = 1; i < slotCount; ++i) {
+			if (useCounter - slots[i].lastUsed > useCounter - slots[current].lastUsed) {
+				current = i;
+			}
+		}
+	}
+	Slot &slot = slots[current];
+	slot.phase = phase;
+	slot.cycle = cycle;
+	slot.lastUsed = useCounter;
+
+	// interpolate to the quantised t, so the result is the same whichever instance asked first
+	interpolateTo(slot.data, float(phase) / phaseSteps, cycle);
+}
 
+void InterpolationData::interpolateTo(MeshVertexBlock &data, float t, bool cycle) {
 	// sanity check, part 1
 	uint32 frameCount = mesh->getFrameCount();
 	uint32 vertexCount = mesh->getVertexCount();
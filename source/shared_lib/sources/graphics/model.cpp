@@ -13,6 +13,7 @@
 #include "pch.h"
 #include "model.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cassert>
 #include <stdexcept>
@@ -66,6 +67,7 @@ Mesh::Mesh() {
 /** delete VBOs and any remaining data in system RAM */
 Mesh::~Mesh() {
 	delete interpolationData;
+	delete m_loadData;
 	if (frameCount > 1) {
 		delete [] m_vertices_anim;
 	}
@@ -106,6 +108,14 @@ void Mesh::initMemory() {
 
 /** Fill vertex and index VBOs and delete system RAM copies */
 void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *texCoords, uint32 *indices) {
+	// bounds, kept for picking as the vertex data may not stay in system RAM
+	m_boundsMin = m_boundsMax = vertexCount ? vertices[0] : Vec3f(0.f);
+	for (int i=1; i < frameCount * vertexCount; ++i) {
+		for (int j=0; j < 3; ++j) {
+			m_boundsMin.raw[j] = std::min(m_boundsMin.raw[j], vertices[i].raw[j]);
+			m_boundsMax.raw[j] = std::max(m_boundsMax.raw[j], vertices[i].raw[j]);
+		}
+	}
 
 	if (use_tangents && tangents) {
 
@@ -123,6 +133,7 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 				m_texCoordData.freeMemory();
 			}
 			// fill interleaved arrays (Vertex_PNT)
+			m_memoryUsage = sizeof(Vertex_U) * vertexCount + sizeof(Vertex_PNT) * vertexCount * frameCount;
 			m_vertices_anim = new MeshVertexBlock[frameCount];
 			for (int i=0; i < frameCount; ++i) {
 				m_vertices_anim[i].init(MeshVertexBlock::POS_NORM_TAN, vertexCount);
@@ -135,6 +146,7 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 			}
 		} else {
 			// fill interleaved array (Vertex_PNTU)
+			m_memoryUsage = sizeof(Vertex_PNTU) * vertexCount;
 			m_vertices_frame0.init(MeshVertexBlock::POS_NORM_TAN_UV, vertexCount);
 			Vertex_PNTU *vertData = m_vertices_frame0.m_posNormTanTex;
 			for (int i=0; i < vertexCount; ++i) {
@@ -169,6 +181,7 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 			}
 
 			// fill interleaved arrays (Vertex_PN)
+			m_memoryUsage = sizeof(Vertex_U) * vertexCount + sizeof(Vertex_PN) * vertexCount * frameCount;
 			m_vertices_anim = new MeshVertexBlock[frameCount];
 			for (int i=0; i < frameCount; ++i) {
 				m_vertices_anim[i].init(MeshVertexBlock::POS_NORM, vertexCount);
@@ -180,6 +193,7 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 			}
 		} else {
 			// fill interleaved array (Vertex_PNU)
+			m_memoryUsage = sizeof(Vertex_PNU) * vertexCount;
 			m_vertices_frame0.init(MeshVertexBlock::POS_NORM_UV, vertexCount);
 			Vertex_PNU *vertData = m_vertices_frame0.m_posNormTex;
 			for (int i=0; i < vertexCount; ++i) {
@@ -197,6 +211,7 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 		}
 	}
 
+	m_memoryUsage += (vertexCount < 65536 ? sizeof(uint16) : sizeof(uint32)) * indexCount;
 	if (vertexCount < 65536) {
 		m_indices.init(MeshIndexBlock::UNSIGNED_16, indexCount);
 		for (int i=0; i < indexCount; ++i) {
@@ -226,38 +241,39 @@ void Mesh::fillBuffers(Vec3f *vertices, Vec3f *normals, Vec3f *tangents, Vec2f *
 }
 
 /** somewhat hacky way to load textures into the specular, normal and 2 custom slots */
-void Mesh::loadAdditionalTextures(const string &diffusePath, TextureManager *textureManager) {
+void Mesh::findAdditionalTextures(const string &diffusePath) {
 	string checkPath;
+	string *paths = m_loadData->texturePaths;
 	// spec map
-	if (!textures[MeshTexture::SPECULAR]) {
+	if (paths[MeshTexture::SPECULAR].empty()) {
 		checkPath = diffusePath; // insert _specular before . in filename
 		checkPath.insert(checkPath.length() - 4, "_specular");
 		if (fileExists(checkPath)) {
-			textures[MeshTexture::SPECULAR] = textureManager->getTexture(checkPath);
+			paths[MeshTexture::SPECULAR] = checkPath;
 		}
 	}
 	// bump map
-	if (!textures[MeshTexture::NORMAL]) {
+	if (paths[MeshTexture::NORMAL].empty()) {
 		checkPath = diffusePath; // insert _normal before . in filename
 		checkPath.insert(checkPath.length() - 4, "_normal");
 		if (fileExists(checkPath)) {
-			textures[MeshTexture::NORMAL] = textureManager->getTexture(checkPath);
+			paths[MeshTexture::NORMAL] = checkPath;
 		}
 	}
 	//  light map
-	if (!textures[MeshTexture::LIGHT]) {
+	if (paths[MeshTexture::LIGHT].empty()) {
 		checkPath = diffusePath;
 		checkPath.insert(checkPath.length() - 4, "_light");
 		if (fileExists(checkPath)) {
-			textures[MeshTexture::NORMAL] = textureManager->getTexture(checkPath);
+			paths[MeshTexture::NORMAL] = checkPath;
 		}
 	}
 	// custom textures
-	if (!textures[MeshTexture::CUSTOM]) {
+	if (paths[MeshTexture::CUSTOM].empty()) {
 		checkPath = diffusePath;
 		checkPath.insert(checkPath.length() - 4, "_custom");
 		if (fileExists(checkPath)) {
-			textures[MeshTexture::CUSTOM] = textureManager->getTexture(checkPath);
+			paths[MeshTexture::CUSTOM] = checkPath;
 		}
 	}
 }
@@ -282,13 +298,7 @@ void Mesh::updateInterpolationData(float t, bool cycle) const {
 
 // ==================== load ====================
 
-void Mesh::loadV3(const string &dir, FileOps *f, TextureManager *textureManager) {
-	Vec3f *vertices = 0;
-	Vec3f *normals = 0;
-	Vec2f *texCoords = 0;
-	Vec3f *tangents = 0;
-	uint32 *indices = 0;
-
+void Mesh::readV3(const string &dir, FileOps *f, bool readTextures) {
 	// read header
 	MeshHeaderV3 meshHeader;
 	f->read(&meshHeader, sizeof(MeshHeaderV3), 1);
@@ -301,11 +311,13 @@ void Mesh::loadV3(const string &dir, FileOps *f, TextureManager *textureManager)
 	vertexCount = meshHeader.pointCount;
 	indexCount = meshHeader.indexCount;
 
-	initMemory();
-	vertices = new Vec3f[frameCount * vertexCount];
-	normals = new Vec3f[frameCount * vertexCount];
-	texCoords = new Vec2f[vertexCount];
-	indices = new uint32[indexCount];
+	delete m_loadData;
+	m_loadData = new MeshLoadData();
+	MeshLoadData &data = *m_loadData;
+	data.vertices = new Vec3f[frameCount * vertexCount];
+	data.normals = new Vec3f[frameCount * vertexCount];
+	data.texCoords = new Vec2f[vertexCount];
+	data.indices = new uint32[indexCount];
 
 	MESH_DEBUG( "Reading flags." );
 
@@ -315,15 +327,15 @@ void Mesh::loadV3(const string &dir, FileOps *f, TextureManager *textureManager)
 	noSelect = false;
 
 	// texture
-	if (!(meshHeader.properties & mp3NoTexture) && textureManager != NULL) {
+	if (!(meshHeader.properties & mp3NoTexture) && readTextures) {
 		MESH_DEBUG( "texture...1" );
 		string texPath = toLower(reinterpret_cast<char*>(meshHeader.texName));
 		MESH_DEBUG( "texture...2 texPath = " << texPath );
 		texPath = dir + "/" + texPath;
 		texPath = cleanPath(texPath);
-		MESH_DEBUG( "Loading diffuse texture '" << texPath << "'." );
-		textures[MeshTexture::DIFFUSE] = textureManager->getTexture(texPath);
-		loadAdditionalTextures(texPath, textureManager);
+		MESH_DEBUG( "Found diffuse texture '" << texPath << "'." );
+		data.texturePaths[MeshTexture::DIFFUSE] = texPath;
+		findAdditionalTextures(texPath);
 	} else {
 		MESH_DEBUG( "no texture." );
 	}
@@ -331,13 +343,13 @@ void Mesh::loadV3(const string &dir, FileOps *f, TextureManager *textureManager)
 	// read data
 	size_t vfCount = frameCount * vertexCount;
 	MESH_DEBUG( "Vertex position and normal data: Reading " << (vfCount * 6) << " floats into arrays." );
-	f->read(vertices, sizeof(Vec3f)*vfCount, 1);
-	f->read(normals, sizeof(Vec3f)*vfCount, 1);
-	if (textures[MeshTexture::DIFFUSE] != 0) {
+	f->read(data.vertices, sizeof(Vec3f)*vfCount, 1);
+	f->read(data.normals, sizeof(Vec3f)*vfCount, 1);
+	if (!data.texturePaths[MeshTexture::DIFFUSE].empty()) {
 		int n = meshHeader.texCoordFrameCount * vertexCount * 2;
 		MESH_DEBUG( "Texture co-ordinate data: Reading " << n << " floats into array(s)." );
 		for (int i=0; i < meshHeader.texCoordFrameCount; ++i) {
-			f->read(texCoords, sizeof(Vec2f) * vertexCount, 1);
+			f->read(data.texCoords, sizeof(Vec2f) * vertexCount, 1);
 		}
 	}
 	MESH_DEBUG( "Reading diffuse colour and opacity." );
@@ -345,22 +357,15 @@ void Mesh::loadV3(const string &dir, FileOps *f, TextureManager *textureManager)
 	f->read(&opacity, sizeof(float32), 1);
 
 	f->seek(sizeof(Vec4f)*(meshHeader.colorFrameCount-1), SEEK_CUR);
-	f->read(indices, sizeof(uint32)*indexCount, 1);
+	f->read(data.indices, sizeof(uint32)*indexCount, 1);
 
-	if (textures[MeshTexture::NORMAL]) {
-		computeTangents(vertices, texCoords, indices, tangents);
+	if (!data.texturePaths[MeshTexture::NORMAL].empty()) {
+		computeTangents(data.vertices, data.texCoords, data.indices, data.tangents);
 	}
-	fillBuffers(vertices, normals, tangents, texCoords, indices);
 }
 
 // G3D V4
-void Mesh::load(const string &dir, FileOps *f, TextureManager *textureManager){
-	Vec3f *vertices = 0;
-	Vec3f *normals = 0;
-	Vec2f *texCoords = 0;
-	Vec3f *tangents = 0;
-	uint32 *indices = 0;
-
+void Mesh::read(const string &dir, FileOps *f, bool readTextures){
 	// read header
 	MeshHeader meshHeader;
 	if (f->read(&meshHeader, sizeof(MeshHeader), 1) != 1) {
@@ -372,11 +377,14 @@ void Mesh::load(const string &dir, FileOps *f, TextureManager *textureManager){
 	vertexCount = meshHeader.vertexCount;
 	indexCount = meshHeader.indexCount;
 
-	initMemory();
-	vertices = new Vec3f[frameCount * vertexCount];
-	normals = new Vec3f[frameCount * vertexCount];
-	texCoords = new Vec2f[vertexCount];
-	indices = new uint32[indexCount];
+	// arrays are owned by m_loadData, errors below leave them to be deleted with the mesh
+	delete m_loadData;
+	m_loadData = new MeshLoadData();
+	MeshLoadData &data = *m_loadData;
+	data.vertices = new Vec3f[frameCount * vertexCount];
+	data.normals = new Vec3f[frameCount * vertexCount];
+	data.texCoords = new Vec2f[vertexCount];
+	data.indices = new uint32[indexCount];
 
 	// properties
 	customColor = (meshHeader.properties & mpfCustomColor) != 0;
@@ -391,71 +399,75 @@ void Mesh::load(const string &dir, FileOps *f, TextureManager *textureManager){
 
 	// maps
 	uint32 flag = 1;
-	string diffuseTexPath;
 	for (int i=0; i < MeshTexture::COUNT; ++i) {
-		if ((meshHeader.textures & flag) && textureManager != NULL) {
+		if ((meshHeader.textures & flag) && readTextures) {
 			uint8 cMapPath[mapPathSize];
 			f->read(cMapPath, mapPathSize, 1);
 			string mapPath = toLower(reinterpret_cast<char*>(cMapPath));
 			assert(mapPath != "");
-			string mapFullPath = dir + "/" + mapPath;
-			if (flag == 1) {
-				diffuseTexPath = mapFullPath;
-			}
-			//texturePaths[i] = mapPath;
-			textures[i] = static_cast<Texture2D*>(textureManager->getTexture(mapFullPath));
+			data.texturePaths[i] = cleanPath(dir + "/" + mapPath);
 		}
 		flag *= 2;
 	}
-	if (textures[MeshTexture::DIFFUSE]) {
-		assert(!diffuseTexPath.empty());
-		loadAdditionalTextures(diffuseTexPath, textureManager);
+	if (!data.texturePaths[MeshTexture::DIFFUSE].empty()) {
+		findAdditionalTextures(data.texturePaths[MeshTexture::DIFFUSE]);
 	}
 
 	// read data. (Assume packed vectors)
 	size_t vfCount = frameCount * vertexCount;
 	if (vfCount) {
-		if (f->read(vertices, 12 * vfCount, 1) != 1) {
-			delete [] vertices;
-			delete [] normals;
-			delete [] tangents;
-			delete [] texCoords;
-			delete [] indices;
+		if (f->read(data.vertices, 12 * vfCount, 1) != 1) {
 			throw runtime_error("error reading mesh, insufficient vertex data.");
 		}
 		//cout << "reading " << (vfCount * 12) << " bytes of normal data.\n";
-		if (f->read(normals, 12 * vfCount, 1) != 1) {
-			delete [] vertices;
-			delete [] normals;
-			delete [] tangents;
-			delete [] texCoords;
-			delete [] indices;
+		if (f->read(data.normals, 12 * vfCount, 1) != 1) {
 			throw runtime_error("error reading mesh, insufficient normal vector data.");
 		}
 	}
 
-	if (meshHeader.textures && f->read(texCoords, sizeof(Vec2f)*vertexCount, 1) != 1) {
-		delete [] vertices;
-		delete [] normals;
-		delete [] tangents;
-		delete [] texCoords;
-		delete [] indices;
+	if (meshHeader.textures && f->read(data.texCoords, sizeof(Vec2f)*vertexCount, 1) != 1) {
 		throw runtime_error("error reading mesh, insufficient texture co-ordinate data.");
 	}
 	if (indexCount) {
-		if (f->read(indices, sizeof(uint32)*indexCount, 1) != 1) {
-			delete [] vertices;
-			delete [] normals;
-			delete [] tangents;
-			delete [] texCoords;
-			delete [] indices;
+		if (f->read(data.indices, sizeof(uint32)*indexCount, 1) != 1) {
 			throw runtime_error("error reading mesh, insufficient vertex index data.");
 		}
 	}
-	if (textures[MeshTexture::NORMAL]) {
-		computeTangents(vertices, texCoords, indices, tangents);
+	if (!data.texturePaths[MeshTexture::NORMAL].empty()) {
+		computeTangents(data.vertices, data.texCoords, data.indices, data.tangents);
+	}
+}
+
+/** get textures and fill buffers from the data read, on the main thread */
+void Mesh::upload(TextureManager *textureManager) {
+	assert(m_loadData);
+	MeshLoadData *data = m_loadData;
+	m_loadData = 0;
+
+	initMemory();
+	if (textureManager) {
+		for (int i=0; i < MeshTexture::COUNT; ++i) {
+			if (!data->texturePaths[i].empty()) {
+				textures[i] = textureManager->getTexture(data->texturePaths[i]);
+			}
+		}
+	}
+	fillBuffers(data->vertices, data->normals, data->tangents, data->texCoords, data->indices);
+	// fillBuffers() deleted the arrays
+	data->vertices = data->normals = data->tangents = 0;
+	data->texCoords = 0;
+	data->indices = 0;
+	delete data;
+}
+
+void Mesh::getTexturePaths(vector<string> &out_paths) const {
+	if (m_loadData) {
+		for (int i=0; i < MeshTexture::COUNT; ++i) {
+			if (!m_loadData->texturePaths[i].empty()) {
+				out_paths.push_back(m_loadData->texturePaths[i]);
+			}
+		}
 	}
-	fillBuffers(vertices, normals, tangents, texCoords, indices);
 }
 
 void Mesh::buildCube(int size, int height, Texture2D *tex) {
@@ -658,6 +670,8 @@ Model::Model(){
 	meshCount= 0;
 	meshes= NULL;
 	textureManager= NULL;
+	m_boundsMin = Vec3f(1.f);
+	m_boundsMax = Vec3f(-1.f);
 }
 
 Model::~Model(){
@@ -685,22 +699,86 @@ uint32 Model::getVertexCount() const{
 	return vertexCount;
 }
 
+uint32 Model::getMemoryUsage() const{
+	uint32 bytes= 0;
+	for(uint32 i=0; i<meshCount; ++i){
+		bytes+= meshes[i].getMemoryUsage();
+	}
+	return bytes;
+}
+
 // ==================== io ====================
 
 void Model::load(const string &path, int size, int height) {
+	read(path);
+	upload(size, height);
+}
+
+void Model::read(const string &path) {
+	m_loadPath = path;
+	m_loadError.clear();
 	string extension = path.substr(path.find_last_of('.') + 1);
 	try {
 		if (extension == "g3d" || extension == "G3D") {
-			loadG3d(path);
+			readG3d(path);
 		} else {
 			throw runtime_error("Unknown model format: " + extension);
 		}
 	} catch (runtime_error &e) {
+		delete [] meshes;
+		meshes = NULL;
+		meshCount = 0;
+		m_loadError = e.what();
+	}
+}
+
+void Model::upload(int size, int height) {
+	if (m_loadError.empty()) {
+		uploadMeshes();
+	} else {
 		meshCount = 1;
 		meshes = new Mesh[1];
 		meshes[0].buildCube(size, height, Texture2D::defaultTexture);
 		meshes[0].buildInterpolationData();
-		mediaErrorLog.add(e.what(), path);
+		mediaErrorLog.add(m_loadError, m_loadPath);
+		m_loadError.clear();
+	}
+	computeBounds();
+}
+
+void Model::uploadMeshes() {
+	for (uint32 i=0; i < meshCount; ++i) {
+		meshes[i].upload(textureManager);
+		meshes[i].buildInterpolationData();
+	}
+}
+
+void Model::getTexturePaths(vector<string> &out_paths) const {
+	for (uint32 i=0; i < meshCount; ++i) {
+		meshes[i].getTexturePaths(out_paths);
+	}
+}
+
+/** Union of the selectable mesh bounds */
+void Model::computeBounds() {
+	m_boundsMin = Vec3f(1.f);
+	m_boundsMax = Vec3f(-1.f);
+	bool first = true;
+	for (uint32 i=0; i < meshCount; ++i) {
+		const Mesh &mesh = meshes[i];
+		if (mesh.isNoSelect() || !mesh.getVertexCount()) {
+			continue;
+		}
+		if (first) {
+			m_boundsMin = mesh.getBoundsMin();
+			m_boundsMax = mesh.getBoundsMax();
+			first = false;
+		} else {
+			for (int j=0; j < 3; ++j) {
+				m_boundsMin.raw[j] = std::min(m_boundsMin.raw[j], mesh.getBoundsMin().raw[j]);
+				m_boundsMax.raw[j] = std::max(m_boundsMax.raw[j], mesh.getBoundsMax().raw[j]);
+			}
+		}
 	}
 }
 
@@ -714,7 +792,14 @@ void Model::save(const string &path){
 }
 
 // load a model from a g3d file
-void Model::loadG3d(const string &path){
+void Model::loadG3d(const string &path) {
+	readG3d(path);
+	uploadMeshes();
+	computeBounds();
+}
+
+// read a model from a g3d file, without uploading it
+void Model::readG3d(const string &path){
 	std::auto_ptr<FileOps> f(FSFactory::getInstance()->getFileOps());
 	f->openRead(path.c_str());
 
@@ -747,8 +832,7 @@ void Model::loadG3d(const string &path){
 		meshes = new Mesh[meshCount];
 		for (uint32 i=0; i < meshCount; ++i) {
 			OUTPUT_MODEL_INFO("\tLoading mesh " << i << endl);
-			meshes[i].load(dir, f.get(), textureManager);
-			meshes[i].buildInterpolationData();
+			meshes[i].read(dir, f.get(), textureManager != NULL);
 			OUTPUT_MODEL_INFO("\t\tVertex count: " << meshes[i].getVertexCount() << endl);
 			OUTPUT_MODEL_INFO("\t\tFrame count: " << meshes[i].getFrameCount() << endl);
 		}
@@ -759,8 +843,7 @@ void Model::loadG3d(const string &path){
 		meshes= new Mesh[meshCount];
 		for (uint32 i=0; i < meshCount; ++i) {
 			OUTPUT_MODEL_INFO("\tLoading mesh " << i << endl);
-			meshes[i].loadV3(dir, f.get(), textureManager);
-			meshes[i].buildInterpolationData();
+			meshes[i].readV3(dir, f.get(), textureManager != NULL);
 			OUTPUT_MODEL_INFO("\t\tVertex count: " << meshes[i].getVertexCount() << endl);
 			OUTPUT_MODEL_INFO("\t\tFrame count: " << meshes[i].getFrameCount() << endl);
 		}
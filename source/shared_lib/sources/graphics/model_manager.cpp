@@ -14,12 +14,15 @@
 
 #include "graphics_interface.h"
 #include "graphics_factory.h"
+#include "util.h"
 
 #include "leak_dumper.h"
 
 
 namespace Shared{ namespace Graphics{
 
+using Util::cleanPath;
+
 // =====================================================
 //	class ModelManager
 // =====================================================
@@ -39,6 +42,30 @@ Model *ModelManager::newModel(){
 	return model;
 }
 
+Model *ModelManager::newModel(const string &path){
+	string cleanedPath= cleanPath(path);
+	assert(m_pathIndex.find(cleanedPath) == m_pathIndex.end());
+	Model *model= newModel();
+	m_pathIndex[cleanedPath]= model;
+	return model;
+}
+
+Model *ModelManager::getModel(const string &path){
+	PathIndex::iterator it= m_pathIndex.find(cleanPath(path));
+	if(it == m_pathIndex.end()){
+		return NULL;
+	}
+	return it->second;
+}
+
+int64 ModelManager::getMemoryUsage() const{
+	int64 bytes= 0;
+	for(size_t i=0; i<models.size(); ++i){
+		bytes+= models[i]->getMemoryUsage();
+	}
+	return bytes;
+}
+
 void ModelManager::init(){
 	for(size_t i=0; i<models.size(); ++i){
 		models[i]->init();
@@ -51,6 +78,7 @@ void ModelManager::end(){
 		delete models[i];
 	}
 	models.clear();
+	m_pathIndex.clear();
 }
 
 
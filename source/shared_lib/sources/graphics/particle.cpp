@@ -21,6 +21,7 @@
 #include "particle_renderer.h"
 #include "math_util.h"
 #include "lang_features.h"
+#include "simd.h"
 
 #include "leak_dumper.h"
 
@@ -35,6 +36,242 @@ namespace Shared{ namespace Graphics{
 
 MEMORY_CHECK_IMPLEMENTATION(Particle)
 
+Particle::Particle() {
+	memset(this, 0, sizeof(Particle));
+}
+
+// =====================================================
+//	class ParticleStore
+// =====================================================
+
+namespace {
+
+/** dst[i] += src[i], for i in [0, count) */
+inline void addArrays(float *dst, const float *src, int count) {
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+	}
+	for ( ; i < count; ++i) {
+		dst[i] += src[i];
+	}
+}
+
+/** apply (op) v component-wise to n Vec3f stored as flat floats, three registers hold the
+  * pattern x,y,z,x | y,z,x,y | z,x,y,z so four vectors are done per iteration */
+#define _PATTERN3_KERNEL(name, sse_op, op)									\
+	inline void name(float *dst, const Vec3f &v, int n) {					\
+		const __m128 p0 = _mm_setr_ps(v.x, v.y, v.z, v.x);					\
+		const __m128 p1 = _mm_setr_ps(v.y, v.z, v.x, v.y);					\
+		const __m128 p2 = _mm_setr_ps(v.z, v.x, v.y, v.z);					\
+		int i = 0;															\
+		for ( ; i + 4 <= n; i += 4) {										\
+			float *f = dst + i * 3;											\
+			_mm_storeu_ps(f,     sse_op(_mm_loadu_ps(f),     p0));			\
+			_mm_storeu_ps(f + 4, sse_op(_mm_loadu_ps(f + 4), p1));			\
+			_mm_storeu_ps(f + 8, sse_op(_mm_loadu_ps(f + 8), p2));			\
+		}																	\
+		for ( ; i < n; ++i) {												\
+			float *f = dst + i * 3;											\
+			f[0] op v.x; f[1] op v.y; f[2] op v.z;							\
+		}																	\
+	}
+
+_PATTERN3_KERNEL(addPattern3, _mm_add_ps, +=)
+_PATTERN3_KERNEL(mulPattern3, _mm_mul_ps, *=)
+
+#undef _PATTERN3_KERNEL
+
+/** alignment (bytes) of each array in the block */
+const int storeAlign = 16;
+
+inline int alignUp(int bytes) {
+	return (bytes + storeAlign - 1) & ~(storeAlign - 1);
+}
+
+} // anon namespace
+
+ParticleStore::ParticleStore()
+		: pos(0), lastPos(0), speed(0), accel(0)
+		, colour(0), colourStep(0), colour2(0), colour2Step(0)
+		, size(0), sizeStep(0), angle(0), angleStep(0)
+		, energy(0), energyStart(0), texture(0)
+		, m_block(0), m_capacity(0) {
+	// the kernels rely on vectors being tightly packed
+	assert(sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Vec4f) == 4 * sizeof(float));
+}
+
+void ParticleStore::allocate(int capacity) {
+	assert(!m_block);
+	const int v3 = alignUp(capacity * sizeof(Vec3f));
+	const int v4 = alignUp(capacity * sizeof(Vec4f));
+	const int f1 = alignUp(capacity * sizeof(float));
+	const int i1 = alignUp(capacity * sizeof(int));
+
+	// one block for all the arrays, particle systems are created and destroyed frequently
+	m_block = new char[4 * v3 + 4 * v4 + 4 * f1 + 3 * i1 + storeAlign];
+	char *ptr = m_block + (storeAlign - (size_t(m_block) & (storeAlign - 1))) % storeAlign;
+
+	pos         = reinterpret_cast<Vec3f*>(ptr); ptr += v3;
+	lastPos     = reinterpret_cast<Vec3f*>(ptr); ptr += v3;
+	speed       = reinterpret_cast<Vec3f*>(ptr); ptr += v3;
+	accel       = reinterpret_cast<Vec3f*>(ptr); ptr += v3;
+	colour      = reinterpret_cast<Vec4f*>(ptr); ptr += v4;
+	colourStep  = reinterpret_cast<Vec4f*>(ptr); ptr += v4;
+	colour2     = reinterpret_cast<Vec4f*>(ptr); ptr += v4;
+	colour2Step = reinterpret_cast<Vec4f*>(ptr); ptr += v4;
+	size        = reinterpret_cast<float*>(ptr); ptr += f1;
+	sizeStep    = reinterpret_cast<float*>(ptr); ptr += f1;
+	angle       = reinterpret_cast<float*>(ptr); ptr += f1;
+	angleStep   = reinterpret_cast<float*>(ptr); ptr += f1;
+	energy      = reinterpret_cast<int*>(ptr);   ptr += i1;
+	energyStart = reinterpret_cast<int*>(ptr);   ptr += i1;
+	texture     = reinterpret_cast<int*>(ptr);
+	m_capacity = capacity;
+}
+
+void ParticleStore::deallocate() {
+	delete [] m_block;
+	m_block = 0;
+	m_capacity = 0;
+}
+
+void ParticleStore::set(int i, const Particle &p) {
+	assert(i >= 0 && i < m_capacity);
+	pos[i] = p.pos;
+	lastPos[i] = p.lastPos;
+	speed[i] = p.speed;
+	accel[i] = p.accel;
+	colour[i] = p.colour.value;
+	colourStep[i] = p.colour.step;
+	colour2[i] = p.colour2.value;
+	colour2Step[i] = p.colour2.step;
+	size[i] = p.size.value;
+	sizeStep[i] = p.size.step;
+	angle[i] = p.angle.value;
+	angleStep[i] = p.angle.step;
+	energy[i] = p.energy.current;
+	energyStart[i] = p.energy.start;
+	texture[i] = p.texture;
+}
+
+void ParticleStore::copy(int dst, int src) {
+	pos[dst] = pos[src];
+	lastPos[dst] = lastPos[src];
+	speed[dst] = speed[src];
+	accel[dst] = accel[src];
+	colour[dst] = colour[src];
+	colourStep[dst] = colourStep[src];
+	colour2[dst] = colour2[src];
+	colour2Step[dst] = colour2Step[src];
+	size[dst] = size[src];
+	sizeStep[dst] = sizeStep[src];
+	angle[dst] = angle[src];
+	angleStep[dst] = angleStep[src];
+	energy[dst] = energy[src];
+	energyStart[dst] = energyStart[src];
+	texture[dst] = texture[src];
+}
+
+void ParticleStore::move(int n) {
+	memcpy(lastPos, pos, n * sizeof(Vec3f));
+	addArrays(pos[0].ptr(), speed[0].ptr(), n * 3);
+}
+
+void ParticleStore::moveTrail(int n) {
+	addArrays(lastPos[0].ptr(), speed[0].ptr(), n * 3);
+	addArrays(pos[0].ptr(), speed[0].ptr(), n * 3);
+}
+
+void ParticleStore::accelerate(int n) {
+	addArrays(speed[0].ptr(), accel[0].ptr(), n * 3);
+}
+
+void ParticleStore::scaleSpeed(int n, const Vec3f &s) {
+	mulPattern3(speed[0].ptr(), s, n);
+}
+
+void ParticleStore::translate(int n, const Vec3f &d) {
+	addPattern3(pos[0].ptr(), d, n);
+	addPattern3(lastPos[0].ptr(), d, n);
+}
+
+void ParticleStore::stepColour(int n) {
+	addArrays(colour[0].ptr(), colourStep[0].ptr(), n * 4);
+}
+
+void ParticleStore::stepColour2(int n) {
+	addArrays(colour2[0].ptr(), colour2Step[0].ptr(), n * 4);
+}
+
+void ParticleStore::stepSize(int n) {
+	addArrays(size, sizeStep, n);
+}
+
+void ParticleStore::stepAngle(int n) {
+	// a - trunc(a / 2pi) * 2pi, as fmodf() but four at a time
+	const __m128 twoPi = _mm_set1_ps(Math::twopi);
+	const __m128 invTwoPi = _mm_set1_ps(1.f / Math::twopi);
+	int i = 0;
+	for ( ; i + 4 <= n; i += 4) {
+		__m128 a = _mm_add_ps(_mm_loadu_ps(angle + i), _mm_loadu_ps(angleStep + i));
+		__m128 turns = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(a, invTwoPi)));
+		_mm_storeu_ps(angle + i, _mm_sub_ps(a, _mm_mul_ps(turns, twoPi)));
+	}
+	for ( ; i < n; ++i) {
+		angle[i] = fmodf(angle[i] + angleStep[i], Math::twopi);
+	}
+}
+
+void ParticleStore::age(int n) {
+	const __m128i one = _mm_set1_epi32(1);
+	int i = 0;
+	for ( ; i + 4 <= n; i += 4) {
+		__m128i *e = reinterpret_cast<__m128i*>(energy + i);
+		_mm_storeu_si128(e, _mm_sub_epi32(_mm_loadu_si128(e), one));
+	}
+	for ( ; i < n; ++i) {
+		--energy[i];
+	}
+}
+
+int ParticleStore::killExpired(int n) {
+	const __m128i one = _mm_set1_epi32(1);
+	int i = 0;
+	while (i < n) {
+		if (i + 4 <= n) { // skip four at a time while none have expired
+			__m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(energy + i));
+			if (!_mm_movemask_epi8(_mm_cmplt_epi32(e, one))) {
+				i += 4;
+				continue;
+			}
+		}
+		if (energy[i] <= 0) {
+			// move the last live particle here, and test it in turn
+			if (i != --n) {
+				copy(i, n);
+			}
+		} else {
+			++i;
+		}
+	}
+	return n;
+}
+
+int ParticleStore::killGrounded(int n) {
+	int i = 0;
+	while (i < n) {
+		if (pos[i].y < 0.f) {
+			if (i != --n) {
+				copy(i, n);
+			}
+		} else {
+			++i;
+		}
+	}
+	return n;
+}
+
 // =====================================================
 //	class ParticleSystemBase
 // =====================================================
@@ -143,7 +380,6 @@ ParticleSystem::ParticleSystem(int particleCount)
 		: ParticleSystemBase()
 		//, id(++idCounter)
 		, particleCount(particleCount)
-		, particles(0)
 		, state(sPlay)
 		, active(true)
 		, visible(true)
@@ -157,7 +393,6 @@ ParticleSystem::ParticleSystem(const ParticleSystemBase &model, int particleCoun
 		: ParticleSystemBase(model)
 		//, id(++idCounter)
 		, particleCount(particleCount)
-		, particles(0)
 		, state(sPlay)
 		, active(true)
 		, visible(true)
@@ -168,59 +403,65 @@ ParticleSystem::ParticleSystem(const ParticleSystemBase &model, int particleCoun
 }
 
 void ParticleSystem::initArray(ParticleUse use) {
-	assert(!particles);
-	particles = new Particle[particleCount];
+	particles.allocate(particleCount);
 	addParticleUse(use, particleCount);
 	this->use = use;
 }
 
 void ParticleSystem::freeArray() {
-	delete [] particles;
+	particles.deallocate();
 	remParticleUse(use, particleCount);
-	particles = 0;
 	aliveParticleCount = 0;
 }
 
 ParticleSystem::~ParticleSystem() {
-	delete [] particles;
-	remParticleUse(use, particleCount);
+	if (particles.getCapacity()) {
+		remParticleUse(use, particleCount);
+	}
 }
 
 // =============== VIRTUAL ======================
 
-// updates all living particles and creates new ones
+// updates all living particles and removes dead ones
+void ParticleSystem::step() {
+	if (visible && state != sPause) {
+		// update every live particle, then compact, so none skip an update
+		updateParticles();
+		killParticles();
+	}
+}
+
+// creates new particles
 void ParticleSystem::update() {
 	if (visible && state != sPause) {
-		for (int i = 0; i < aliveParticleCount; ++i) {
-			updateParticle(&particles[i]);
-			if (deathTest(&particles[i])) {
-				// kill the particle
-				killParticle(&particles[i]);
-
-				// mantain alive particles at front of the array
-				if (aliveParticleCount > 0) {
-					///@todo FIXME: this particle skips an update :(
-					particles[i] = particles[aliveParticleCount];
-					// --i; ?
-				}
-			}
-		}
 		if (state != sFade) {
 			float fCount = emissionRateRemainder + emissionRate;
 			int count = int(fCount);
 			emissionRateRemainder = fCount - count;
 			for (int i = 0; i < count; ++i) {
-				Particle *p = createParticle();
-				if (p) {
-					initParticle(p, i);
-				} else {
+				int ndx = createParticle();
+				if (ndx == -1) {
 					break;
 				}
+				Particle p;
+				initParticle(&p, i);
+				particles.set(ndx, p);
 			}
 		}
 	}
 }
 
+void ParticleSystem::updateParticles() {
+	const int n = aliveParticleCount;
+	particles.move(n);
+	particles.accelerate(n);
+	particles.stepSize(n);
+	if (hasAngularVelocity()) {
+		particles.stepAngle(n);
+	}
+	particles.age(n);
+}
+
 void ParticleSystem::render(ParticleRenderer *pr, ModelRenderer *mr) {
 	if (active) {
 		pr->renderSystem(this);
@@ -245,27 +486,27 @@ void ParticleSystem::fade() {
 
 // =============== PROTECTED =========================
 
-// if there is one dead particle it returns it else, return the particle with
-// the least energy
-Particle *ParticleSystem::createParticle() {
+// if there is one dead particle it returns its index, else the index of the particle
+// with the least energy, or -1 if old particles are not to be overwritten
+int ParticleSystem::createParticle() {
 	//if any dead particles
 	if (aliveParticleCount < particleCount) {
 		++aliveParticleCount;
-		return &particles[aliveParticleCount-1];
+		return aliveParticleCount - 1;
 	}
 
 	if (overwriteOld) {
-		int minEnergy = particles[0].energy.current;
+		int minEnergy = particles.energy[0];
 		int minEnergyParticle = 0;
 		for (int i = 0; i < particleCount; ++i) {
-			if (particles[i].energy.current < minEnergy) {
-				minEnergy = particles[i].energy.current;
+			if (particles.energy[i] < minEnergy) {
+				minEnergy = particles.energy[i];
 				minEnergyParticle = i;
 			}
 		}
-		return &particles[minEnergyParticle];
+		return minEnergyParticle;
 	}
-	return 0;
+	return -1;
 }
 
 void ParticleSystem::initParticle(Particle *p, int particleIndex) {
@@ -292,17 +533,6 @@ void ParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->texture = getNumTextures() > 1 ? random.randRange(0, getNumTextures() - 1) : 0;
 }
 
-void ParticleSystem::updateParticle(Particle *p) {
-	p->lastPos = p->pos;
-	p->pos = p->pos + p->speed;
-	p->speed = p->speed + p->accel;
-	p->size.value += p->size.step;
-	if (hasAngularVelocity()) {
-		p->angle.value = fmodf(p->angle.value + p->angle.step, Math::twopi);
-	}
-	p->energy.current--;
-}
-
 // ===========================================================================
 //  RainParticleSystem
 // ===========================================================================
@@ -341,10 +571,6 @@ void RainParticleSystem::render(ParticleRenderer *pr, ModelRenderer *mr) {
 	pr->renderSystemLine(this);
 }
 
-bool RainParticleSystem::deathTest(Particle *p) {
-	return p->pos.y < 0;
-}
-
 // ===========================================================================
 //  SnowParticleSystem
 // ===========================================================================
@@ -372,10 +598,6 @@ void SnowParticleSystem::initParticle(Particle *p, int particleIndex) {
 	p->speed.y += random.randRange(-0.005f, 0.005f);
 }
 
-bool SnowParticleSystem::deathTest(Particle *p) {
-	return p->pos.y < 0;
-}
-
 // ===========================================================================
 //  ParticleManager
 // ===========================================================================
@@ -394,9 +616,75 @@ void ParticleManager::render(ParticleRenderer *pr, ModelRenderer *mr) const{
 	}
 }
 
+namespace {
+
+/** steps a contiguous range of particle systems */
+class StepTask : public Platform::Task {
+private:
+	ParticleSystem **begin, **end;
+
+public:
+	StepTask(ParticleSystem **begin, ParticleSystem **end) : begin(begin), end(end) {}
+
+	virtual void execute() {
+		for (ParticleSystem **ps = begin; ps != end; ++ps) {
+			(*ps)->step();
+		}
+	}
+};
+
+/** don't bother the worker threads for fewer live particles than this */
+const int minParallelParticles = 2048;
+
+/** tasks per thread, more than one so a thread landing some dense systems can be caught up */
+const int tasksPerThread = 4;
+
+} // anon namespace
+
+void ParticleManager::step() {
+	int particleCount = 0;
+	foreach_const (ParticleSystemList, it, particleSystems) {
+		particleCount += (*it)->getAliveParticleCount();
+	}
+	if (!workerPool || particleCount < minParallelParticles) {
+		foreach (ParticleSystemList, it, particleSystems) {
+			(*it)->step();
+		}
+		return;
+	}
+
+	// partition into contiguous ranges of roughly equal particle counts
+	vector<ParticleSystem*> systems(particleSystems.begin(), particleSystems.end());
+	const int taskCount = (workerPool->getThreadCount() + 1) * tasksPerThread;
+	const int particlesPerTask = (particleCount + taskCount - 1) / taskCount;
+	vector<StepTask> tasks;
+	tasks.reserve(systems.size());
+
+	ParticleSystem **begin = &systems[0], **end = begin + systems.size();
+	int count = 0;
+	for (ParticleSystem **ps = begin; ps != end; ++ps) {
+		count += (*ps)->getAliveParticleCount();
+		if (count >= particlesPerTask) {
+			tasks.push_back(StepTask(begin, ps + 1));
+			begin = ps + 1;
+			count = 0;
+		}
+	}
+	if (begin != end) {
+		tasks.push_back(StepTask(begin, end));
+	}
+	foreach (vector<StepTask>, it, tasks) {
+		workerPool->add(&*it);
+	}
+	workerPool->wait();
+}
+
 void ParticleManager::update(){
-	list<ParticleSystem*>::iterator it;
+	// step all systems (possibly in parallel), then update them (in order, on this thread, as
+	// updates may have side effects) and delete finished ones
+	step();
 
+	list<ParticleSystem*>::iterator it;
 	for (it = particleSystems.begin(); it != particleSystems.end(); ++it) {
 		(*it)->update();
 		if ((*it)->isFinished()) {
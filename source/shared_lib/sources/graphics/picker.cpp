@@ -0,0 +1,156 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "picker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "math_util.h"
+#include "util.h"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Graphics {
+
+using Shared::Util::clamp;
+
+// =====================================================
+//	class Picker
+// =====================================================
+
+Picker::Picker(const Vec3f &camPos, float hAng, float vAng, float fov, float aspect,
+		float nearPlane, float farPlane, int screenW, int screenH)
+		: m_camPos(camPos)
+		, m_sinH(sinf(degToRad(hAng))), m_cosH(cosf(degToRad(hAng)))
+		, m_sinV(sinf(degToRad(vAng))), m_cosV(cosf(degToRad(vAng)))
+		, m_nearPlane(nearPlane), m_farPlane(farPlane)
+		, m_screenW(screenW), m_screenH(screenH)
+		, m_minX(0.f), m_minY(0.f), m_maxX(0.f), m_maxY(0.f)
+		, m_point(false)
+		, m_rayDir(0.f) {
+	m_yScale = 1.f / tanf(degToRad(fov) / 2.f);
+	m_xScale = m_yScale / aspect;
+}
+
+/** world space to eye space (camera at origin, looking down -z) */
+Vec3f Picker::toEye(const Vec3f &world) const {
+	Vec3f d = world - m_camPos;
+	float x = m_cosH * d.x + m_sinH * d.z;
+	float z = m_cosH * d.z - m_sinH * d.x;
+	return Vec3f(x, m_cosV * d.y + m_sinV * z, m_cosV * z - m_sinV * d.y);
+}
+
+/** eye space direction to world space direction */
+Vec3f Picker::toWorldDir(const Vec3f &eye) const {
+	float y = m_cosV * eye.y - m_sinV * eye.z;
+	float z = m_sinV * eye.y + m_cosV * eye.z;
+	return Vec3f(m_cosH * eye.x - m_sinH * z, y, m_sinH * eye.x + m_cosH * z);
+}
+
+/** @param eyeDist distance in front of the camera @return window depth scaled to [0, 2^32 - 1] */
+uint32 Picker::toSelectDepth(float eyeDist) const {
+	double n = m_nearPlane, f = m_farPlane;
+	double ndc = (f + n) / (f - n) - 2.0 * f * n / ((f - n) * eyeDist);
+	double depth = clamp((ndc + 1.0) / 2.0, 0.0, 1.0);
+	return uint32(depth * 4294967295.0);
+}
+
+void Picker::setRect(const Vec2i &posDown, const Vec2i &posUp) {
+	int x = (posDown.x + posUp.x) / 2;
+	int y = ((m_screenH - posDown.y) + (m_screenH - posUp.y)) / 2;
+	int w = abs(posDown.x - posUp.x);
+	int h = abs(posDown.y - posUp.y);
+	if (w < 1) w = 1;
+	if (h < 1) h = 1;
+	m_minX = x - w / 2.f;
+	m_maxX = x + w / 2.f;
+	m_minY = y - h / 2.f;
+	m_maxY = y + h / 2.f;
+	m_point = (w == 1 && h == 1);
+	if (m_point) {
+		float ndcX = 2.f * x / m_screenW - 1.f;
+		float ndcY = 2.f * y / m_screenH - 1.f;
+		m_rayDir = toWorldDir(Vec3f(ndcX / m_xScale, ndcY / m_yScale, -1.f));
+	}
+}
+
+bool Picker::pick(const Vec3f &pos, float rotation, const Vec3f &boxMin, const Vec3f &boxMax,
+		uint32 &out_depth) const {
+	if (boxMin.x > boxMax.x) {
+		return false;
+	}
+	const float s = sinf(degToRad(rotation));
+	const float c = cosf(degToRad(rotation));
+
+	if (m_point) {
+		// slab test in box space, the ray's eye space z is -1 so t is the distance from the camera
+		Vec3f o = m_camPos - pos;
+		Vec3f rayOrigin(c * o.x - s * o.z, o.y, s * o.x + c * o.z);
+		Vec3f rayDir(c * m_rayDir.x - s * m_rayDir.z, m_rayDir.y, s * m_rayDir.x + c * m_rayDir.z);
+		float tNear = m_nearPlane, tFar = m_farPlane;
+		for (int i=0; i < 3; ++i) {
+			if (fabsf(rayDir.raw[i]) < 1e-6f) {
+				if (rayOrigin.raw[i] < boxMin.raw[i] || rayOrigin.raw[i] > boxMax.raw[i]) {
+					return false;
+				}
+			} else {
+				float t1 = (boxMin.raw[i] - rayOrigin.raw[i]) / rayDir.raw[i];
+				float t2 = (boxMax.raw[i] - rayOrigin.raw[i]) / rayDir.raw[i];
+				if (t1 > t2) {
+					std::swap(t1, t2);
+				}
+				tNear = std::max(tNear, t1);
+				tFar = std::min(tFar, t2);
+				if (tNear > tFar) {
+					return false;
+				}
+			}
+		}
+		out_depth = toSelectDepth(tNear);
+		return true;
+	}
+
+	// project the corners, test their bounding rectangle against the selection rectangle. Corners
+	// behind the near plane are ignored, boxes cut by the near plane are only roughly tested.
+	float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f;
+	float nearest = m_farPlane;
+	bool inFront = false;
+	for (int i=0; i < 8; ++i) {
+		Vec3f corner((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y,
+			(i & 4) ? boxMax.z : boxMin.z);
+		Vec3f world(pos.x + c * corner.x + s * corner.z, pos.y + corner.y,
+			pos.z - s * corner.x + c * corner.z);
+		Vec3f eye = toEye(world);
+		float dist = -eye.z;
+		if (dist < m_nearPlane) {
+			continue;
+		}
+		float wx = (m_xScale * eye.x / dist + 1.f) * 0.5f * m_screenW;
+		float wy = (m_yScale * eye.y / dist + 1.f) * 0.5f * m_screenH;
+		minX = std::min(minX, wx);
+		maxX = std::max(maxX, wx);
+		minY = std::min(minY, wy);
+		maxY = std::max(maxY, wy);
+		nearest = std::min(nearest, dist);
+		inFront = true;
+	}
+	if (!inFront || nearest >= m_farPlane
+	|| maxX < m_minX || minX > m_maxX || maxY < m_minY || minY > m_maxY) {
+		return false;
+	}
+	out_depth = toSelectDepth(nearest);
+	return true;
+}
+
+}}//end namespace
@@ -12,10 +12,15 @@
 #include "pch.h"
 #include "texture.h"
 
+#include "compressed_texture.h"
+#include "util.h"
+
 #include "leak_dumper.h"
 
 namespace Shared{ namespace Graphics{
 
+using Util::hashFile;
+
 // =====================================================
 //	class Texture
 // =====================================================
@@ -28,6 +33,7 @@ Texture::Texture(){
 	wrapMode = wmRepeat;
 	format = fAuto;
 	inited = false;
+	memoryUsage = 0;
 }
 
 // =====================================================
@@ -45,11 +51,44 @@ void Texture1D::load(const string &path){
 
 Texture2D* Texture2D::defaultTexture = 0;
 
+Texture2D::~Texture2D() {
+	delete pixmap;
+	delete m_compressed;
+}
+
 void Texture2D::load(const string &path){
 	this->path= path;
 	pixmap->load(path);
 }
 
+void Texture2D::loadCompressed(const string &path) {
+	if (!mipmap || format != fAuto || !CompressedTexture::isCacheEnabled()) {
+		load(path);
+		return;
+	}
+	this->path = path;
+	uint64 hash = hashFile(path);
+	CompressedTexture *compressed = new CompressedTexture();
+	if (compressed->loadCached(hash)) {
+		m_compressed = compressed;
+		return;
+	}
+	try {
+		pixmap->load(path);
+	} catch (runtime_error &) {
+		delete compressed;
+		throw;
+	}
+	if (CompressedTexture::canCompress(pixmap)) {
+		compressed->compress(pixmap);
+		compressed->saveCached(hash);
+		m_compressed = compressed;
+		pixmap->dispose();
+	} else {
+		delete compressed;
+	}
+}
+
 void Texture2D::setPixmap(Pixmap2D *pm) {
 	delete pixmap;
 	pixmap = pm;
@@ -13,6 +13,7 @@
 #include "texture_manager.h"
 
 #include <cstdlib>
+#include <set>
 
 #include "graphics_interface.h"
 #include "graphics_factory.h"
@@ -24,13 +25,17 @@ namespace Shared{ namespace Graphics{
 
 using Gl::_assertGl;
 using Util::cleanPath;
+using Util::hashFile;
 using Util::mediaErrorLog;
+using Platform::Task;
+using std::set;
 
 // =====================================================
 //	class TextureManager
 // =====================================================
 
 TextureManager::TextureManager(){
+	m_shareByContent= false;
 	textureFilter= Texture::fBilinear;
 	maxAnisotropy= 1;
 }
@@ -55,6 +60,8 @@ void TextureManager::end(){
 		}
 		textures[i].clear();
 	}
+	m_pathIndex.clear();
+	m_contentIndex.clear();
 }
 
 void TextureManager::setFilter(Texture::Filter textureFilter){
@@ -65,28 +72,121 @@ void TextureManager::setMaxAnisotropy(int maxAnisotropy){
 	this->maxAnisotropy= maxAnisotropy;
 }
 
+/** look up a texture by path, and if sharing by content and contentHash is given, by content.
+  * The path is indexed if found by content. @param contentHash [in] hash of the file or 0 */
+Texture2D *TextureManager::findTexture2D(const string &cleanedPath, uint64 *contentHash) {
+	PathIndex::iterator it = m_pathIndex.find(cleanedPath);
+	if (it != m_pathIndex.end()) {
+		return it->second;
+	}
+	if (m_shareByContent && contentHash && *contentHash) {
+		ContentIndex::iterator cit = m_contentIndex.find(*contentHash);
+		if (cit != m_contentIndex.end()) {
+			m_pathIndex[cleanedPath] = cit->second;
+			return cit->second;
+		}
+	}
+	return 0;
+}
+
+/** add an initialised texture to the indexes */
+void TextureManager::addTexture2D(Texture2D *tex, const string &cleanedPath, uint64 *contentHash) {
+	textures[TextureType::TWO_D].push_back(tex);
+	m_pathIndex[cleanedPath] = tex;
+	if (m_shareByContent && contentHash && *contentHash) {
+		m_contentIndex[*contentHash] = tex;
+	}
+}
+
 Texture2D *TextureManager::getTexture(const string &path) {
 	string cleanedPath = cleanPath(path);
-	for (int i=0; i < textures[TextureType::TWO_D].size(); ++i) {
-		if (textures[TextureType::TWO_D][i]->getPath() == cleanedPath) {
-			return static_cast<Texture2D*>(textures[TextureType::TWO_D][i]);
+	Texture2D *tex = findTexture2D(cleanedPath, 0);
+	if (!tex) {
+		uint64 hash = 0;
+		try {
+			if (m_shareByContent) {
+				hash = hashFile(cleanedPath);
+				tex = findTexture2D(cleanedPath, &hash);
+			}
+			if (!tex) {
+				tex = GraphicsInterface::getInstance().getFactory()->newTexture2D();
+				tex->loadCompressed(cleanedPath);
+				tex->init(textureFilter, maxAnisotropy);
+				assertGl();
+				tex->deletePixmap();
+				addTexture2D(tex, cleanedPath, &hash);
+			}
+		} catch (runtime_error &e) {
+			delete tex;
+			mediaErrorLog.add(e.what(), path);
+			return Texture2D::defaultTexture;
 		}
 	}
-	Texture2D *tex = GraphicsInterface::getInstance().getFactory()->newTexture2D();
-	try {
-		tex->load(cleanedPath);
-		tex->init(textureFilter, maxAnisotropy);
-		assertGl();
-		tex->deletePixmap();
-	} catch (runtime_error &e) {
-		delete tex;
-		mediaErrorLog.add(e.what(), path);
-		return Texture2D::defaultTexture;
-	}
-	textures[TextureType::TWO_D].push_back(tex);
 	return tex;
 }
 
+namespace {
+
+/** decodes a texture's pixmap, or compresses it, no GL calls */
+class TextureLoadTask : public Task {
+private:
+	Texture2D *m_texture;
+	string m_path;
+	bool m_hash;
+	uint64 m_contentHash;
+	bool m_loaded;
+
+public:
+	TextureLoadTask(Texture2D *texture, const string &path, bool hash)
+			: m_texture(texture), m_path(path), m_hash(hash), m_contentHash(0), m_loaded(false) {}
+
+	Texture2D *getTexture() const	{return m_texture;}
+	const string &getPath() const	{return m_path;}
+	uint64 *getContentHash()		{return &m_contentHash;}
+	bool isLoaded() const			{return m_loaded;}
+
+	virtual void execute() override {
+		try {
+			if (m_hash) {
+				m_contentHash = hashFile(m_path);
+			}
+			m_texture->loadCompressed(m_path);
+			m_loaded = true;
+		} catch (runtime_error &) {
+			// left for getTexture() to report
+		}
+	}
+};
+
+}
+
+void TextureManager::preload(const vector<string> &paths, WorkerPool &pool) {
+	vector<TextureLoadTask*> tasks;
+	set<string> queued;
+	foreach_const (vector<string>, it, paths) {
+		string cleanedPath = cleanPath(*it);
+		if (queued.insert(cleanedPath).second && !findTexture2D(cleanedPath, 0)) {
+			Texture2D *tex = GraphicsInterface::getInstance().getFactory()->newTexture2D();
+			tasks.push_back(new TextureLoadTask(tex, cleanedPath, m_shareByContent));
+			pool.add(tasks.back());
+		}
+	}
+	pool.wait();
+	foreach (vector<TextureLoadTask*>, it, tasks) {
+		Texture2D *tex = (*it)->getTexture();
+		if ((*it)->isLoaded() && !findTexture2D((*it)->getPath(), (*it)->getContentHash())) {
+			tex->init(textureFilter, maxAnisotropy);
+			assertGl();
+			tex->deletePixmap();
+			addTexture2D(tex, (*it)->getPath(), (*it)->getContentHash());
+		} else {
+			// failed, left for getTexture() to report, or a duplicate of one already loaded
+			delete tex;
+		}
+		delete *it;
+	}
+}
+
 Texture1D *TextureManager::newTexture1D(){
 	Texture1D *texture1D= GraphicsInterface::getInstance().getFactory()->newTexture1D();
 	textures[TextureType::ONE_D].push_back(texture1D);
@@ -118,6 +218,20 @@ TextureCube *TextureManager::newTextureCube(){
 bool TextureManager::deleteTexture2D(Texture2D *tex) {
 	foreach (TextureContainer, it, textures[TextureType::TWO_D]) {
 		if (*it == tex) {
+			for (PathIndex::iterator pit = m_pathIndex.begin(); pit != m_pathIndex.end(); ) {
+				if (pit->second == tex) {
+					m_pathIndex.erase(pit++);
+				} else {
+					++pit;
+				}
+			}
+			for (ContentIndex::iterator cit = m_contentIndex.begin(); cit != m_contentIndex.end(); ) {
+				if (cit->second == tex) {
+					m_contentIndex.erase(cit++);
+				} else {
+					++cit;
+				}
+			}
 			tex->end();
 			delete tex;
 			textures[TextureType::TWO_D].erase(it);
@@ -127,4 +241,14 @@ bool TextureManager::deleteTexture2D(Texture2D *tex) {
 	return false;
 }
 
+int64 TextureManager::getMemoryUsage() const {
+	int64 bytes = 0;
+	for (int i=0; i < TextureType::COUNT; ++i) {
+		foreach_const (TextureContainer, it, textures[i]) {
+			bytes += (*it)->getMemoryUsage();
+		}
+	}
+	return bytes;
+}
+
 }}//end namespace
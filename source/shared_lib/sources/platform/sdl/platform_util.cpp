@@ -330,6 +330,23 @@ size_t getFileSize(const string &path) {
 	return s.st_size;
 }
 
+int getProcessorCount() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? int(count) : 1;
+}
+
+int64 getPeakMemoryUsage() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+#	ifdef __APPLE__
+		return int64(usage.ru_maxrss);			// bytes
+#	else
+		return int64(usage.ru_maxrss) * 1024;	// kilobytes
+#	endif
+}
+
 void message(string message) {
 	std::cerr << "******************************************************\n";
 	std::cerr << "    " << message << "\n";
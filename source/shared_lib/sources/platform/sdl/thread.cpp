@@ -76,5 +76,27 @@ void Mutex::v() {
 	SDL_mutexV(mutex);
 }
 
+// =====================================
+//          Semaphore
+// =====================================
+
+Semaphore::Semaphore(int initialCount) {
+	semaphore = SDL_CreateSemaphore(initialCount);
+	if (semaphore == 0)
+		throw std::runtime_error("Couldn't initialize semaphore");
+}
+
+Semaphore::~Semaphore() {
+	SDL_DestroySemaphore(semaphore);
+}
+
+void Semaphore::wait() {
+	SDL_SemWait(semaphore);
+}
+
+void Semaphore::signal() {
+	SDL_SemPost(semaphore);
+}
+
 }
 }//end namespace
@@ -13,6 +13,7 @@
 #include "platform_util.h"
 
 #include <io.h>
+#include <psapi.h>
 #include <cassert>
 
 #include "util.h"
@@ -124,6 +125,20 @@ size_t getFileSize(const string &path) {
 	return ret;
 }
 
+int getProcessorCount() {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? int(info.dwNumberOfProcessors) : 1;
+}
+
+int64 getPeakMemoryUsage() {
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return 0;
+	}
+	return int64(counters.PeakWorkingSetSize);
+}
+
 string videoModeToString(const VideoMode in_mode) {
 	return toStr(in_mode.w) + "x" + toStr(in_mode.h) + " " + toStr(in_mode.bpp) + "bpp @ " 
 		+ toStr(in_mode.freq) + "Hz.";
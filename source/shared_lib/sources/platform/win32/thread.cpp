@@ -12,6 +12,8 @@
 #include "pch.h"
 #include "thread.h"
 
+#include <stdexcept>
+
 #include "leak_dumper.h"
 
 namespace Shared { namespace Platform {
@@ -68,4 +70,27 @@ void Mutex::v() {
 	LeaveCriticalSection(&mutex);
 }
 
+// =====================================================
+// class Semaphore
+// =====================================================
+
+Semaphore::Semaphore(int initialCount) {
+	semaphore = CreateSemaphore(NULL, initialCount, LONG_MAX, NULL);
+	if (!semaphore) {
+		throw std::runtime_error("Couldn't initialize semaphore");
+	}
+}
+
+Semaphore::~Semaphore() {
+	CloseHandle(semaphore);
+}
+
+void Semaphore::wait() {
+	WaitForSingleObject(semaphore, INFINITE);
+}
+
+void Semaphore::signal() {
+	ReleaseSemaphore(semaphore, 1, NULL);
+}
+
 }}//end namespace
@@ -0,0 +1,113 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "worker_pool.h"
+
+#include <cassert>
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Platform {
+
+// =====================================================
+//	class WorkerPool
+// =====================================================
+
+void WorkerPool::Worker::execute() {
+	while (true) {
+		pool->taskSignal.wait();
+		Task *task = pool->takeTask();
+		if (task) {
+			task->execute();
+			pool->taskDone();
+		} else {
+			MutexLock lock(pool->mutex);
+			if (pool->quit) {
+				return;
+			}
+			// else the task was taken by the thread in wait()
+		}
+	}
+}
+
+WorkerPool::WorkerPool(int threadCount)
+		: pending(0)
+		, waiting(false)
+		, quit(false) {
+	for (int i = 0; i < threadCount; ++i) {
+		workers.push_back(new Worker(this));
+		workers.back()->start();
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		MutexLock lock(mutex);
+		assert(!pending);
+		quit = true;
+	}
+	for (int i = 0; i < getThreadCount(); ++i) {
+		taskSignal.signal();
+	}
+	for (int i = 0; i < getThreadCount(); ++i) {
+		workers[i]->join();
+		delete workers[i];
+	}
+}
+
+Task* WorkerPool::takeTask() {
+	MutexLock lock(mutex);
+	if (tasks.empty()) {
+		return 0;
+	}
+	Task *task = tasks.front();
+	tasks.pop_front();
+	return task;
+}
+
+void WorkerPool::taskDone() {
+	MutexLock lock(mutex);
+	assert(pending > 0);
+	if (--pending == 0 && waiting) {
+		waiting = false;
+		doneSignal.signal();
+	}
+}
+
+void WorkerPool::add(Task *task) {
+	{
+		MutexLock lock(mutex);
+		tasks.push_back(task);
+		++pending;
+	}
+	if (!workers.empty()) {
+		taskSignal.signal();
+	}
+}
+
+void WorkerPool::wait() {
+	// help out, rather than sit idle
+	while (Task *task = takeTask()) {
+		task->execute();
+		taskDone();
+	}
+	{
+		MutexLock lock(mutex);
+		if (!pending) {
+			return;
+		}
+		waiting = true;
+	}
+	doneSignal.wait();
+}
+
+}}//end namespace
@@ -0,0 +1,134 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "binary_stream.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "util.h"
+#include "FSFactory.hpp"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Util {
+
+using namespace PhysFS;
+using std::runtime_error;
+
+// =====================================================
+//	class BinaryWriter
+// =====================================================
+
+void BinaryWriter::writeUnsigned(uint32 value) {
+	writeVarint(m_data, value);
+}
+
+void BinaryWriter::writeSigned(int32 value) {
+	writeVarint(m_data, zigzag(value));
+}
+
+void BinaryWriter::writeFloat(float32 value) {
+	writeBytes(&value, sizeof(float32));
+}
+
+void BinaryWriter::writeInt32(int32 value) {
+	writeBytes(&value, sizeof(int32));
+}
+
+void BinaryWriter::writeString(const string &value) {
+	writeUnsigned(value.size());
+	writeBytes(value.data(), value.size());
+}
+
+void BinaryWriter::writeBytes(const void *data, size_t size) {
+	const uint8 *bytes = static_cast<const uint8*>(data);
+	m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+void BinaryWriter::save(const string &path) const {
+	std::auto_ptr<FileOps> f(FSFactory::getInstance()->getFileOps());
+	f->openWrite(path.c_str());
+	if (!m_data.empty() && f->write(&m_data[0], m_data.size(), 1) != 1) {
+		throw runtime_error("Error writing " + path);
+	}
+}
+
+// =====================================================
+//	class BinaryReader
+// =====================================================
+
+void BinaryReader::load(const string &path) {
+	std::auto_ptr<FileOps> f(FSFactory::getInstance()->getFileOps());
+	f->openRead(path.c_str());
+	m_buffer.resize(f->fileSize());
+	if (!m_buffer.empty() && f->read(&m_buffer[0], m_buffer.size(), 1) != 1) {
+		throw runtime_error("Error reading " + path);
+	}
+	m_ptr = m_buffer.empty() ? 0 : &m_buffer[0];
+	m_end = m_ptr + m_buffer.size();
+}
+
+void BinaryReader::check(size_t size) const {
+	if (size_t(m_end - m_ptr) < size) {
+		throw runtime_error("Unexpected end of data");
+	}
+}
+
+uint32 BinaryReader::readUnsigned() {
+	uint32 value;
+	if (!readVarint(m_ptr, m_end, value)) {
+		throw runtime_error("Unexpected end of data");
+	}
+	return value;
+}
+
+int32 BinaryReader::readSigned() {
+	return unzigzag(readUnsigned());
+}
+
+bool BinaryReader::readBool() {
+	check(1);
+	return *m_ptr++ != 0;
+}
+
+float32 BinaryReader::readFloat() {
+	float32 value;
+	readBytes(&value, sizeof(float32));
+	return value;
+}
+
+int32 BinaryReader::readInt32() {
+	int32 value;
+	readBytes(&value, sizeof(int32));
+	return value;
+}
+
+string BinaryReader::readString() {
+	size_t size = readUnsigned();
+	const uint8 *bytes = skip(size);
+	return string(reinterpret_cast<const char*>(bytes), size);
+}
+
+void BinaryReader::readBytes(void *out_data, size_t size) {
+	memcpy(out_data, skip(size), size);
+}
+
+const uint8* BinaryReader::skip(size_t size) {
+	check(size);
+	const uint8 *result = m_ptr;
+	m_ptr += size;
+	return result;
+}
+
+}}//end namespace
@@ -0,0 +1,72 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "checksum.h"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Util {
+
+static const uint64 seed = 55665; // as the old byte wise checksum started with
+
+// =====================================================
+//	class Checksum
+// =====================================================
+
+void Checksum::reset() {
+	m_lanes[0] = seed + prime1 + prime2;
+	m_lanes[1] = seed + prime2;
+	m_lanes[2] = seed;
+	m_lanes[3] = seed - prime1;
+	m_bufferSize = 0;
+	m_totalSize = 0;
+}
+
+uint64 Checksum::getSum64() const {
+	uint64 h;
+	if (m_totalSize >= blockSize) {
+		h = rotl(m_lanes[0], 1) + rotl(m_lanes[1], 7) + rotl(m_lanes[2], 12) + rotl(m_lanes[3], 18);
+		for (int i=0; i < 4; ++i) {
+			h = (h ^ mixLane(0, m_lanes[i])) * prime1 + prime4;
+		}
+	} else {
+		h = seed + prime5;
+	}
+	h += m_totalSize;
+
+	// the tail, less than a block
+	const uint8 *p = m_buffer, *end = m_buffer + m_bufferSize;
+	for ( ; p + 8 <= end; p += 8) {
+		uint64 word;
+		memcpy(&word, p, 8);
+		h = combine(h, word);
+	}
+	if (p + 4 <= end) {
+		Shared::Platform::uint32 word;
+		memcpy(&word, p, 4);
+		h = rotl(h ^ (uint64(word) * prime1), 23) * prime2 + prime3;
+		p += 4;
+	}
+	for ( ; p < end; ++p) {
+		h = rotl(h ^ (*p * prime5), 11) * prime1;
+	}
+
+	// avalanche
+	h ^= h >> 33;
+	h *= prime2;
+	h ^= h >> 29;
+	h *= prime3;
+	h ^= h >> 32;
+	return h;
+}
+
+}}//end namespace
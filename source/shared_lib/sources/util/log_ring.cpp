@@ -0,0 +1,118 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "log_ring.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "atomic.h"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Util {
+
+using namespace Shared::Platform;
+
+// =====================================================
+//	class LogRing
+// =====================================================
+
+LogRing::LogRing(int capacity)
+		: m_pushPos(0)
+		, m_popPos(0)
+		, m_dropped(0) {
+	int size = maxMessageSlots;
+	while (size < capacity) {
+		size *= 2;
+	}
+	m_mask = size - 1;
+	m_slots = new Slot[size];
+	for (int i=0; i < size; ++i) {
+		m_slots[i].sequence = i;
+	}
+	memoryBarrier();
+}
+
+LogRing::~LogRing() {
+	delete [] m_slots;
+}
+
+bool LogRing::push(const char *text, int size, int64 time) {
+	int count = std::max(1, (size + payloadSize - 1) / payloadSize);
+	if (count > maxMessageSlots) {
+		count = maxMessageSlots;
+		size = count * payloadSize;
+	}
+
+	// claim slots pos to pos + count - 1, the consumer frees in order so if the last is free
+	// they all are
+	uint32 pos = atomicLoad(&m_pushPos);
+	while (true) {
+		uint32 last = pos + count - 1;
+		int32 diff = int32(atomicLoad(&m_slots[last & m_mask].sequence) - last);
+		if (diff == 0) {
+			if (atomicCompareAndSwap(&m_pushPos, pos, pos + count)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// not yet popped, full
+			atomicAdd(&m_dropped, 1);
+			return false;
+		}
+		// another producer got there first
+		pos = atomicLoad(&m_pushPos);
+	}
+
+	Slot &first = m_slots[pos & m_mask];
+	first.size = size;
+	first.time = time;
+	for (int i=0; i < count; ++i) {
+		int n = std::min(size - i * payloadSize, int(payloadSize));
+		memcpy(m_slots[(pos + i) & m_mask].text, text + i * payloadSize, n);
+	}
+	// publish the first slot last, so a message is ready to pop as soon as it is
+	for (int i = count - 1; i >= 0; --i) {
+		atomicStore(&m_slots[(pos + i) & m_mask].sequence, pos + i + 1);
+	}
+	return true;
+}
+
+bool LogRing::pop(string &out_text, int64 &out_time) {
+	Slot &first = m_slots[m_popPos & m_mask];
+	if (atomicLoad(&first.sequence) != m_popPos + 1) {
+		return false;
+	}
+	int size = first.size;
+	int count = std::max(1, (size + payloadSize - 1) / payloadSize);
+	out_time = first.time;
+	out_text.clear();
+	for (int i=0; i < count; ++i) {
+		int n = std::min(size - i * payloadSize, int(payloadSize));
+		out_text.append(m_slots[(m_popPos + i) & m_mask].text, n);
+	}
+	for (int i=0; i < count; ++i) {
+		atomicStore(&m_slots[(m_popPos + i) & m_mask].sequence, m_popPos + i + m_mask + 1);
+	}
+	m_popPos += count;
+	return true;
+}
+
+int LogRing::takeDropped() {
+	uint32 n = atomicLoad(&m_dropped);
+	if (n) {
+		atomicAdd(&m_dropped, uint32(-int32(n)));
+	}
+	return n;
+}
+
+}}//end namespace
@@ -0,0 +1,253 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "map_file.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "util.h"
+#include "zlib.h"
+#include "FSFactory.hpp"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Util {
+
+using namespace PhysFS;
+using Shared::Platform::int64;
+using std::runtime_error;
+
+namespace {
+
+const char gbmzMagic[4] = {'G', 'B', 'M', 'Z'};
+const int32 gbmzVersion = 1;
+
+enum MapSection { START_LOCATIONS, HEIGHTS, SURFACES, OBJECTS, SECTION_COUNT };
+
+struct SectionEntry {
+	int32 offset;	/**< from the start of the file */
+	int32 size;		/**< compressed */
+	int32 rawSize;
+};
+
+const int gbmzTableOffset = sizeof(gbmzMagic) + sizeof(int32) + sizeof(MapFileHeader);
+const int gbmzDataOffset = gbmzTableOffset + sizeof(int32) + SECTION_COUNT * sizeof(SectionEntry);
+
+bool isCompressed(const string &path) {
+	return ext(path) == "gbmz";
+}
+
+/** read a whole file with one read */
+void readFile(const string &path, vector<char> &out_data) {
+	FileOps *f = FSFactory::getInstance()->getFileOps();
+	try {
+		f->openRead(path.c_str());
+		out_data.resize(f->fileSize());
+		if (!out_data.empty() && f->read(&out_data[0], out_data.size(), 1) != 1) {
+			throw runtime_error("Error reading " + path);
+		}
+	} catch (runtime_error &) {
+		delete f;
+		throw;
+	}
+	delete f;
+}
+
+template<typename T> void append(vector<char> &data, const T &v) {
+	const char *bytes = reinterpret_cast<const char*>(&v);
+	data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+} // end anonymous namespace
+
+// =====================================================
+//	class MapFile
+// =====================================================
+
+MapFile::MapFile() {
+	memset(&header, 0, sizeof(header));
+}
+
+string MapFile::findFile(const string &pathNoExt) {
+	const char *extensions[] = { ".gbmz", ".mgm", ".gbm" };
+	for (int i=0; i < 3; ++i) {
+		if (fileExists(pathNoExt + extensions[i])) {
+			return pathNoExt + extensions[i];
+		}
+	}
+	return "";
+}
+
+void MapFile::checkHeader(const string &path) const {
+	if (header.width <= 0 || header.height <= 0 || header.maxPlayers < 0
+	|| int64(header.width) * header.height > (1 << 26)) {
+		throw runtime_error(path + ": bad map header");
+	}
+}
+
+int MapFile::getSectionSize(int section) const {
+	const int tileCount = header.width * header.height;
+	switch (section) {
+		case START_LOCATIONS:	return header.maxPlayers * 2 * sizeof(int32);
+		case HEIGHTS:			return tileCount * sizeof(float32);
+		default:				return tileCount * sizeof(int8);
+	}
+}
+
+/** decode the sections, the sizes have been checked */
+void MapFile::setSections(const char *const *sections) {
+	const int tileCount = header.width * header.height;
+	startLocations.resize(header.maxPlayers);
+	for (int i=0; i < header.maxPlayers; ++i) {
+		int32 pos[2];
+		memcpy(pos, sections[START_LOCATIONS] + i * sizeof(pos), sizeof(pos));
+		startLocations[i] = Vec2i(pos[0], pos[1]);
+	}
+	heights.resize(tileCount);
+	surfaces.resize(tileCount);
+	objects.resize(tileCount);
+	memcpy(&heights[0], sections[HEIGHTS], tileCount * sizeof(float32));
+	memcpy(&surfaces[0], sections[SURFACES], tileCount * sizeof(int8));
+	memcpy(&objects[0], sections[OBJECTS], tileCount * sizeof(int8));
+}
+
+void MapFile::getSections(vector<char> *out_sections) const {
+	for (int i=0; i < header.maxPlayers; ++i) {
+		int32 pos[2] = { startLocations[i].x, startLocations[i].y };
+		append(out_sections[START_LOCATIONS], pos);
+	}
+	const char *heightBytes = reinterpret_cast<const char*>(&heights[0]);
+	out_sections[HEIGHTS].assign(heightBytes, heightBytes + heights.size() * sizeof(float32));
+	out_sections[SURFACES].assign(surfaces.begin(), surfaces.end());
+	out_sections[OBJECTS].assign(objects.begin(), objects.end());
+}
+
+void MapFile::load(const string &path) {
+	vector<char> data;
+	readFile(path, data);
+
+	const char *sections[SECTION_COUNT];
+	vector<char> unpacked[SECTION_COUNT];
+	if (isCompressed(path)) {
+		int32 version, sectionCount;
+		if (data.size() < gbmzDataOffset || memcmp(&data[0], gbmzMagic, sizeof(gbmzMagic)) != 0) {
+			throw runtime_error(path + ": not a compressed map");
+		}
+		memcpy(&version, &data[sizeof(gbmzMagic)], sizeof(int32));
+		memcpy(&header, &data[sizeof(gbmzMagic) + sizeof(int32)], sizeof(MapFileHeader));
+		memcpy(&sectionCount, &data[gbmzTableOffset], sizeof(int32));
+		if (version != gbmzVersion || sectionCount != SECTION_COUNT) {
+			throw runtime_error(path + ": unsupported compressed map version");
+		}
+		checkHeader(path);
+		for (int i=0; i < SECTION_COUNT; ++i) {
+			SectionEntry entry;
+			memcpy(&entry, &data[gbmzTableOffset + sizeof(int32) + i * sizeof(SectionEntry)], sizeof(entry));
+			if (entry.rawSize != getSectionSize(i) || entry.offset < gbmzDataOffset || entry.size < 0
+			|| int64(entry.offset) + entry.size > int64(data.size())) {
+				throw runtime_error(path + ": corrupt map");
+			}
+			unpacked[i].resize(entry.rawSize + 1);	// never empty, so &[0] is valid
+			uLongf rawSize = entry.rawSize;
+			if (entry.rawSize && (uncompress(reinterpret_cast<Bytef*>(&unpacked[i][0]), &rawSize,
+					reinterpret_cast<const Bytef*>(&data[entry.offset]), entry.size) != Z_OK
+			|| rawSize != uLongf(entry.rawSize))) {
+				throw runtime_error(path + ": corrupt map");
+			}
+			sections[i] = &unpacked[i][0];
+		}
+	} else {
+		if (data.size() < sizeof(MapFileHeader)) {
+			throw runtime_error(path + ": truncated map");
+		}
+		memcpy(&header, &data[0], sizeof(MapFileHeader));
+		checkHeader(path);
+		size_t pos = sizeof(MapFileHeader);
+		for (int i=0; i < SECTION_COUNT; ++i) {
+			if (data.size() - pos < size_t(getSectionSize(i))) {
+				throw runtime_error(path + ": truncated map");
+			}
+			sections[i] = data.empty() ? 0 : &data[0] + pos;
+			pos += getSectionSize(i);
+		}
+	}
+	setSections(sections);
+}
+
+void MapFile::loadHeader(const string &path) {
+	FileOps *f = FSFactory::getInstance()->getFileOps();
+	try {
+		f->openRead(path.c_str());
+		char magic[sizeof(gbmzMagic)];
+		int32 version;
+		if (isCompressed(path) && (f->read(magic, sizeof(magic), 1) != 1
+		|| memcmp(magic, gbmzMagic, sizeof(magic)) != 0 || f->read(&version, sizeof(int32), 1) != 1
+		|| version != gbmzVersion)) {
+			throw runtime_error(path + ": not a compressed map");
+		}
+		if (f->read(&header, sizeof(MapFileHeader), 1) != 1) {
+			throw runtime_error(path + ": truncated map");
+		}
+	} catch (runtime_error &) {
+		delete f;
+		throw;
+	}
+	delete f;
+}
+
+void MapFile::save(const string &path) const {
+	vector<char> sections[SECTION_COUNT];
+	getSections(sections);
+
+	vector<char> data;
+	if (isCompressed(path)) {
+		data.insert(data.end(), gbmzMagic, gbmzMagic + sizeof(gbmzMagic));
+		append(data, gbmzVersion);
+		append(data, header);
+		append(data, int32(SECTION_COUNT));
+		data.resize(gbmzDataOffset);	// the table is filled in as the sections are added
+		for (int i=0; i < SECTION_COUNT; ++i) {
+			uLongf size = compressBound(sections[i].size());
+			SectionEntry entry;
+			entry.offset = data.size();
+			entry.rawSize = sections[i].size();
+			data.resize(data.size() + size + 1);
+			if (!sections[i].empty() && compress2(reinterpret_cast<Bytef*>(&data[entry.offset]), &size,
+					reinterpret_cast<const Bytef*>(&sections[i][0]), sections[i].size(), Z_BEST_COMPRESSION) != Z_OK) {
+				throw runtime_error("Error compressing map: " + path);
+			}
+			entry.size = sections[i].empty() ? 0 : size;
+			data.resize(entry.offset + entry.size);
+			memcpy(&data[gbmzTableOffset + sizeof(int32) + i * sizeof(SectionEntry)], &entry, sizeof(entry));
+		}
+	} else {
+		append(data, header);
+		for (int i=0; i < SECTION_COUNT; ++i) {
+			data.insert(data.end(), sections[i].begin(), sections[i].end());
+		}
+	}
+
+	FileOps *f = FSFactory::getInstance()->getFileOps();
+	try {
+		f->openWrite(path.c_str());
+		if (f->write(&data[0], data.size(), 1) != 1) {
+			throw runtime_error("Error writing map: " + path);
+		}
+	} catch (runtime_error &) {
+		delete f;
+		throw;
+	}
+	delete f;
+}
+
+}}//end namespace
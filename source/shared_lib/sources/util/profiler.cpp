@@ -13,198 +13,352 @@
 #include "pch.h"
 #include "profiler.h"
 
-
 #include "platform_util.h"
 #include "timer.h"
+#include "thread.h"
 #include "FSFactory.hpp"
 
-#include <map>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#	include <intrin.h>
+#	define PROFILE_USE_RDTSC
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#	define PROFILE_USE_RDTSC
+#endif
+
+#if defined(_MSC_VER)
+#	define PROFILE_THREAD_LOCAL __declspec(thread)
+#else
+#	define PROFILE_THREAD_LOCAL __thread
+#endif
 
 namespace Shared { namespace Util { 
 
-#ifdef SL_PROFILE
+#ifndef SL_NO_PROFILE
 
 using Platform::Chrono;
+using Platform::Mutex;
+using Platform::MutexLock;
+using std::vector;
 using namespace PhysFS;
 
 namespace Profile {
 
+#ifdef SL_PROFILE
+	volatile bool enabled = true;
+#else
+	volatile bool enabled = false;
+#endif
+
+/** Timestamps are the time stamp counter where there is one, assumed invariant (every x86 of the
+  * last several years), else microseconds. Converted to microseconds only for reports. */
+inline int64 getTicks() {
+#if defined(PROFILE_USE_RDTSC) && defined(_MSC_VER)
+	return __rdtsc();
+#elif defined(PROFILE_USE_RDTSC)
+	unsigned int lo, hi;
+	__asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+	return (int64(hi) << 32) | lo;
+#else
+	return Chrono::getCurMicros();
+#endif
+}
+
 // =====================================================
-//	class Section
+//	class ThreadRecord
 // =====================================================
 
-class Section {
+/** Everything one thread records, only ever touched by that thread until the report. Sections
+  * are accumulated into a call tree, and the last traceCapacity of them kept for the timeline. */
+class ThreadRecord {
 public:
-	typedef std::map<string, Section*> SectionContainer;
+	static const int traceCapacity = 1 << 15;
+	/** call tree nodes (distinct call paths) and nesting depth reserved up front, so sections
+	  * only allocate if a thread goes beyond these */
+	static const int nodeReserve = 1024;
+	static const int stackReserve = 64;
+
+	struct Node {
+		int section;
+		int parent, firstChild, nextSibling;
+		int64 ticks;
+		unsigned int calls;
+	};
+
+	struct OpenSection {
+		int node;
+		int64 begin;
+	};
+
+	struct TraceEvent {
+		int64 begin, end;
+		int section;
+	};
+
 private:
-	string name;
-	Chrono chrono;
-	int64 microsElapsed;
-	int64 lastStart;
-	unsigned int calls;
-	Section *parent;
-	SectionContainer children;
+	int m_index;
+	vector<Node> m_nodes; // m_nodes[0] is the root
+	vector<OpenSection> m_stack;
+	vector<TraceEvent> m_trace;
+	int64 m_traceCount;
 
 public:
-	Section(const string &name);
-	~Section();
-
-	Section *getParent()				{return parent;}
-	const string &getName() const		{return name;}
-
-	void setParent(Section *parent)	{this->parent= parent;}
+	ThreadRecord(int index);
 
-	void start()	{ lastStart = Chrono::getCurMicros();}
-	void stop()		{ microsElapsed += Chrono::getCurMicros() - lastStart; } 
+	int getIndex() const				{return m_index;}
+	const Node &getNode(int i) const	{return m_nodes[i];}
+	int64 getTraceCount() const			{return m_traceCount;}
+	const TraceEvent &getTraceEvent(int64 i) const	{return m_trace[int(i % traceCapacity)];}
 
-	void incCalls () { calls++; }
+	void begin(int section);
+	void end(int section);
 
-	void addChild(Section *child)	{children[child->name] = child;}
-	Section *getChild(const string &name);
-
-	void print(ostream *outSream, int tabLevel=0);
+private:
+	int getChild(int node, int section);
 };
 
-// =====================================================
-//	class Section
-// =====================================================
-
-Section::Section(const string &name){
-	this->name= name;
-	microsElapsed= 0;
-	calls = 0;
-	parent= NULL;
+ThreadRecord::ThreadRecord(int index)
+		: m_index(index), m_traceCount(0) {
+	Node root = { -1, -1, -1, -1, 0, 0 };
+	m_nodes.reserve(nodeReserve);
+	m_nodes.push_back(root);
+	m_stack.reserve(stackReserve);
+	m_trace.resize(traceCapacity);
 }
 
-Section::~Section(){
-	for(SectionContainer::iterator it=children.begin(); it!=children.end(); ++it){
-		delete it->second;
+int ThreadRecord::getChild(int node, int section) {
+	int child = m_nodes[node].firstChild;
+	for ( ; child != -1; child = m_nodes[child].nextSibling) {
+		if (m_nodes[child].section == section) {
+			return child;
+		}
 	}
+	Node n = { section, node, -1, m_nodes[node].firstChild, 0, 0 };
+	m_nodes.push_back(n);
+	child = m_nodes.size() - 1;
+	m_nodes[node].firstChild = child;
+	return child;
 }
 
-Section *Section::getChild(const string &name){
-	SectionContainer::iterator it = children.find(name);
-	if (it == children.end()) {
-		return NULL;
-	}
-	return it->second;
+void ThreadRecord::begin(int section) {
+	OpenSection open;
+	open.node = getChild(m_stack.empty() ? 0 : m_stack.back().node, section);
+	m_stack.push_back(open);
+	m_stack.back().begin = getTicks(); // last, so the bookkeeping isn't counted
 }
 
-void Section::print(ostream *outStream, int tabLevel){
-	float percent = ( parent == NULL || parent->microsElapsed == 0 )
-					? 100.0f : 100.0f * microsElapsed / parent->microsElapsed;
-	string pname= parent==NULL? "": parent->getName();
-
-	for(int i=0; i<tabLevel; ++i)
-		*outStream << "\t";
-
-	*outStream << name << ": ";
-
-	if ( microsElapsed ) {
-		*outStream << int(microsElapsed) << " us";
-		unsigned int milliseconds = microsElapsed / 1000;
-		unsigned int seconds = milliseconds / 1000;
-		unsigned int minutes = seconds / 60;
-		if ( minutes ) {
-			*outStream << " (" << minutes << "min " << seconds % 60 << "sec)";
-		}
-		else if ( seconds ) {
-			*outStream << " (" << seconds << "sec " << milliseconds % 1000 << "ms)";
-		}
-		else if ( milliseconds ) {
-			*outStream << " (" << milliseconds << "ms)";
-		}
-		outStream->precision(1);
-		*outStream << std::fixed << ", " << percent << "%";
-	}
-	if ( calls ) {
-		*outStream << ", " << calls << " calls";
-	}
-	*outStream << "\n";
-
-	SectionContainer::iterator it;
-	for(it= children.begin(); it!=children.end(); ++it){
-		it->second->print(outStream, tabLevel+1);
-	}
+void ThreadRecord::end(int section) {
+	int64 now = getTicks();
+	assert(!m_stack.empty() && m_nodes[m_stack.back().node].section == section);
+	const OpenSection &open = m_stack.back();
+	Node &node = m_nodes[open.node];
+	node.ticks += now - open.begin;
+	++node.calls;
+
+	TraceEvent &event = m_trace[int(m_traceCount % traceCapacity)];
+	event.begin = open.begin;
+	event.end = now;
+	event.section = section;
+	++m_traceCount;
+	m_stack.pop_back();
 }
 
-
 // =====================================================
 //	class Profiler
 // =====================================================
 
 class Profiler {
-	Section *rootSection;
-	Section *currSection;
+private:
+	Mutex m_mutex;
+	vector<const char*> m_sections;
+	vector<ThreadRecord*> m_threads;
+	int64 m_startTicks, m_startMicros;
+	int64 m_enabledTicks, m_enabledSince;
+	double m_ticksPerMicro;
 
 public:
 	Profiler();
 	~Profiler();
 
+	int registerSection(const char *name);
+	ThreadRecord *addThread();
+	void setEnabled(bool enable);
 	void close();
-	void sectionBegin(const string &name);
-	void sectionEnd(const string &name);
+
+private:
+	double toMicros(int64 ticks) const	{return ticks / m_ticksPerMicro;}
+	void printNode(ostream &out, const ThreadRecord *thread, int node, int tabLevel) const;
+	void writeTree(ostream &out) const;
+	void writeTrace(ostream &out) const;
 };
 
-Profiler::Profiler(){
-	rootSection= new Section("Root");
-	currSection= rootSection;
-	rootSection->start();
+Profiler::Profiler()
+		: m_enabledTicks(0), m_ticksPerMicro(1.0) {
+	m_startTicks = m_enabledSince = getTicks();
+	m_startMicros = Chrono::getCurMicros();
 }
 
-Profiler::~Profiler(){
-	delete rootSection;
+Profiler::~Profiler() {
+	for (int i=0; i < m_threads.size(); ++i) {
+		delete m_threads[i];
+	}
 }
 
-void Profiler::close(){
-	rootSection->stop();
+int Profiler::registerSection(const char *name) {
+	MutexLock lock(m_mutex);
+	m_sections.push_back(name);
+	return m_sections.size() - 1;
+}
 
-	ostream *ofs = FSFactory::getInstance()->getOStream("profiler.log");
-	*ofs << "Profiler Results\n\n";
-	rootSection->print(ofs);
-	delete ofs;
+ThreadRecord *Profiler::addThread() {
+	MutexLock lock(m_mutex);
+	m_threads.push_back(new ThreadRecord(m_threads.size()));
+	return m_threads.back();
 }
 
-void Profiler::sectionBegin(const string &name ){
-	Section *childSection= currSection->getChild(name);
-	if(childSection==NULL){
-		childSection= new Section(name);
-		currSection->addChild(childSection);
-		childSection->setParent(currSection);
+void Profiler::setEnabled(bool enable) {
+	MutexLock lock(m_mutex);
+	if (enable == enabled) {
+		return;
 	}
-	currSection= childSection;
-	childSection->start();
+	if (enable) {
+		m_enabledSince = getTicks();
+	} else {
+		m_enabledTicks += getTicks() - m_enabledSince;
+	}
+	enabled = enable;
 }
 
-void Profiler::sectionEnd(const string &name){
-	if(name==currSection->getName()){
-		currSection->stop();
-		currSection= currSection->getParent();
+void Profiler::printNode(ostream &out, const ThreadRecord *thread, int node, int tabLevel) const {
+	const ThreadRecord::Node &n = thread->getNode(node);
+	int64 ticks = node ? n.ticks : m_enabledTicks;
+	int64 parentTicks = node ? (n.parent ? thread->getNode(n.parent).ticks : m_enabledTicks) : 0;
+	float percent = parentTicks == 0 ? 100.0f : 100.0f * ticks / parentTicks;
+	int64 microsElapsed = int64(toMicros(ticks));
+
+	for (int i=0; i < tabLevel; ++i) {
+		out << "\t";
 	}
-	else{
-		throw std::runtime_error("Profile: Leaving section is not current section: "+name);
+	out << (node ? m_sections[n.section] : "Root") << ": ";
+
+	if (microsElapsed) {
+		out << microsElapsed << " us";
+		unsigned int milliseconds = unsigned(microsElapsed / 1000);
+		unsigned int seconds = milliseconds / 1000;
+		unsigned int minutes = seconds / 60;
+		if (minutes) {
+			out << " (" << minutes << "min " << seconds % 60 << "sec)";
+		} else if (seconds) {
+			out << " (" << seconds << "sec " << milliseconds % 1000 << "ms)";
+		} else if (milliseconds) {
+			out << " (" << milliseconds << "ms)";
+		}
+		out.precision(1);
+		out << std::fixed << ", " << percent << "%";
+	}
+	if (n.calls) {
+		out << ", " << n.calls << " calls";
+	}
+	out << "\n";
+
+	for (int child = n.firstChild; child != -1; child = thread->getNode(child).nextSibling) {
+		printNode(out, thread, child, tabLevel + 1);
 	}
 }
 
+void Profiler::writeTree(ostream &out) const {
+	out << "Profiler Results\n";
+	for (int i=0; i < m_threads.size(); ++i) {
+		out << "\nThread " << m_threads[i]->getIndex() << "\n\n";
+		printNode(out, m_threads[i], 0, 0);
+	}
+}
+
+void Profiler::writeTrace(ostream &out) const {
+	out << "{\"traceEvents\":[\n";
+	out.precision(3);
+	out << std::fixed;
+	bool first = true;
+	for (int i=0; i < m_threads.size(); ++i) {
+		const ThreadRecord *thread = m_threads[i];
+		out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< thread->getIndex() << ",\"args\":{\"name\":\"Thread " << thread->getIndex() << "\"}}";
+		first = false;
+
+		int64 count = thread->getTraceCount();
+		int64 j = std::max(int64(0), count - ThreadRecord::traceCapacity);
+		for ( ; j < count; ++j) {
+			const ThreadRecord::TraceEvent &event = thread->getTraceEvent(j);
+			out << ",\n{\"name\":\"";
+			for (const char *c = m_sections[event.section]; *c; ++c) {
+				if (*c == '"' || *c == '\\') {
+					out << '\\';
+				}
+				out << *c;
+			}
+			out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->getIndex()
+				<< ",\"ts\":" << toMicros(event.begin - m_startTicks)
+				<< ",\"dur\":" << toMicros(event.end - event.begin) << "}";
+		}
+	}
+	out << "\n]}\n";
+}
+
+void Profiler::close() {
+	setEnabled(false);
+	MutexLock lock(m_mutex);
+	if (m_threads.empty()) {
+		return;
+	}
+	int64 micros = Chrono::getCurMicros() - m_startMicros;
+	if (micros > 0) {
+		m_ticksPerMicro = double(getTicks() - m_startTicks) / micros;
+	}
+
+	ostream *ofs = FSFactory::getInstance()->getOStream("profiler.log");
+	writeTree(*ofs);
+	delete ofs;
+
+	ofs = FSFactory::getInstance()->getOStream("profiler.json");
+	writeTrace(*ofs);
+	delete ofs;
+}
+
 Profiler& getProfiler() {
 	static Profiler profiler;
 	return profiler;
 }
 
-void profileEnd(){
+static PROFILE_THREAD_LOCAL ThreadRecord *threadRecord = 0;
+
+void setEnabled(bool enable) {
+	getProfiler().setEnabled(enable);
+}
+
+void profileEnd() {
 	getProfiler().close();
 }
 
-void sectionBegin(const string &name) {
-	getProfiler().sectionBegin(name);
+int registerSection(const char *name) {
+	return getProfiler().registerSection(name);
 }
 
-void sectionEnd(const string &name) {
-	getProfiler().sectionEnd(name);
+void sectionBegin(int id) {
+	if (!threadRecord) {
+		threadRecord = getProfiler().addThread();
+	}
+	threadRecord->begin(id);
+}
+
+void sectionEnd(int id) {
+	threadRecord->end(id);
 }
 
 } // namespace Profile
 
-#endif
+#endif // SL_NO_PROFILE
 
 }} //end namespace Shared::Util
@@ -13,6 +13,7 @@
 #include "pch.h"
 #include "types.h"
 #include "util.h"
+#include "checksum.h"
 
 #include <ctime>
 #include <cassert>
@@ -20,6 +21,7 @@
 #include <stdexcept>
 #include <cstring>
 #include <cstdio>
+#include <memory>
 
 #include "leak_dumper.h"
 #include "platform_util.h"
@@ -446,6 +448,45 @@ bool fileExists(const string &path) {
 	}
 }
 
+uint64 hashBytes(const void *data, size_t size) {
+	Checksum checksum;
+	checksum.addBytes(data, size);
+	return checksum.getSum64();
+}
+
+uint64 hashFile(const string &path) {
+	std::auto_ptr<FileOps> f(FSFactory::getInstance()->getFileOps());
+	f->openRead(path.c_str());
+	vector<char> data(f->fileSize());
+	if (!data.empty() && f->read(&data[0], data.size(), 1) != 1) {
+		throw runtime_error("Error reading " + path);
+	}
+	return data.empty() ? hashBytes(0, 0) : hashBytes(&data[0], data.size());
+}
+
+void writeVarint(vector<uint8> &out, uint32 value) {
+	while (value >= 0x80) {
+		out.push_back(uint8(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(uint8(value));
+}
+
+bool readVarint(const uint8 *&ptr, const uint8 *end, uint32 &out_value) {
+	out_value = 0;
+	for (int shift=0; shift < 35; shift += 7) {
+		if (ptr == end) {
+			return false;
+		}
+		uint8 byte = *ptr++;
+		out_value |= uint32(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 const string sharedLibVersionString= "v0.5";
 
 }}//end namespace
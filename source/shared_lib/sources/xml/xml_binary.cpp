@@ -0,0 +1,145 @@
+// ==============================================================
+//	This file is part of Glest Shared Library (www.glest.org)
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include "xml_binary.h"
+
+#include <stdexcept>
+
+#include "xml_parser.h"
+#include "conversion.h"
+
+#include "leak_dumper.h"
+
+namespace Shared { namespace Xml {
+
+using std::runtime_error;
+
+namespace {
+
+using Shared::Platform::uint32;
+
+/** how a value is stored */
+enum ValueKind { TABLE_STRING, INTEGER, STRING, VALUE_KIND_COUNT };
+
+/** @return true if s is exactly what Conversion::toStr() writes for some int32 */
+bool isPlainInteger(const string &s) {
+	size_t start = (!s.empty() && s[0] == '-') ? 1 : 0;
+	size_t digits = s.size() - start;
+	if (digits == 0 || digits > 10 || (s[start] == '0' && (digits > 1 || start))) {
+		return false;
+	}
+	for (size_t i = start; i < s.size(); ++i) {
+		if (s[i] < '0' || s[i] > '9') {
+			return false;
+		}
+	}
+	// anything out of range doesn't survive the round trip
+	return digits < 10 || Conversion::toStr(Conversion::strToInt(s)) == s;
+}
+
+} // end anonymous namespace
+
+// =====================================================
+//	class XmlBinaryWriter
+// =====================================================
+
+void XmlBinaryWriter::writeNode(const XmlNode *node) {
+	// text is rare, a flag with the attribute count says if there is any
+	bool hasText = !node->getText().empty();
+	writeTableString(node->getName());
+	m_out.writeUnsigned(node->getAttributeCount() << 1 | (hasText ? 1 : 0));
+	if (hasText) {
+		writeValue(node->getText());
+	}
+	for (int i=0; i < node->getAttributeCount(); ++i) {
+		const XmlAttribute *attribute = node->getAttribute(i);
+		writeTableString(attribute->getName());
+		writeValue(attribute->getValue());
+	}
+	m_out.writeUnsigned(node->getChildCount());
+	for (int i=0; i < node->getChildCount(); ++i) {
+		writeNode(node->getChild(i));
+	}
+}
+
+void XmlBinaryWriter::writeTableString(const string &s) {
+	StringTable::iterator it = m_strings.find(s);
+	if (it != m_strings.end()) {
+		m_out.writeUnsigned(it->second);
+	} else {
+		// the next index, which the reader knows is followed by the string
+		int index = m_strings.size();
+		m_strings[s] = index;
+		m_out.writeUnsigned(index);
+		m_out.writeString(s);
+	}
+}
+
+void XmlBinaryWriter::writeValue(const string &s) {
+	if (isPlainInteger(s)) {
+		m_out.writeUnsigned(INTEGER);
+		m_out.writeSigned(Conversion::strToInt(s));
+	} else if (s.size() <= maxTableString) {
+		m_out.writeUnsigned(TABLE_STRING);
+		writeTableString(s);
+	} else {
+		m_out.writeUnsigned(STRING);
+		m_out.writeString(s);
+	}
+}
+
+// =====================================================
+//	class XmlBinaryReader
+// =====================================================
+
+XmlNode *XmlBinaryReader::readNode(XmlNode *parent) {
+	XmlNode *node = parent->addChild(readTableString());
+	uint32 header = m_in.readUnsigned();
+	if (header & 1) {
+		node->setText(readValue());
+	}
+	int count = header >> 1;
+	for (int i=0; i < count; ++i) {
+		string name = readTableString();	// a copy, reading the value can grow the table
+		node->addAttribute(name, readValue());
+	}
+	count = m_in.readUnsigned();
+	for (int i=0; i < count; ++i) {
+		readNode(node);
+	}
+	return node;
+}
+
+const string &XmlBinaryReader::readTableString() {
+	size_t index = m_in.readUnsigned();
+	if (index == m_strings.size()) {
+		m_strings.push_back(m_in.readString());
+	} else if (index > m_strings.size()) {
+		throw runtime_error("Bad string index in binary xml");
+	}
+	return m_strings[index];
+}
+
+string XmlBinaryReader::readValue() {
+	switch (m_in.readUnsigned()) {
+		case TABLE_STRING:
+			return readTableString();
+		case INTEGER:
+			return Conversion::toStr(m_in.readSigned());
+		case STRING:
+			return m_in.readString();
+		default:
+			throw runtime_error("Bad value in binary xml");
+	}
+}
+
+}}//end namespace
@@ -17,8 +17,12 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <cstring>
 
 #include "conversion.h"
+#include "util.h"
+#include "xml_binary.h"
+#include "zlib.h"
 
 #include "leak_dumper.h"
 #include "FSFactory.hpp"
@@ -29,6 +33,8 @@ using std::range_error;
 namespace Shared { namespace Xml {
 using namespace Util;
 using namespace PhysFS;
+using Shared::Platform::uint8;
+using Shared::Platform::uint32;
 
 const string defaultIndent = string("  ");
 
@@ -37,14 +43,247 @@ const string defaultIndent = string("  ");
 // =====================================================
 
 bool XmlIo::initialized= false;
+string XmlIo::cacheDir;
+
+namespace {
+
+// cache files are a header followed by the root node, nodes are written as name, text, attributes
+// then children. Integers are little endian, strings are a length followed by the characters.
+const char cacheMagic[4] = {'G', 'X', 'M', 'L'};
+const uint32 cacheVersion = 1;
+
+// binary documents are a header, the root's name and attributes, then the sections, each a name,
+// flags, the encoded size, the stored size and the data
+const char binaryMagic[4] = {'G', 'B', 'X', 'M'};
+const uint32 binaryVersion = 1;
+
+enum SectionFlags { SECTION_COMPRESSED = 1 };
+
+bool readMagic(FileOps *fops, char *out_magic) {
+	return fops->fileSize() >= 4 && fops->read(out_magic, 4, 1) == 1;
+}
+
+string cacheFileName(uint64 hash) {
+	std::ostringstream ss;
+	ss << std::hex;
+	ss.width(16);
+	ss.fill('0');
+	ss << hash << ".xmlc";
+	return ss.str();
+}
+
+class CacheWriter {
+private:
+	string m_data;
+
+public:
+	const string &getData() const { return m_data; }
+
+	void writeUint32(uint32 v) {
+		for (int i=0; i < 4; ++i) {
+			m_data.push_back(char(v >> (i * 8)));
+		}
+	}
+
+	void writeUint64(uint64 v) {
+		writeUint32(uint32(v));
+		writeUint32(uint32(v >> 32));
+	}
+
+	void writeString(const string &s) {
+		writeUint32(s.size());
+		m_data.append(s);
+	}
+
+	void writeNode(const XmlNode *node) {
+		writeString(node->getName());
+		writeString(node->getText());
+		writeUint32(node->getAttributeCount());
+		for (int i=0; i < node->getAttributeCount(); ++i) {
+			writeString(node->getAttribute(i)->getName());
+			writeString(node->getAttribute(i)->getValue());
+		}
+		writeUint32(node->getChildCount());
+		for (int i=0; i < node->getChildCount(); ++i) {
+			writeNode(node->getChild(i));
+		}
+	}
+};
+
+class CacheReader {
+private:
+	const char *m_pos;
+	const char *m_end;
+
+public:
+	CacheReader(const char *data, int size) : m_pos(data), m_end(data + size) {}
+
+	bool atEnd() const { return m_pos == m_end; }
+
+	bool readBytes(char *out, uint32 n) {
+		if (uint32(m_end - m_pos) < n) {
+			return false;
+		}
+		memcpy(out, m_pos, n);
+		m_pos += n;
+		return true;
+	}
+
+	bool readUint32(uint32 &out) {
+		if (m_end - m_pos < 4) {
+			return false;
+		}
+		out = 0;
+		for (int i=0; i < 4; ++i) {
+			out |= uint32(uint8(m_pos[i])) << (i * 8);
+		}
+		m_pos += 4;
+		return true;
+	}
+
+	bool readUint64(uint64 &out) {
+		uint32 lo, hi;
+		if (!readUint32(lo) || !readUint32(hi)) {
+			return false;
+		}
+		out = uint64(lo) | (uint64(hi) << 32);
+		return true;
+	}
+
+	bool readString(string &out) {
+		uint32 n;
+		if (!readUint32(n) || uint32(m_end - m_pos) < n) {
+			return false;
+		}
+		out.assign(m_pos, n);
+		m_pos += n;
+		return true;
+	}
+
+	/** read everything after the name of a node @return false if the data is truncated */
+	bool readNode(XmlNode *node) {
+		string text;
+		uint32 count;
+		if (!readString(text) || !readUint32(count)) {
+			return false;
+		}
+		node->setText(text);
+		for (uint32 i=0; i < count; ++i) {
+			string attribName, attribValue;
+			if (!readString(attribName) || !readString(attribValue)) {
+				return false;
+			}
+			node->addAttribute(attribName, attribValue);
+		}
+		if (!readUint32(count)) {
+			return false;
+		}
+		for (uint32 i=0; i < count; ++i) {
+			string childName;
+			if (!readString(childName) || !readNode(node->addChild(childName))) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+} // end anonymous namespace
 
 XmlIo &XmlIo::getInstance(){
 	static XmlIo XmlIo;
 	return XmlIo;
 }
 
-XmlNode *XmlIo::load(const string &path){
+XmlNode *XmlIo::loadCached(uint64 hash, int size) {
+	const string cachePath = cacheDir + cacheFileName(hash);
+	if (!FSFactory::fileExists(cachePath)) {
+		return NULL;
+	}
+	FileOps *fops = FSFactory::getInstance()->getFileOps();
+	vector<char> data;
+	try {
+		fops->openRead(cachePath.c_str());
+		data.resize(fops->fileSize());
+		if (!data.empty() && fops->read(&data[0], data.size(), 1) != 1) {
+			data.clear();
+		}
+	} catch (runtime_error &) {
+		data.clear();
+	}
+	delete fops;
+
+	if (data.empty()) {
+		return NULL;
+	}
+	CacheReader reader(&data[0], data.size());
+	char magic[4];
+	uint32 version, fileSize;
+	uint64 fileHash;
+	if (!reader.readBytes(magic, 4) || memcmp(magic, cacheMagic, 4) != 0
+	|| !reader.readUint32(version) || version != cacheVersion
+	|| !reader.readUint64(fileHash) || fileHash != hash
+	|| !reader.readUint32(fileSize) || int(fileSize) != size) {
+		return NULL;
+	}
+	string name;
+	if (!reader.readString(name)) {
+		return NULL;
+	}
+	XmlNode *rootNode = new XmlNode(name);
+	if (!reader.readNode(rootNode) || !reader.atEnd()) {
+		delete rootNode;
+		return NULL;
+	}
+	return rootNode;
+}
+
+void XmlIo::saveCached(uint64 hash, int size, const XmlNode *node) {
+	CacheWriter writer;
+	writer.writeUint32(0);	// place holder for the magic
+	writer.writeUint32(cacheVersion);
+	writer.writeUint64(hash);
+	writer.writeUint32(size);
+	writer.writeNode(node);
+
+	string data = writer.getData();
+	memcpy(&data[0], cacheMagic, 4);
+
+	const string cachePath = cacheDir + cacheFileName(hash);
+	FileOps *fops = FSFactory::getInstance()->getFileOps();
+	try {
+		fops->openWrite(cachePath.c_str());
+		fops->write(data.data(), data.size(), 1);
+	} catch (runtime_error &) {
+		// the cache is only an optimisation, failing to write it is not an error
+	}
+	delete fops;
+}
+
+XmlNode *XmlIo::load(const string &path, bool useCache){
 	// creates a document from file
+	if (useCache && !cacheDir.empty()) {
+		FileOps *fops = FSFactory::getInstance()->getFileOps();
+		fops->openRead(path.c_str());
+		vector<char> data(fops->fileSize());
+		if (!data.empty() && fops->read(&data[0], data.size(), 1) != 1) {
+			data.clear();
+		}
+		const int size = data.size();
+		const uint64 hash = data.empty() ? 0 : hashBytes(&data[0], size);
+
+		XmlNode *rootNode = loadCached(hash, size);
+		if (!rootNode) {
+			TiXmlDocument document;
+			document.LoadFile(fops);
+			rootNode = new XmlNode(document.RootElement());
+			if (!document.Error()) {
+				saveCached(hash, size, rootNode);
+			}
+		}
+		delete fops;
+		return rootNode;
+	}
 
 	//TiXmlDocument document( path.c_str() );
 	//TiXmlDocument *document = new TiXmlDocument();
@@ -52,6 +291,12 @@ XmlNode *XmlIo::load(const string &path){
 	TiXmlDocument document;
 	FileOps *fops = FSFactory::getInstance()->getFileOps();
 	fops->openRead(path.c_str());
+	char magic[4];
+	if (readMagic(fops, magic) && memcmp(magic, binaryMagic, 4) == 0) {
+		delete fops;
+		return loadBinary(path);
+	}
+	fops->seek(0, SEEK_SET);
 	document.LoadFile(fops);
 
 // 	if ( !document.LoadFile() )	{
@@ -109,6 +354,100 @@ void XmlIo::save(const string &path, const XmlNode *node){
 	}
 }
 
+void XmlIo::saveBinary(const string &path, const XmlNode *node, bool compress) {
+	BinaryWriter out;
+	out.writeBytes(binaryMagic, 4);
+	out.writeUnsigned(binaryVersion);
+	out.writeString(node->getName());
+	out.writeUnsigned(node->getAttributeCount());
+	for (int i=0; i < node->getAttributeCount(); ++i) {
+		out.writeString(node->getAttribute(i)->getName());
+		out.writeString(node->getAttribute(i)->getValue());
+	}
+	out.writeUnsigned(node->getChildCount());
+
+	BinaryWriter section;
+	vector<uint8> packed;
+	for (int i=0; i < node->getChildCount(); ++i) {
+		const XmlNode *child = node->getChild(i);
+		section.clear();
+		XmlBinaryWriter(section).writeNode(child);
+		const vector<uint8> &data = section.getData();
+
+		out.writeString(child->getName());
+		out.writeUnsigned(compress ? SECTION_COMPRESSED : 0);
+		out.writeUnsigned(data.size());
+		if (compress) {
+			uLongf size = compressBound(data.size());
+			packed.resize(size);
+			if (compress2(&packed[0], &size, &data[0], data.size(), Z_BEST_SPEED) != Z_OK) {
+				throw runtime_error("Error compressing " + path);
+			}
+			out.writeUnsigned(size);
+			out.writeBytes(&packed[0], size);
+		} else {
+			out.writeUnsigned(data.size());
+			out.writeBytes(&data[0], data.size());
+		}
+	}
+	out.save(path);
+}
+
+XmlNode *XmlIo::loadBinary(const string &path, const string &section) {
+	BinaryReader in;
+	in.load(path);
+	const uint8 *magic = in.skip(4);
+	if (memcmp(magic, binaryMagic, 4) != 0) {
+		throw runtime_error(path + " is not a binary xml document");
+	}
+	if (in.readUnsigned() != binaryVersion) {
+		throw runtime_error(path + " is from an unsupported version");
+	}
+	auto_ptr<XmlNode> root(new XmlNode(in.readString()));
+	int count = in.readUnsigned();
+	for (int i=0; i < count; ++i) {
+		string name = in.readString();
+		root->addAttribute(name, in.readString());
+	}
+
+	count = in.readUnsigned();
+	vector<uint8> unpacked;
+	for (int i=0; i < count; ++i) {
+		string name = in.readString();
+		uint32 flags = in.readUnsigned();
+		uLongf rawSize = in.readUnsigned();
+		uint32 storedSize = in.readUnsigned();
+		const uint8 *stored = in.skip(storedSize);
+		if (!section.empty() && name != section) {
+			continue;
+		}
+		const uint8 *data = stored;
+		if (flags & SECTION_COMPRESSED) {
+			unpacked.resize(rawSize + 1);	// never empty, so &[0] is valid
+			if (uncompress(&unpacked[0], &rawSize, stored, storedSize) != Z_OK) {
+				throw runtime_error(path + ": corrupt section " + name);
+			}
+			data = &unpacked[0];
+		}
+		BinaryReader sectionIn(data, rawSize);
+		XmlBinaryReader(sectionIn).readNode(root.get());
+	}
+	return root.release();
+}
+
+bool XmlIo::isBinary(const string &path) {
+	FileOps *fops = FSFactory::getInstance()->getFileOps();
+	char magic[4];
+	bool result = false;
+	try {
+		fops->openRead(path.c_str());
+		result = readMagic(fops, magic) && memcmp(magic, binaryMagic, 4) == 0;
+	} catch (runtime_error &) {
+	}
+	delete fops;
+	return result;
+}
+
 // =====================================================
 //	class XmlNode
 // =====================================================
@@ -0,0 +1,181 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "log_ring_test.h"
+
+#include <vector>
+
+#include "thread.h"
+#include "platform_util.h"
+#include "conversion.h"
+
+#include "leak_dumper.h"
+
+using Shared::Util::LogRing;
+using Shared::Util::intToStr;
+using Shared::Platform::Thread;
+using std::vector;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *LogRingTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("LogRingTest");
+	ADD_TEST(LogRingTest, testPushPop);
+	ADD_TEST(LogRingTest, testLongMessages);
+	ADD_TEST(LogRingTest, testFull);
+	ADD_TEST(LogRingTest, testProducers);
+
+	return suiteOfTests;
+}
+
+namespace {
+
+void push(LogRing &ring, const string &msg, int64 time = 0) {
+	CPPUNIT_ASSERT(ring.push(msg.data(), msg.size(), time));
+}
+
+string pop(LogRing &ring) {
+	string text;
+	int64 time;
+	CPPUNIT_ASSERT(ring.pop(text, time));
+	return text;
+}
+
+}
+
+void LogRingTest::testPushPop() {
+	LogRing ring(64);
+	string text;
+	int64 time;
+	CPPUNIT_ASSERT(!ring.pop(text, time));
+
+	// several laps round the ring
+	for (int i=0; i < 500; ++i) {
+		push(ring, "message " + intToStr(i), i);
+		push(ring, "");
+		CPPUNIT_ASSERT(ring.pop(text, time));
+		CPPUNIT_ASSERT_EQUAL("message " + intToStr(i), text);
+		CPPUNIT_ASSERT_EQUAL(int64(i), time);
+		CPPUNIT_ASSERT_EQUAL(string(), pop(ring));
+	}
+	CPPUNIT_ASSERT(!ring.pop(text, time));
+}
+
+void LogRingTest::testLongMessages() {
+	LogRing ring(256);
+	string exact(LogRing::payloadSize * 3, 'x');
+	string spanning(LogRing::payloadSize * 2 + 1, 'y');
+	string tooLong(LogRing::payloadSize * (LogRing::maxMessageSlots + 2), 'z');
+	for (int i=0; i < 20; ++i) {
+		push(ring, exact);
+		push(ring, spanning);
+		push(ring, tooLong);
+		CPPUNIT_ASSERT_EQUAL(exact, pop(ring));
+		CPPUNIT_ASSERT_EQUAL(spanning, pop(ring));
+		CPPUNIT_ASSERT_EQUAL(tooLong.substr(0, LogRing::payloadSize * LogRing::maxMessageSlots),
+			pop(ring));
+	}
+}
+
+void LogRingTest::testFull() {
+	LogRing ring(64);
+	CPPUNIT_ASSERT_EQUAL(64, ring.getCapacity());
+	for (int i=0; i < 64; ++i) {
+		push(ring, intToStr(i));
+	}
+	CPPUNIT_ASSERT(!ring.push("a", 1, 0));
+	CPPUNIT_ASSERT(!ring.push("b", 1, 0));
+	CPPUNIT_ASSERT_EQUAL(2, ring.takeDropped());
+	CPPUNIT_ASSERT_EQUAL(0, ring.takeDropped());
+
+	// room for one short message, not a long one
+	CPPUNIT_ASSERT_EQUAL(string("0"), pop(ring));
+	string spanning(LogRing::payloadSize + 1, 'y');
+	CPPUNIT_ASSERT(!ring.push(spanning.data(), spanning.size(), 0));
+	push(ring, "64");
+	for (int i=1; i <= 64; ++i) {
+		CPPUNIT_ASSERT_EQUAL(intToStr(i), pop(ring));
+	}
+	CPPUNIT_ASSERT_EQUAL(1, ring.takeDropped());
+}
+
+namespace {
+
+class Producer : public Thread {
+public:
+	LogRing *ring;
+	int index, count, dropped;
+
+	virtual void execute() {
+		dropped = 0;
+		for (int i=0; i < count; ++i) {
+			// vary the length so messages take one to three slots
+			string msg = intToStr(index) + " " + intToStr(i) + " ";
+			msg.resize(msg.size() + (i % 3) * LogRing::payloadSize, '.');
+			if (!ring->push(msg.data(), msg.size(), i)) {
+				--i;
+				++dropped;
+				Shared::Platform::sleep(0);
+			}
+		}
+	}
+};
+
+}
+
+/** producers retry dropped messages, each producer's messages must arrive whole and in order */
+void LogRingTest::testProducers() {
+	const int producerCount = 4, messageCount = 20000;
+	LogRing ring(256);
+	Producer producers[producerCount];
+	for (int i=0; i < producerCount; ++i) {
+		producers[i].ring = &ring;
+		producers[i].index = i;
+		producers[i].count = messageCount;
+		producers[i].start();
+	}
+
+	vector<int> next(producerCount, 0);
+	int received = 0, dropped = 0;
+	string text;
+	int64 time;
+	while (received < producerCount * messageCount) {
+		if (!ring.pop(text, time)) {
+			dropped += ring.takeDropped();
+			Shared::Platform::sleep(0);
+			continue;
+		}
+		int producer, i;
+		CPPUNIT_ASSERT_EQUAL(2, sscanf(text.c_str(), "%d %d", &producer, &i));
+		CPPUNIT_ASSERT(producer >= 0 && producer < producerCount);
+		CPPUNIT_ASSERT_EQUAL(next[producer], i);
+		CPPUNIT_ASSERT_EQUAL(int64(i), time);
+		CPPUNIT_ASSERT_EQUAL(intToStr(producer).size() + intToStr(i).size() + 2
+			+ (i % 3) * LogRing::payloadSize, text.size());
+		++next[producer];
+		++received;
+	}
+	int retried = 0;
+	for (int i=0; i < producerCount; ++i) {
+		producers[i].join();
+		retried += producers[i].dropped;
+	}
+	dropped += ring.takeDropped();
+	CPPUNIT_ASSERT_EQUAL(retried, dropped);
+	CPPUNIT_ASSERT(!ring.pop(text, time));
+}
+
+}
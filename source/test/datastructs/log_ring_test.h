@@ -0,0 +1,44 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _TEST_LOG_RING_H_
+#define _TEST_LOG_RING_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "log_ring.h"
+
+namespace Test {
+
+// =====================================================
+//	class LogRingTest
+// =====================================================
+
+class LogRingTest : public CppUnit::TestFixture {
+public:
+	LogRingTest()	{}
+	~LogRingTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testPushPop();
+	void testLongMessages();
+	void testFull();
+	void testProducers();
+};
+
+}
+
+#endif // _TEST_LOG_RING_H_
@@ -0,0 +1,88 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "checksum_test.h"
+
+#include <algorithm>
+
+#include "leak_dumper.h"
+
+using Shared::Util::Checksum;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *ChecksumTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("ChecksumTest");
+	ADD_TEST(ChecksumTest, testKnownValues);
+	ADD_TEST(ChecksumTest, testSplitAdds);
+	ADD_TEST(ChecksumTest, testCombine);
+
+	return suiteOfTests;
+}
+
+/** xxHash64 with the checksum's seed, so the sums must match any xxHash64 implementation */
+void ChecksumTest::testKnownValues() {
+	Checksum empty;
+	CPPUNIT_ASSERT_EQUAL(0x878b2bf7c61c3ae4ULL, (unsigned long long)empty.getSum64());
+
+	Checksum fox;
+	fox.add(string("The quick brown fox jumps over the lazy dog"));
+	CPPUNIT_ASSERT_EQUAL(0x4ea8ce00359dc4c7ULL, (unsigned long long)fox.getSum64());
+
+	uint64 h = fox.getSum64();
+	CPPUNIT_ASSERT_EQUAL(int32(h ^ (h >> 32)), fox.getSum());
+}
+
+/** the sum depends only on the bytes added, however they are split into calls */
+void ChecksumTest::testSplitAdds() {
+	uint8 data[200];
+	for (int i=0; i < 200; ++i) {
+		data[i] = uint8(i * 37 + 11);
+	}
+	const int sizes[] = { 1, 7, 31, 32, 33, 100, 200 };
+	for (int i=0; i < 7; ++i) {
+		Checksum whole;
+		whole.addBytes(data, sizes[i]);
+		Checksum bytes;
+		for (int j=0; j < sizes[i]; ++j) {
+			bytes.add(data[j]);
+		}
+		Checksum pieces;
+		for (int j=0; j < sizes[i]; j += 5) {
+			pieces.addBytes(data + j, std::min(5, sizes[i] - j));
+		}
+		CPPUNIT_ASSERT_EQUAL(whole.getSum64(), bytes.getSum64());
+		CPPUNIT_ASSERT_EQUAL(whole.getSum64(), pieces.getSum64());
+	}
+
+	// and changes if any byte does
+	Checksum before;
+	before.addBytes(data, 200);
+	data[150] ^= 1;
+	Checksum after;
+	after.addBytes(data, 200);
+	CPPUNIT_ASSERT(before.getSum64() != after.getSum64());
+}
+
+void ChecksumTest::testCombine() {
+	uint64 ab = Checksum::combine(Checksum::combine(0, 1), 2);
+	uint64 ba = Checksum::combine(Checksum::combine(0, 2), 1);
+	CPPUNIT_ASSERT(ab != ba);
+	CPPUNIT_ASSERT(Checksum::combine(0, 1) != Checksum::combine(0, 2));
+	CPPUNIT_ASSERT_EQUAL(ab, Checksum::combine(Checksum::combine(0, 1), 2));
+}
+
+}
@@ -0,0 +1,120 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "xml_binary_test.h"
+
+#include <stdexcept>
+
+#include "xml_parser.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Xml;
+using Shared::Util::BinaryWriter;
+using Shared::Util::BinaryReader;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *XmlBinaryTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("XmlBinaryTest");
+	ADD_TEST(XmlBinaryTest, testRoundTrip);
+	ADD_TEST(XmlBinaryTest, testValues);
+	ADD_TEST(XmlBinaryTest, testTruncated);
+
+	return suiteOfTests;
+}
+
+namespace {
+
+void checkEqual(const XmlNode *expected, const XmlNode *actual) {
+	CPPUNIT_ASSERT_EQUAL(expected->getName(), actual->getName());
+	CPPUNIT_ASSERT_EQUAL(expected->getText(), actual->getText());
+	CPPUNIT_ASSERT_EQUAL(expected->getAttributeCount(), actual->getAttributeCount());
+	for (int i=0; i < expected->getAttributeCount(); ++i) {
+		CPPUNIT_ASSERT_EQUAL(expected->getAttribute(i)->getName(), actual->getAttribute(i)->getName());
+		CPPUNIT_ASSERT_EQUAL(expected->getAttribute(i)->getValue(), actual->getAttribute(i)->getValue());
+	}
+	CPPUNIT_ASSERT_EQUAL(expected->getChildCount(), actual->getChildCount());
+	for (int i=0; i < expected->getChildCount(); ++i) {
+		checkEqual(expected->getChild(i), actual->getChild(i));
+	}
+}
+
+} // end anonymous namespace
+
+void XmlBinaryTest::testRoundTrip() {
+	XmlNode root("world");
+	root.addChild("frameCount", 1234);
+	XmlNode *units = root.addChild("units");
+	for (int i=0; i < 50; ++i) {
+		XmlNode *unit = units->addChild("unit");
+		unit->addChild("id", i);
+		unit->addChild("type", i % 2 ? "worker" : "swordman");
+		unit->addChild("pos", Vec2i(i, -i));
+		unit->addChild("hp", 12.5f);
+		unit->addChild("toBeUndertaken", i % 3 == 0);
+	}
+	root.addChild("script")->setText("function foo() return 1 end");
+
+	BinaryWriter out;
+	XmlBinaryWriter(out).writeNode(&root);
+	XmlNode parent("parent");
+	BinaryReader in(&out.getData()[0], out.getSize());
+	XmlBinaryReader(in).readNode(&parent);
+	CPPUNIT_ASSERT(in.atEnd());
+	checkEqual(&root, parent.getChild(0));
+
+	// repeated names and values are written once
+	auto_ptr<string> text = root.toString();
+	CPPUNIT_ASSERT(out.getSize() * 2 < text->size());
+}
+
+void XmlBinaryTest::testValues() {
+	// values that look like integers but would not survive the conversion are kept as strings
+	const char *values[] = {
+		"0", "-1", "2147483647", "-2147483648", "2147483648", "007", "-0", "+5", "1e3", "0x10",
+		"", "-", " 12", "a rather long value, longer than the string table will take"
+	};
+	XmlNode root("values");
+	for (int i=0; i < int(sizeof(values) / sizeof(values[0])); ++i) {
+		root.addChild("value")->addAttribute("value", values[i]);
+	}
+	XmlNode parent("parent");
+	BinaryWriter out;
+	XmlBinaryWriter(out).writeNode(&root);
+	BinaryReader in(&out.getData()[0], out.getSize());
+	XmlBinaryReader(in).readNode(&parent);
+	checkEqual(&root, parent.getChild(0));
+}
+
+void XmlBinaryTest::testTruncated() {
+	XmlNode root("root");
+	root.addChild("child", "some value");
+	BinaryWriter out;
+	XmlBinaryWriter(out).writeNode(&root);
+
+	for (size_t size = 0; size < out.getSize(); ++size) {
+		XmlNode parent("parent");
+		BinaryReader in(&out.getData()[0], size);
+		try {
+			XmlBinaryReader(in).readNode(&parent);
+			CPPUNIT_FAIL("truncated data was read");
+		} catch (std::runtime_error &) {
+		}
+	}
+}
+
+}
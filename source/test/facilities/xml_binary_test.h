@@ -0,0 +1,43 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _TEST_XML_BINARY_H_
+#define _TEST_XML_BINARY_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "xml_binary.h"
+
+namespace Test {
+
+// =====================================================
+//	class XmlBinaryTest
+// =====================================================
+
+class XmlBinaryTest : public CppUnit::TestFixture {
+public:
+	XmlBinaryTest()		{}
+	~XmlBinaryTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testRoundTrip();
+	void testValues();
+	void testTruncated();
+};
+
+}
+
+#endif // _TEST_XML_BINARY_H_
@@ -0,0 +1,155 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "compressed_texture_test.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "pixmap.h"
+
+#include "leak_dumper.h"
+
+using namespace Shared::Graphics;
+using Shared::Platform::uint8;
+using std::vector;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *CompressedTextureTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("CompressedTextureTest");
+	ADD_TEST(CompressedTextureTest, testHalveImage);
+	ADD_TEST(CompressedTextureTest, testSolidBlock);
+	ADD_TEST(CompressedTextureTest, testGradientBlock);
+	ADD_TEST(CompressedTextureTest, testAlphaBlock);
+	ADD_TEST(CompressedTextureTest, testMipmapChain);
+
+	return suiteOfTests;
+}
+
+/** @return the largest difference between the first n components of 16 RGBA pixels */
+int maxError(const uint8 *a, const uint8 *b, int n) {
+	int result = 0;
+	for (int i=0; i < 16; ++i) {
+		for (int c=0; c < n; ++c) {
+			result = std::max(result, abs(a[i * 4 + c] - b[i * 4 + c]));
+		}
+	}
+	return result;
+}
+
+void CompressedTextureTest::testHalveImage() {
+	// compare with a plain box filter, wide enough that RGBA images take the SIMD path
+	srand(1);
+	for (int components=3; components <= 4; ++components) {
+		for (int w=1; w <= 32; w *= 2) {
+			for (int h=1; h <= 32; h *= 2) {
+				vector<uint8> src(w * h * components);
+				for (int i=0; i < src.size(); ++i) {
+					src[i] = uint8(rand());
+				}
+				const int dw = std::max(1, w / 2), dh = std::max(1, h / 2);
+				vector<uint8> dst(dw * dh * components);
+				halveImage(&src[0], w, h, components, &dst[0]);
+
+				for (int y=0; y < dh; ++y) {
+					const int y0 = h > 1 ? 2 * y : 0, y1 = h > 1 ? 2 * y + 1 : 0;
+					for (int x=0; x < dw; ++x) {
+						const int x0 = w > 1 ? 2 * x : 0, x1 = w > 1 ? 2 * x + 1 : 0;
+						for (int c=0; c < components; ++c) {
+							int sum = src[(y0 * w + x0) * components + c] + src[(y0 * w + x1) * components + c]
+								+ src[(y1 * w + x0) * components + c] + src[(y1 * w + x1) * components + c];
+							CPPUNIT_ASSERT_EQUAL((sum + 2) / 4, int(dst[(y * dw + x) * components + c]));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void CompressedTextureTest::testSolidBlock() {
+	// colours exactly representable as 5:6:5 survive unchanged
+	uint8 block[64], encoded[16], decoded[64];
+	for (int i=0; i < 16; ++i) {
+		block[i * 4 + 0] = 255;
+		block[i * 4 + 1] = 0;
+		block[i * 4 + 2] = 255;
+		block[i * 4 + 3] = 200;
+	}
+	compressDxtBlock(block, false, encoded);
+	decompressDxtBlock(encoded, false, decoded);
+	CPPUNIT_ASSERT_EQUAL(0, maxError(block, decoded, 3));
+	CPPUNIT_ASSERT_EQUAL(255, int(decoded[3]));
+
+	compressDxtBlock(block, true, encoded);
+	decompressDxtBlock(encoded, true, decoded);
+	CPPUNIT_ASSERT_EQUAL(0, maxError(block, decoded, 4));
+}
+
+void CompressedTextureTest::testGradientBlock() {
+	// red rising as green falls, the end points must follow the anti-diagonal
+	uint8 block[64], encoded[8], decoded[64];
+	for (int i=0; i < 16; ++i) {
+		block[i * 4 + 0] = uint8(i * 16);
+		block[i * 4 + 1] = uint8(255 - i * 16);
+		block[i * 4 + 2] = 128;
+		block[i * 4 + 3] = 255;
+	}
+	compressDxtBlock(block, false, encoded);
+	decompressDxtBlock(encoded, false, decoded);
+	// four colours spread over 240, at most about half a step (40) off
+	CPPUNIT_ASSERT(maxError(block, decoded, 3) <= 40);
+}
+
+void CompressedTextureTest::testAlphaBlock() {
+	uint8 block[64], encoded[16], decoded[64];
+	for (int i=0; i < 16; ++i) {
+		block[i * 4 + 0] = block[i * 4 + 1] = block[i * 4 + 2] = 64;
+		block[i * 4 + 3] = uint8(i * 17);
+	}
+	compressDxtBlock(block, true, encoded);
+	decompressDxtBlock(encoded, true, decoded);
+	// eight alpha values over 255, at most half a step off, the extremes exact
+	for (int i=0; i < 16; ++i) {
+		CPPUNIT_ASSERT(abs(block[i * 4 + 3] - decoded[i * 4 + 3]) <= 19);
+	}
+	CPPUNIT_ASSERT_EQUAL(0, int(decoded[3]));
+	CPPUNIT_ASSERT_EQUAL(255, int(decoded[15 * 4 + 3]));
+}
+
+void CompressedTextureTest::testMipmapChain() {
+	Pixmap2D pixmap(8, 4, 4);
+	memset(pixmap.getPixels(), 128, 8 * 4 * 4);
+	CPPUNIT_ASSERT(CompressedTexture::canCompress(&pixmap));
+
+	CompressedTexture tex;
+	tex.compress(&pixmap);
+	CPPUNIT_ASSERT(tex.isDxt5());
+	CPPUNIT_ASSERT_EQUAL(4, tex.getLevelCount());
+	const int sizes[4][2] = { {8, 4}, {4, 2}, {2, 1}, {1, 1} };
+	for (int i=0; i < 4; ++i) {
+		CPPUNIT_ASSERT_EQUAL(sizes[i][0], tex.getLevel(i).w);
+		CPPUNIT_ASSERT_EQUAL(sizes[i][1], tex.getLevel(i).h);
+	}
+	// 2 blocks for the first level, then one block each
+	CPPUNIT_ASSERT_EQUAL(16 * 5, tex.getMemoryUsage());
+
+	Pixmap2D odd(6, 4, 3);
+	CPPUNIT_ASSERT(!CompressedTexture::canCompress(&odd));
+}
+
+}
@@ -0,0 +1,45 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _TEST_COMPRESSED_TEXTURE_H_
+#define _TEST_COMPRESSED_TEXTURE_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "compressed_texture.h"
+
+namespace Test {
+
+// =====================================================
+//	class CompressedTextureTest
+// =====================================================
+
+class CompressedTextureTest : public CppUnit::TestFixture {
+public:
+	CompressedTextureTest()		{}
+	~CompressedTextureTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testHalveImage();
+	void testSolidBlock();
+	void testGradientBlock();
+	void testAlphaBlock();
+	void testMipmapChain();
+};
+
+}
+
+#endif // _TEST_COMPRESSED_TEXTURE_H_
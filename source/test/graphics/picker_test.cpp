@@ -0,0 +1,126 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "picker_test.h"
+
+#include "leak_dumper.h"
+
+using Shared::Graphics::Picker;
+using Shared::Platform::uint32;
+using namespace Shared::Math;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *PickerTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("PickerTest");
+	ADD_TEST(PickerTest, testClick);
+	ADD_TEST(PickerTest, testDepthOrder);
+	ADD_TEST(PickerTest, testRotation);
+	ADD_TEST(PickerTest, testRect);
+	ADD_TEST(PickerTest, testAngledCamera);
+
+	return suiteOfTests;
+}
+
+// 200x200 screen, 90 degree fov, camera 20 above the origin looking straight down. World x is
+// screen x, world z is screen y (both with the origin at the centre), 1 world unit at y=0 is 5
+// pixels.
+Picker topDownPicker() {
+	return Picker(Vec3f(0.f, 20.f, 0.f), 0.f, -90.f, 90.f, 1.f, 1.f, 100.f, 200, 200);
+}
+
+const Vec3f unitMin(-1.f, 0.f, -1.f);
+const Vec3f unitMax(1.f, 2.f, 1.f);
+
+void PickerTest::testClick() {
+	Picker picker = topDownPicker();
+	uint32 depth;
+
+	picker.setRect(Vec2i(100, 100), Vec2i(100, 100));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f), 0.f, unitMin, unitMax, depth));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(3.f, 0.f, 0.f), 0.f, unitMin, unitMax, depth));
+
+	// (10, 0, 5) is at (150, 125) on screen
+	picker.setRect(Vec2i(150, 125), Vec2i(150, 125));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(10.f, 0.f, 5.f), 0.f, unitMin, unitMax, depth));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(10.f, 0.f, -5.f), 0.f, unitMin, unitMax, depth));
+
+	// empty bounds (all meshes 'no select') are never hit
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(10.f, 0.f, 5.f), 0.f, Vec3f(1.f), Vec3f(-1.f), depth));
+}
+
+void PickerTest::testDepthOrder() {
+	Picker picker = topDownPicker();
+	uint32 lowDepth, highDepth;
+
+	picker.setRect(Vec2i(100, 100), Vec2i(100, 100));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f), 0.f, unitMin, unitMax, lowDepth));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f, 5.f, 0.f), 0.f, unitMin, unitMax, highDepth));
+	CPPUNIT_ASSERT(highDepth < lowDepth);
+
+	// window depth of the top of the box, 18 in front of the camera
+	double n = 1.0, f = 100.0;
+	double expected = ((f + n) / (f - n) - 2.0 * f * n / ((f - n) * 18.0) + 1.0) / 2.0;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, lowDepth / 4294967295.0, 1e-5);
+}
+
+void PickerTest::testRotation() {
+	Picker picker = topDownPicker();
+	uint32 depth;
+	const Vec3f longMin(-4.f, 0.f, -0.5f);
+	const Vec3f longMax(4.f, 1.f, 0.5f);
+
+	// (0, 0, 3) is at (100, 115) on screen, only hit when the box is turned along z
+	picker.setRect(Vec2i(100, 115), Vec2i(100, 115));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(0.f), 0.f, longMin, longMax, depth));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f), 90.f, longMin, longMax, depth));
+}
+
+void PickerTest::testRect() {
+	Picker picker = topDownPicker();
+	uint32 depth;
+
+	// screen (110, 110) to (190, 190) is world (2, 2) to (18, 18)
+	picker.setRect(Vec2i(110, 110), Vec2i(190, 190));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(10.f, 0.f, 10.f), 0.f, unitMin, unitMax, depth));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(1.5f, 0.f, 1.5f), 0.f, unitMin, unitMax, depth)); // overlaps
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(-10.f, 0.f, 10.f), 0.f, unitMin, unitMax, depth));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(10.f, 0.f, -10.f), 0.f, unitMin, unitMax, depth));
+
+	// drag direction does not matter
+	picker.setRect(Vec2i(190, 190), Vec2i(110, 110));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(10.f, 0.f, 10.f), 0.f, unitMin, unitMax, depth));
+}
+
+void PickerTest::testAngledCamera() {
+	// a typical game camera, looking north and down at 45 degrees from (0, 10, 10) at the origin
+	Picker picker(Vec3f(0.f, 10.f, 10.f), 0.f, -45.f, 60.f, 4.f / 3.f, 1.f, 200.f, 800, 600);
+	uint32 nearDepth, farDepth;
+
+	picker.setRect(Vec2i(400, 300), Vec2i(400, 300));
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f), 0.f, unitMin, unitMax, nearDepth));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(5.f, 0.f, 0.f), 0.f, unitMin, unitMax, farDepth));
+
+	// behind the camera, or beyond the far plane
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(0.f, 0.f, 30.f), 0.f, unitMin, unitMax, farDepth));
+	CPPUNIT_ASSERT(!picker.pick(Vec3f(0.f, -300.f, -300.f), 0.f, unitMin, unitMax, farDepth));
+
+	// further along the same line of sight
+	CPPUNIT_ASSERT(picker.pick(Vec3f(0.f, -5.f, -5.f), 0.f, unitMin, unitMax, farDepth));
+	CPPUNIT_ASSERT(nearDepth < farDepth);
+}
+
+}
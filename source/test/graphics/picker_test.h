@@ -0,0 +1,45 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _TEST_PICKER_H_
+#define _TEST_PICKER_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "picker.h"
+
+namespace Test {
+
+// =====================================================
+//	class PickerTest
+// =====================================================
+
+class PickerTest : public CppUnit::TestFixture {
+public:
+	PickerTest()	{}
+	~PickerTest()	{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testClick();
+	void testDepthOrder();
+	void testRotation();
+	void testRect();
+	void testAngledCamera();
+};
+
+}
+
+#endif // _TEST_PICKER_H_
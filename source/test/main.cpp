@@ -21,9 +21,15 @@
 //#include "node_pool_test.h"
 #include "influence_map_test.h"
 #include "circular_buffer_test.h"
-//#include "checksum_test.h"
+#include "log_ring_test.h"
+#include "checksum_test.h"
 #include "heap_test.h"
 #include "line_test.h"
+#include "picker_test.h"
+#include "compressed_texture_test.h"
+#include "network_status_test.h"
+#include "update_buffer_test.h"
+#include "xml_binary_test.h"
 
 #include "leak_dumper.h"
 
@@ -36,10 +42,16 @@ int main(int argc, char **argv) {
 	//tester.addTest(NodePoolTest::suite());
 	tester.addTest(InfluenceMapTest::suite());
 	tester.addTest(CircularBufferTest::suite());
+	tester.addTest(LogRingTest::suite());
 	tester.addTest(FixedPointTest::suite());
-//	tester.addTest(ChecksumTest::suite());
+	tester.addTest(ChecksumTest::suite());
 	tester.addTest(MinHeapTest::suite());
 	tester.addTest(LineAlgorithmTest::suite());
+	tester.addTest(PickerTest::suite());
+	tester.addTest(CompressedTextureTest::suite());
+	tester.addTest(NetworkStatusTest::suite());
+	tester.addTest(UpdateBufferTest::suite());
+	tester.addTest(XmlBinaryTest::suite());
 
 	bool res = tester.run();
 
@@ -0,0 +1,192 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "network_status_test.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "leak_dumper.h"
+
+using Glest::Net::NetworkStatus;
+using Shared::Platform::int64;
+using std::vector;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *NetworkStatusTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("NetworkStatusTest");
+	ADD_TEST(NetworkStatusTest, testSteadyLink);
+	ADD_TEST(NetworkStatusTest, testJitteryLink);
+	ADD_TEST(NetworkStatusTest, testDepthLimit);
+	ADD_TEST(NetworkStatusTest, testTargetDecay);
+	ADD_TEST(NetworkStatusTest, testCatchUp);
+
+	return suiteOfTests;
+}
+
+const int64 period = 125000; // 5 frames at 40 fps
+
+// =====================================================
+//	class Loopback
+// =====================================================
+/** A server sending a keyframe every period over an in order link with a random extra delay of
+  * up to jitter (on the first jitterCount keyframes, or all of them if -1), and a client using
+  * them at the same rate, buffering, refilling and catching up as ClientInterface does. Time is
+  * simulated, nothing waits. */
+class Loopback {
+private:
+	NetworkStatus &m_status;
+	vector<int64> m_arrivals;
+	vector<int> m_depths;	/**< keyframes still buffered after each was used */
+	size_t m_received;
+
+	void receive(int64 time) {
+		while (m_received < m_arrivals.size() && m_arrivals[m_received] <= time) {
+			m_status.keyFrameArrived(100, m_arrivals[m_received++]);
+		}
+	}
+
+	/** wait for keyframes up to index last @return the time they are all in */
+	int64 waitFor(size_t last) {
+		last = std::min(last, m_arrivals.size() - 1);
+		receive(m_arrivals[last]);
+		return m_arrivals[last];
+	}
+
+public:
+	Loopback(NetworkStatus &status, int count, int64 delay, int64 jitter, int jitterCount = -1)
+			: m_status(status), m_arrivals(count), m_depths(count), m_received(0) {
+		srand(1);
+		for (int i=0; i < count; ++i) {
+			bool jittered = jitter && (jitterCount == -1 || i < jitterCount);
+			m_arrivals[i] = i * period + delay + (jittered ? rand() % jitter : 0);
+			if (i && m_arrivals[i] < m_arrivals[i - 1]) {
+				m_arrivals[i] = m_arrivals[i - 1];
+			}
+		}
+	}
+
+	/** @return the number of stalls using keyframes from index first on */
+	int run(int first) {
+		int stalls = 0;
+		int64 time = waitFor(m_status.getTargetDepth() - 1);
+		for (size_t i=0; i < m_arrivals.size(); ++i) {
+			receive(time);
+			if (m_received == i) {
+				m_status.stallBegin(time);
+				time = waitFor(i + m_status.getTargetDepth() - 1);
+				m_status.stallEnd(time);
+				if (int(i) >= first) {
+					++stalls;
+				}
+			}
+			CPPUNIT_ASSERT_EQUAL(int(m_received - i), m_status.getDepth());
+			m_status.keyFrameUsed();
+			m_depths[i] = m_status.getDepth();
+			time += m_status.isBehind() ? period * 100 / (100 + NetworkStatus::catchUpRate) : period;
+		}
+		return stalls;
+	}
+
+	int getDepth(int i) const { return m_depths[i]; }
+};
+
+void NetworkStatusTest::testSteadyLink() {
+	NetworkStatus status(period, 2, 8);
+	Loopback link(status, 400, 80000, 0);
+	CPPUNIT_ASSERT_EQUAL(0, link.run(0));
+	CPPUNIT_ASSERT_EQUAL(int64(0), status.getJitter());
+	CPPUNIT_ASSERT_EQUAL(2, status.getNeededDepth());
+	CPPUNIT_ASSERT_EQUAL(2, status.getTargetDepth());
+	CPPUNIT_ASSERT_EQUAL(int64(0), status.getTotalStall());
+	CPPUNIT_ASSERT_EQUAL(100, status.getAverageSize());
+}
+
+void NetworkStatusTest::testJitteryLink() {
+	// up to three periods of jitter, stalls raise the depth until it is covered
+	NetworkStatus status(period, 1, 8);
+	Loopback link(status, 2000, 80000, 3 * period);
+	CPPUNIT_ASSERT_EQUAL(0, link.run(1000));
+	CPPUNIT_ASSERT(status.getStallCount() > 0);
+	CPPUNIT_ASSERT(status.getTotalStall() > 0);
+	CPPUNIT_ASSERT(status.getTargetDepth() > 1);
+	CPPUNIT_ASSERT(status.getJitter() > 0);
+	CPPUNIT_ASSERT(!status.isStalled());
+}
+
+void NetworkStatusTest::testDepthLimit() {
+	NetworkStatus status(period, 2, 4);
+	Loopback link(status, 400, 80000, 20 * period);
+	link.run(0);
+	CPPUNIT_ASSERT_EQUAL(4, status.getNeededDepth());
+	CPPUNIT_ASSERT_EQUAL(4, status.getTargetDepth());
+}
+
+void NetworkStatusTest::testTargetDecay() {
+	NetworkStatus status(period, 1, 8);
+	int64 time = 0;
+	status.keyFrameArrived(100, time);
+	for (int i=0; i < 3; ++i) {
+		status.stallBegin(time);
+		status.stallEnd(time);
+	}
+	CPPUNIT_ASSERT_EQUAL(4, status.getTargetDepth());
+
+	// once the link is steady the target drops by one each decayTime, down to the needed depth
+	const int64 steps = NetworkStatus::decayTime / period;
+	for (int step=0; step < 5; ++step) {
+		for (int64 i=0; i < steps; ++i) {
+			time += period;
+			status.keyFrameArrived(100, time);
+			status.keyFrameUsed();
+		}
+		CPPUNIT_ASSERT_EQUAL(1, status.getNeededDepth());
+		CPPUNIT_ASSERT_EQUAL(std::max(1, 3 - step), status.getTargetDepth());
+	}
+
+	// a stall raises it again, and restarts the wait
+	status.stallBegin(time);
+	status.stallEnd(time);
+	CPPUNIT_ASSERT_EQUAL(2, status.getTargetDepth());
+	for (int64 i=1; i < steps; ++i) {
+		time += period;
+		status.keyFrameArrived(100, time);
+		status.keyFrameUsed();
+	}
+	CPPUNIT_ASSERT_EQUAL(2, status.getTargetDepth());
+	time += period;
+	status.keyFrameArrived(100, time);
+	CPPUNIT_ASSERT_EQUAL(1, status.getTargetDepth());
+}
+
+void NetworkStatusTest::testCatchUp() {
+	// a burst of jitter early on raises the depth, once the link settles the target decays and
+	// the client runs fast until the buffered depth has come down to it
+	NetworkStatus status(period, 1, 8);
+	Loopback link(status, 2400, 80000, 3 * period, 200);
+	link.run(0);
+	int peak = 0;
+	for (int i=0; i < 200; ++i) {
+		peak = std::max(peak, link.getDepth(i));
+	}
+	CPPUNIT_ASSERT(peak > status.getNeededDepth());
+	CPPUNIT_ASSERT_EQUAL(status.getNeededDepth(), status.getTargetDepth());
+	CPPUNIT_ASSERT_EQUAL(status.getTargetDepth(), link.getDepth(2300));
+}
+
+}
@@ -0,0 +1,152 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "pch.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "update_buffer_test.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "util.h"
+
+#include "leak_dumper.h"
+
+using Glest::Net::UpdateBuffer;
+using namespace Shared::Util;
+using Shared::Platform::uint8;
+using Shared::Platform::int32;
+using Shared::Platform::uint32;
+using std::vector;
+
+namespace Test {
+
+#define ADD_TEST(Class, Method) suiteOfTests->addTest( \
+	new CppUnit::TestCaller<Class>(#Method, &Class::Method));
+
+CppUnit::Test *UpdateBufferTest::suite() {
+	CppUnit::TestSuite *suiteOfTests = new CppUnit::TestSuite("UpdateBufferTest");
+	ADD_TEST(UpdateBufferTest, testVarint);
+	ADD_TEST(UpdateBufferTest, testRoundTrip);
+	ADD_TEST(UpdateBufferTest, testRuns);
+	ADD_TEST(UpdateBufferTest, testMismatch);
+
+	return suiteOfTests;
+}
+
+void UpdateBufferTest::testVarint() {
+	const int32 values[] = { 0, 1, -1, 63, -64, 64, 127, 128, 300, -3000, 0x7FFFFFFF, -0x7FFFFFFF - 1 };
+	const int count = sizeof(values) / sizeof(values[0]);
+	vector<uint8> data;
+	for (int i=0; i < count; ++i) {
+		writeVarint(data, zigzag(values[i]));
+	}
+	const uint8 *ptr = &data[0], *end = ptr + data.size();
+	for (int i=0; i < count; ++i) {
+		uint32 v;
+		CPPUNIT_ASSERT(readVarint(ptr, end, v));
+		CPPUNIT_ASSERT_EQUAL(values[i], unzigzag(v));
+	}
+	CPPUNIT_ASSERT(ptr == end);
+	uint32 v;
+	CPPUNIT_ASSERT(!readVarint(ptr, end, v));
+
+	// small magnitudes take one byte
+	data.clear();
+	writeVarint(data, zigzag(-64));
+	writeVarint(data, zigzag(63));
+	CPPUNIT_ASSERT_EQUAL(size_t(2), data.size());
+}
+
+void UpdateBufferTest::testRoundTrip() {
+	// interleaved moves and projectiles, some repeated, read back in order
+	struct Update { bool move; int x, y, end; };
+	vector<Update> updates;
+	srand(1);
+	for (int i=0; i < 2000; ++i) {
+		Update u;
+		u.move = rand() % 4 != 0;
+		u.x = rand() % 3 - 1;
+		u.y = rand() % 3 - 1;
+		u.end = u.move ? rand() % 2048 : rand() % 256;
+		int repeat = rand() % 3 ? 1 : rand() % 20 + 1;
+		for (int j=0; j < repeat; ++j) {
+			updates.push_back(u);
+		}
+	}
+	UpdateBuffer out;
+	for (size_t i=0; i < updates.size(); ++i) {
+		if (updates[i].move) {
+			out.addMove(updates[i].x, updates[i].y, updates[i].end);
+		} else {
+			out.addProjectile(updates[i].end);
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL(int(updates.size()), out.getUpdateCount());
+	vector<uint8> data;
+	out.write(data);
+
+	UpdateBuffer in;
+	in.read(&data[0], data.size());
+	for (size_t i=0; i < updates.size(); ++i) {
+		int x, y, end;
+		if (updates[i].move) {
+			CPPUNIT_ASSERT(in.getMove(x, y, end));
+			CPPUNIT_ASSERT_EQUAL(updates[i].x, x);
+			CPPUNIT_ASSERT_EQUAL(updates[i].y, y);
+		} else {
+			CPPUNIT_ASSERT(in.getProjectile(end));
+		}
+		CPPUNIT_ASSERT_EQUAL(updates[i].end, end);
+	}
+	int end;
+	CPPUNIT_ASSERT(!in.getProjectile(end));
+}
+
+void UpdateBufferTest::testRuns() {
+	// a thousand units on the same skill, moving the same way, are one run
+	UpdateBuffer out;
+	for (int i=0; i < 1000; ++i) {
+		out.addMove(1, -1, 24);
+	}
+	vector<uint8> data;
+	out.write(data);
+	CPPUNIT_ASSERT(data.size() <= 4);
+
+	// alternating kinds with close end frames, two bytes an update after the first
+	out.clear();
+	for (int i=0; i < 1000; ++i) {
+		out.addMove(0, 1, 20 + i % 4);
+		out.addProjectile(10 + i % 3);
+	}
+	data.clear();
+	out.write(data);
+	CPPUNIT_ASSERT(data.size() <= 2 * 2000 + 2);
+}
+
+void UpdateBufferTest::testMismatch() {
+	UpdateBuffer out;
+	out.addMove(-1, 0, 12);
+	vector<uint8> data;
+	out.write(data);
+
+	UpdateBuffer in;
+	in.read(&data[0], data.size());
+	int x, y, end;
+	CPPUNIT_ASSERT(!in.getProjectile(end));
+	CPPUNIT_ASSERT(in.getMove(x, y, end));
+	CPPUNIT_ASSERT_EQUAL(-1, x);
+	CPPUNIT_ASSERT_EQUAL(0, y);
+	CPPUNIT_ASSERT_EQUAL(12, end);
+	CPPUNIT_ASSERT(!in.getMove(x, y, end));
+}
+
+}
@@ -0,0 +1,44 @@
+// ==============================================================
+//	This file is part of the Glest Advanced Engine
+//
+//	Copyright (C) 2011 The GAE Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _TEST_UPDATE_BUFFER_H_
+#define _TEST_UPDATE_BUFFER_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/Test.h>
+#include <cppunit/TestSuite.h>
+
+#include "update_buffer.h"
+
+namespace Test {
+
+// =====================================================
+//	class UpdateBufferTest
+// =====================================================
+
+class UpdateBufferTest : public CppUnit::TestFixture {
+public:
+	UpdateBufferTest()		{}
+	~UpdateBufferTest()		{}
+
+	static CppUnit::Test *suite();
+	void setUp()	{}
+	void tearDown()	{}
+
+	void testVarint();
+	void testRoundTrip();
+	void testRuns();
+	void testMismatch();
+};
+
+}
+
+#endif // _TEST_UPDATE_BUFFER_H_